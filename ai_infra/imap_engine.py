@@ -118,7 +118,7 @@ class EngineIMAP():
         """
         imap.history(clear = clear, size = size, add = add, replace = replace)
 
-    def map_fpga(self, priority_size = 10, cut_size = 6, global_area_iterations = 1, local_area_iterations = 1, type = 0, verbose = False):
+    def map_fpga(self, priority_size = 10, cut_size = 6, global_area_iterations = 1, local_area_iterations = 1, type = 0, schedule = "default", verbose = False):
         """ Technology mapping for FPGA
 
         Args:
@@ -127,9 +127,10 @@ class EngineIMAP():
             global_area_iterations (int, optional): Set the iteration numter for local area-based post-optimization. Range of [1,2]. Defaults to 1.
             local_area_iterations (int, optional): Set the iteration numter for local area-based post-optimization. Range of [1,3]. Defaults to 2.
             type (int, optional): Mapping with/without history AIG, 0 means mapping without history AIG, 1 means mapping with history AIG. Defaults to 0.
+            schedule (str, optional): The mapping rounds, "default", "fast", "fastest" or "mode:sort[:p]" rounds separated by commas, e.g. "delay:delay,flow:area". Defaults to "default".
             verbose (bool, optional): Verbose report. Defaults to False.
         """
-        imap.map_fpga(priority_size = priority_size, cut_size = cut_size, global_area_iterations = global_area_iterations, local_area_iterations = local_area_iterations, type = type, verbose = verbose)   
+        imap.map_fpga(priority_size = priority_size, cut_size = cut_size, global_area_iterations = global_area_iterations, local_area_iterations = local_area_iterations, type = type, schedule = schedule, verbose = verbose)   
 
     def clean_up(self, verbose = False):
         """ Clean up the dangling nodes
@@ -25,8 +25,8 @@ protected:
         }
 
         if (cadd && history_index + 1 <= max_size) {
-            iFPGA::aig_network aig = store<iFPGA::aig_network>().current()._storage;
-            store<iFPGA::aig_network>()[++history_index] = aig;
+            // the snapshot shares the node pages, the later passes only duplicate the pages they modify
+            store<iFPGA::aig_network>()[++history_index] = store<iFPGA::aig_network>().current().snapshot();
         }
 
         if (history_index + 1 > max_size) {
@@ -40,8 +40,7 @@ protected:
         } else if (index_replace > history_index || index_replace < -1) {
             printf("WARN: the replace index is out of range, please refer to the command \"history -h\"\n");
         } else {
-            iFPGA::aig_network aig = store<iFPGA::aig_network>().current()._storage;
-            store<iFPGA::aig_network>()[index_replace] = aig; // replace the AIG file
+            store<iFPGA::aig_network>()[index_replace] = store<iFPGA::aig_network>().current().snapshot(); // replace the AIG file
         }
 
         if (cclear) {
@@ -17,7 +17,7 @@ public:
     explicit lut_opt_command(const environment::ptr& env) : command(env, "performs technology-independent LUT-opt of AIG") 
     {
         add_option("--priority_size, -P", priority_size, "set the number of priority-cut size for cut enumeration [6, 20] [default=10]");
-        add_option("--cut_size, -C", cut_size, "set the input size of cut for cut enumeration [2, 6] [default=4]");
+        add_option("--cut_size, -C", cut_size, "set the input size of cut for cut enumeration [2, 8] [default=6]");
         add_option("--global_area_iterations, -G", iFlowIter, "set the number of iteration for global area cost optimization, [1, 2] [default=1]");
         add_option("--local_area_iterations, -L", iAreaIter, "set the number of iteration for local area cost optimization, [1, 3] [default=2]");
         add_flag("--zero_gain, -z", zero_gain, "toggles of using zero-cost local replacement [default=no]");
@@ -39,7 +39,7 @@ protected:
             return;
         }
 
-        if( cut_size < 2u || cut_size > 6u ) {
+        if( cut_size < 2u || cut_size > 8u ) {
             printf("WARN: the cut size should be in the range [2, 8], please refer to the command \"lut_opt -h\"\n");
             return;
         }
@@ -64,7 +64,9 @@ protected:
         params.uAreaIters = iAreaIter;
         params.bZeroGain = zero_gain;
         params.verbose = verbose;
-        iFPGA_NAMESPACE::klut_mapping<decltype(mapped_aig), true>(mapped_aig, params);
+        iFPGA_NAMESPACE::dispatch_cut_config(cut_size, priority_size, [&](auto config) {
+            iFPGA_NAMESPACE::klut_mapping<decltype(mapped_aig), true, iFPGA_NAMESPACE::general_cut_data, decltype(config)>(mapped_aig, params);
+        });
         const auto kluts = *iFPGA_NAMESPACE::choice_to_klut<iFPGA_NAMESPACE::klut_network>( mapped_aig );
         iFPGA::aig_network res = iFPGA::convert_klut_to_aig( kluts );
 
@@ -22,9 +22,13 @@ public:
     explicit map_fpga_command(const environment::ptr& env) : command(env, "performs FPGA technology mapping of AIG") 
     {
         add_option("--priority_size, -P", priority_size, "set the number of priority-cut size for cut enumeration [6, 20] [default=10]");
-        add_option("--cut_size, -C", cut_size, "set the input size of cut for cut enumeration [2, 6] [default=6]");
+        add_option("--cut_size, -C", cut_size, "set the input size of cut for cut enumeration [2, 8] [default=6]");
         add_option("--global_area_iterations, -G", iFlowIter, "set the number of iteration for global area cost optimization, [1, 2] [default=1]");
         add_option("--local_area_iterations, -L", iAreaIter, "set the number of iteration for local area cost optimization, [1, 3] [default=2]");
+        add_option("--schedule, -S", schedule, "set the mapping rounds, default/fast/fastest or \"mode:sort[:p]\" rounds separated by commas, mode in delay/flow/area, sort in delay/delay2/area, p for preprocessing [default=default]");
+        add_option("--threads, -T", num_threads, "set the number of threads of the delay-oriented mapping rounds, [default=1]");
+        add_flag("--reuse_cuts, -r", reuse_cuts, "toggles of replaying the last merge of a node while the cut sets of its fanins stay [default=no]");
+        add_flag("--lazy_functions, -f", lazy_functions, "toggles of computing the LUT functions on the cones of the selected cuts only, instead of carrying them in all cuts; the same LUTs, whose functions may differ on the input values the network never gives them [default=no]");
         add_option("--type, -t", type, "set the type of mapping, 0/1 means mapping without/with choice from history AIGs, [default=0]");
         add_flag("--verbose, -v", verbose, "toggles of report verbose information");
     }
@@ -43,8 +47,8 @@ protected:
             return;
         }
 
-        if(cut_size < 2u || cut_size > 6u) {
-            printf("WARN: the cut size should be in the range [2, 6], please refer to the command \"map_fpga -h\"\n");
+        if(cut_size < 2u || cut_size > 8u) {
+            printf("WARN: the cut size should be in the range [2, 8], please refer to the command \"map_fpga -h\"\n");
             return;
         }
 
@@ -63,6 +67,17 @@ protected:
             return;
         }
 
+        if( num_threads < 1u ) {
+            printf("WARN: the number of threads should be at least 1, please refer to the command \"map_fpga -h\"\n");
+            return;
+        }
+
+        std::vector<iFPGA::klut_mapping_round> rounds;
+        if( !iFPGA::parse_mapping_schedule(schedule, rounds) ) {
+            printf("WARN: the schedule should be a preset or rounds starting with a delay round, please refer to the command \"map_fpga -h\"\n");
+            return;
+        }
+
         if( store<iFPGA::klut_network>().empty() ) {
             store<iFPGA::klut_network>().extend();
         }
@@ -70,8 +85,11 @@ protected:
         iFPGA::klut_mapping_params param_mapping;
         param_mapping.cut_enumeration_ps.cut_size = cut_size;
         param_mapping.cut_enumeration_ps.cut_limit = priority_size;
+        param_mapping.cut_enumeration_ps.num_threads = num_threads;
         param_mapping.uFlowIters = iFlowIter;
         param_mapping.uAreaIters = iAreaIter;
+        param_mapping.bReuseCuts = reuse_cuts;
+        param_mapping.schedule = rounds;
         param_mapping.verbose = verbose;
         
         if(type == 1 && store<iFPGA::aig_network>().size() < 2) {
@@ -96,7 +114,7 @@ protected:
 
             iFPGA::aig_with_choice awc = cc.compute_choice();
             iFPGA::mapping_view<iFPGA::aig_with_choice, true, false> mapped_aig(awc);
-            iFPGA_NAMESPACE::klut_mapping<decltype(mapped_aig), true>(mapped_aig, param_mapping);
+            map(mapped_aig, param_mapping);
             const auto kluts = *iFPGA_NAMESPACE::choice_to_klut<iFPGA_NAMESPACE::klut_network>( mapped_aig );
 
             store<iFPGA::klut_network>().current() = kluts;
@@ -106,17 +124,36 @@ protected:
             iFPGA::aig_with_choice awc(aig);
             iFPGA::mapping_view<iFPGA::aig_with_choice, true, false> mapped_aig(awc);
 
-            iFPGA_NAMESPACE::klut_mapping<decltype(mapped_aig), true>(mapped_aig, param_mapping);
+            map(mapped_aig, param_mapping);
             const auto kluts = *iFPGA_NAMESPACE::choice_to_klut<iFPGA_NAMESPACE::klut_network>( mapped_aig );
 
             store<iFPGA::klut_network>().current() = kluts;
         }        
     }
+private:
+    /* the cut database is instantiated for the cut size and the priority size */
+    template<typename MappedAig>
+    void map(MappedAig& mapped_aig, iFPGA::klut_mapping_params const& param_mapping)
+    {
+        iFPGA_NAMESPACE::dispatch_cut_config(cut_size, priority_size, [&](auto config) {
+            if(lazy_functions) {
+                iFPGA_NAMESPACE::klut_mapping<MappedAig, false, iFPGA_NAMESPACE::general_cut_data, decltype(config)>(mapped_aig, param_mapping);
+            }
+            else {
+                iFPGA_NAMESPACE::klut_mapping<MappedAig, true, iFPGA_NAMESPACE::general_cut_data, decltype(config)>(mapped_aig, param_mapping);
+            }
+        });
+    }
+
 private:
     uint32_t priority_size = 10u;
     uint32_t cut_size = 6u;
     uint32_t iFlowIter = 1;
     uint32_t iAreaIter = 2;
+    uint32_t num_threads = 1u;
+    std::string schedule = "default";
+    bool reuse_cuts = false;
+    bool lazy_functions = false;
     int type = 0;               // 0 means mapping without choice, 1 means mapping with choice;
     bool verbose = false;
 };
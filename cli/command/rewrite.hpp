@@ -42,7 +42,9 @@ protected:
         params.b_use_zero_gain = zero_gain;
         params.cut_enumeration_ps.cut_size = cut_size;
         params.cut_enumeration_ps.cut_limit = priority_size;
-        aig = iFPGA::rewrite(aig, params);
+        iFPGA_NAMESPACE::dispatch_cut_config(cut_size, priority_size, [&](auto config) {
+            aig = iFPGA::rewrite<iFPGA::aig_network, iFPGA::node_rewriting<iFPGA::aig_network>, decltype(config)>(aig, params);
+        });
 
         store<iFPGA::aig_network>().current() = aig;
     }
@@ -0,0 +1,170 @@
+// ***************************************************************************************
+// Copyright (c) 2023-2025 Peng Cheng Laboratory
+// Copyright (c) 2023-2025 Shanghai Anlogic Infotech Co.,Ltd.
+// Copyright (c) 2023-2025 Peking University
+//
+// iMAP-FPGA is licensed under Mulan PSL v2.
+// You can use this software according to the terms and conditions of the Mulan PSL v2.
+// You may obtain a copy of Mulan PSL v2 at:
+// http://license.coscl.org.cn/MulanPSL2
+//
+// THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+// EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+// MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+//
+// See the Mulan PSL v2 for more details.
+// ***************************************************************************************
+
+/**
+ * microbenchmark of the inner loop of the priority cut computation: the cut sets of the fanins
+ * of every gate are merged pair by pair, the dominated cuts are filtered and the others inserted
+ * usage: bench_cut_merge [aiger file] [repeat]
+ */
+#include "io/reader.hpp"
+#include "database/network/aig_network.hpp"
+#include "cut/cut_enumeration.hpp"
+#include "cut/general_cut_enumeration.hpp"
+#include "utils/tic_toc.hpp"
+
+#include <random>
+#include <cstdlib>
+
+using namespace iFPGA_NAMESPACE;
+
+/* a random network with an and/or/xor mix over a window of recent signals */
+aig_network random_aig(uint32_t num_gates)
+{
+    aig_network aig;
+    std::mt19937 rnd(5);
+    std::vector<aig_network::signal> sigs;
+    for(uint32_t i = 0; i < 64u; ++i)
+    {
+        sigs.push_back(aig.create_pi());
+    }
+    for(uint32_t i = 0; i < num_gates; ++i)
+    {
+        auto pick = [&]() {
+            auto const window = std::min<uint32_t>(sigs.size(), 2000u);
+            return sigs[sigs.size() - 1u - rnd() % window] ^ (rnd() & 1u);
+        };
+        auto a = pick(), b = pick();
+        switch(rnd() % 3u)
+        {
+        case 0u: sigs.push_back(aig.create_and(a, b)); break;
+        case 1u: sigs.push_back(aig.create_or(a, b)); break;
+        default: sigs.push_back(aig.create_xor(a, b)); break;
+        }
+    }
+    for(uint32_t i = 0; i < 64u; ++i)
+    {
+        aig.create_po(sigs[sigs.size() - 1u - 13u * i]);
+    }
+    return aig;
+}
+
+int main(int argc, char **argv)
+{
+    aig_network aig;
+    if(argc > 1)
+    {
+        write_verilog_params ports;
+        Reader reader(std::string(argv[1]), aig, ports);
+    }
+    else
+    {
+        aig = random_aig(60000u);
+    }
+    int const repeat = argc > 2 ? std::atoi(argv[2]) : 5;
+
+    /* the cut sets of the fanins */
+    cut_enumeration_params ps;
+    ps.cut_size = 6;
+    ps.cut_limit = 10;
+    auto cuts = cut_enumeration<aig_network, false, general_cut_data>(aig, ps);
+
+    std::vector<float> levels(aig.size(), 0.0f);
+    aig.foreach_gate([&](auto const& n) {
+        levels[n] = 1.0f + std::max(levels[aig.get_node(aig.get_child0(n))], levels[aig.get_node(aig.get_child1(n))]);
+    });
+
+    using network_cuts_t = decltype(cuts);
+    using cut_t = network_cuts_t::cut_t;
+    network_cuts_t::cut_set_t rcuts;
+    cut_t new_cut;
+    tic_toc t;
+
+    /* the merges alone */
+    uint64_t num_pairs = 0u, num_merged = 0u;
+    t.tic();
+    for(int r = 0; r < repeat; ++r)
+    {
+        aig.foreach_gate([&](auto const& n) {
+            for(auto const* c1 : cuts.cuts(aig.get_node(aig.get_child0(n))))
+            {
+                for(auto const* c2 : cuts.cuts(aig.get_node(aig.get_child1(n))))
+                {
+                    ++num_pairs;
+                    num_merged += c1->merge(*c2, new_cut, ps.cut_size) ? 1u : 0u;
+                }
+            }
+        });
+    }
+    double const merge = t.toc();
+    printf("merge             : %lu pairs, %lu merged, %.3f s, %.2f ns/pair\n", num_pairs, num_merged, merge, merge * 1e9 / num_pairs);
+
+    /* the merges of the pairs passing the signature test of the whole set */
+    num_merged = 0u;
+    t.tic();
+    for(int r = 0; r < repeat; ++r)
+    {
+        aig.foreach_gate([&](auto const& n) {
+            auto const& cuts1 = cuts.cuts(aig.get_node(aig.get_child1(n)));
+            for(auto const* c1 : cuts.cuts(aig.get_node(aig.get_child0(n))))
+            {
+                for(auto mask = cuts1.mergeable(*c1, ps.cut_size); mask; mask &= mask - 1u)
+                {
+                    num_merged += c1->merge(cuts1[__builtin_ctz(mask)], new_cut, ps.cut_size) ? 1u : 0u;
+                }
+            }
+        });
+    }
+    double const filtered = t.toc();
+    printf("filtered merge    : %lu pairs, %lu merged, %.3f s, %.2f ns/pair\n", num_pairs, num_merged, filtered, filtered * 1e9 / num_pairs);
+
+    /* the merges, the dominance filter and the sorted insertion */
+    uint64_t num_inserted = 0u, num_kept = 0u;
+    t.tic();
+    for(int r = 0; r < repeat; ++r)
+    {
+        aig.foreach_gate([&](auto const& n) {
+            rcuts.clear();
+            auto const& cuts1 = cuts.cuts(aig.get_node(aig.get_child1(n)));
+            for(auto const* c1 : cuts.cuts(aig.get_node(aig.get_child0(n))))
+            {
+                for(auto mask = cuts1.mergeable(*c1, ps.cut_size); mask; mask &= mask - 1u)
+                {
+                    if(!c1->merge(cuts1[__builtin_ctz(mask)], new_cut, ps.cut_size) || rcuts.is_dominated(new_cut))
+                    {
+                        continue;
+                    }
+                    float delay = 0.0f;
+                    for(auto leaf : new_cut)
+                    {
+                        delay = std::max(delay, levels[leaf]);
+                    }
+                    new_cut->data.delay = delay + 1.0f;
+                    new_cut->data.area = static_cast<float>(new_cut.size()) + static_cast<float>(new_cut.signature() % 7u) / 7.0f;
+                    new_cut->data.edge = static_cast<float>(new_cut.size());
+                    rcuts.insert(new_cut);
+                    ++num_inserted;
+                }
+            }
+            rcuts.limit(ps.cut_limit - 1);
+            num_kept += rcuts.size();
+        });
+    }
+    double const insert = t.toc();
+    printf("merge and insert  : %lu pairs, %lu inserted, %lu kept, %.3f s, %.2f ns/pair\n", num_pairs, num_inserted, num_kept, insert, insert * 1e9 / num_pairs);
+
+    return 0;
+}
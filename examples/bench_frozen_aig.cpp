@@ -0,0 +1,128 @@
+// ***************************************************************************************
+// Copyright (c) 2023-2025 Peng Cheng Laboratory
+// Copyright (c) 2023-2025 Shanghai Anlogic Infotech Co.,Ltd.
+// Copyright (c) 2023-2025 Peking University
+//
+// iMAP-FPGA is licensed under Mulan PSL v2.
+// You can use this software according to the terms and conditions of the Mulan PSL v2.
+// You may obtain a copy of Mulan PSL v2 at:
+// http://license.coscl.org.cn/MulanPSL2
+//
+// THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+// EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+// MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+//
+// See the Mulan PSL v2 for more details.
+// ***************************************************************************************
+
+
+/**
+ * microbenchmark of the traversal throughput: 64-bit simulation and levelization over
+ * foreach_gate / foreach_fanin on the aig_network node layout and on its frozen_aig copy
+ * usage: bench_frozen_aig [number of and gates] [rounds]
+ */
+#include "database/network/aig_network.hpp"
+#include "database/network/frozen_aig.hpp"
+#include "utils/tic_toc.hpp"
+
+#include <random>
+#include <cstdlib>
+#include <algorithm>
+
+using namespace iFPGA_NAMESPACE;
+
+aig_network build(uint32_t num_ands)
+{
+    aig_network aig;
+    std::vector<aig_network::signal> sigs;
+    for(uint32_t i = 0; i < 256u; ++i)
+    {
+        sigs.push_back(aig.create_pi());
+    }
+    std::mt19937_64 rnd(1);
+    for(uint32_t i = 0; i < num_ands; ++i)
+    {
+        /* mostly local fanins, a few long ones, as in a real netlist */
+        auto const range = (rnd() & 7u) ? std::min<uint64_t>(sigs.size(), 512u) : sigs.size();
+        auto a = sigs[sigs.size() - 1u - rnd() % range] ^ (rnd() & 1u);
+        auto b = sigs[sigs.size() - 1u - rnd() % range] ^ (rnd() & 1u);
+        auto const f = aig.create_and(a, b);
+        if(aig.get_node(f) != 0u)
+        {
+            sigs.push_back(f);
+        }
+    }
+    for(uint32_t i = 0; i < 256u; ++i)
+    {
+        aig.create_po(sigs[sigs.size() - 1u - i]);
+    }
+    return aig;
+}
+
+template<typename Ntk>
+uint64_t simulate(Ntk const& ntk, std::vector<uint64_t>& words)
+{
+    words.assign(ntk.size(), 0u);
+    ntk.foreach_ci([&](auto const& n, auto i) { words[n] = 0x9E3779B97F4A7C15ull * (i + 1u); });
+    ntk.foreach_gate([&](auto const& n) {
+        uint64_t w = ~uint64_t(0);
+        ntk.foreach_fanin(n, [&](auto const& f) {
+            w &= ntk.is_complemented(f) ? ~words[ntk.get_node(f)] : words[ntk.get_node(f)];
+        });
+        words[n] = w;
+    });
+    uint64_t sum = 0u;
+    ntk.foreach_po([&](auto const& f) { sum += words[ntk.get_node(f)]; });
+    return sum;
+}
+
+template<typename Ntk>
+uint64_t levelize(Ntk const& ntk, std::vector<uint32_t>& levels)
+{
+    levels.assign(ntk.size(), 0u);
+    uint32_t depth = 0u;
+    ntk.foreach_gate([&](auto const& n) {
+        uint32_t l = 0u;
+        ntk.foreach_fanin(n, [&](auto const& f) { l = std::max(l, levels[ntk.get_node(f)]); });
+        levels[n] = l + 1u;
+        depth = std::max(depth, l + 1u);
+    });
+    return depth;
+}
+
+/// the best of the rounds
+template<typename Fn>
+double best_of(uint32_t rounds, Fn&& fn, uint64_t& result)
+{
+    double best = 1e30;
+    for(uint32_t i = 0; i < rounds; ++i)
+    {
+        tic_toc t;
+        result = fn();
+        best = std::min(best, t.toc());
+    }
+    return best;
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t const num_ands = argc > 1 ? std::atoi(argv[1]) : 2000000u;
+    uint32_t const rounds   = argc > 2 ? std::atoi(argv[2]) : 5u;
+
+    auto const aig = build(num_ands);
+    tic_toc t;
+    frozen_aig const frozen(aig);
+    double const freeze = t.toc();
+    printf("%u gates, frozen in %.3f s\n", aig.num_gates(), freeze);
+
+    std::vector<uint64_t> words;
+    std::vector<uint32_t> levels;
+    uint64_t r0 = 0u, r1 = 0u;
+    double const sim0 = best_of(rounds, [&]() { return simulate(aig, words); }, r0);
+    double const sim1 = best_of(rounds, [&]() { return simulate(frozen, words); }, r1);
+    printf("%-24s: aig_network %.3f s, frozen_aig %.3f s, %.2fx%s\n", "64-bit simulation", sim0, sim1, sim0 / sim1, r0 == r1 ? "" : " MISMATCH");
+    double const lev0 = best_of(rounds, [&]() { return levelize(aig, levels); }, r0);
+    double const lev1 = best_of(rounds, [&]() { return levelize(frozen, levels); }, r1);
+    printf("%-24s: aig_network %.3f s, frozen_aig %.3f s, %.2fx%s\n", "levelization", lev0, lev1, lev0 / lev1, r0 == r1 ? "" : " MISMATCH");
+    return 0;
+}
@@ -0,0 +1,123 @@
+// ***************************************************************************************
+// Copyright (c) 2023-2025 Peng Cheng Laboratory
+// Copyright (c) 2023-2025 Shanghai Anlogic Infotech Co.,Ltd.
+// Copyright (c) 2023-2025 Peking University
+//
+// iMAP-FPGA is licensed under Mulan PSL v2.
+// You can use this software according to the terms and conditions of the Mulan PSL v2.
+// You may obtain a copy of Mulan PSL v2 at:
+// http://license.coscl.org.cn/MulanPSL2
+//
+// THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+// EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+// MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+//
+// See the Mulan PSL v2 for more details.
+// ***************************************************************************************
+
+/**
+ * benchmark of the rounds of the k-LUT mapping over the threads: the network is mapped with one
+ * thread and with the given number of threads, the times of the rounds are printed and the two
+ * mappings compared LUT by LUT
+ * usage: bench_mapping [aiger file] [threads]
+ *  without a file, a wide and a deep random network of 100k gates are mapped
+ */
+#include "io/reader.hpp"
+#include "database/network/aig_network.hpp"
+#include "algorithms/aig_with_choice.hpp"
+#include "algorithms/klut_mapping.hpp"
+#include "views/mapping_view.hpp"
+#include "utils/tic_toc.hpp"
+
+#include <random>
+#include <thread>
+#include <cstdlib>
+
+using namespace iFPGA_NAMESPACE;
+
+/* a random network with an and/or/xor mix over a window of recent signals, deeper for a smaller window */
+aig_network random_aig(uint32_t num_gates, uint32_t window)
+{
+    aig_network aig;
+    std::mt19937 rnd(5);
+    std::vector<aig_network::signal> sigs;
+    for(uint32_t i = 0; i < 64u; ++i)
+    {
+        sigs.push_back(aig.create_pi());
+    }
+    while(aig.num_gates() < num_gates)
+    {
+        auto pick = [&]() {
+            auto const w = std::min<uint32_t>(sigs.size(), window);
+            return sigs[sigs.size() - 1u - rnd() % w] ^ (rnd() & 1u);
+        };
+        auto a = pick(), b = pick();
+        switch(rnd() % 3u)
+        {
+        case 0u: sigs.push_back(aig.create_and(a, b)); break;
+        case 1u: sigs.push_back(aig.create_or(a, b)); break;
+        default: sigs.push_back(aig.create_xor(a, b)); break;
+        }
+    }
+    for(uint32_t i = 0; i < 64u; ++i)
+    {
+        aig.create_po(sigs[sigs.size() - 1u - 13u * i]);
+    }
+    return aig;
+}
+
+void bench(char const* name, aig_network const& aig, uint32_t num_threads)
+{
+    aig_with_choice awc(aig);
+    using mapped_t = mapping_view<aig_with_choice, true>;
+    mapped_t serial{awc}, parallel{awc};
+
+    auto map = [&](mapped_t& mapped, uint32_t threads) {
+        klut_mapping_params ps;
+        ps.cut_enumeration_ps.num_threads = threads;
+        klut_mapping_stats st;
+        tic_toc t;
+        auto const qor = klut_mapping<mapped_t, true>(mapped, ps, &st);
+        double const total = t.toc();
+        printf("%-6s %2u threads: %.3f s, delay %.0f, area %.0f, rounds", name, threads, total, qor.delay, qor.area);
+        for(auto r : st.round_times)
+        {
+            printf(" %.3f", r);
+        }
+        printf("\n");
+    };
+    map(serial, 1u);
+    map(parallel, num_threads);
+
+    uint32_t diff = 0u;
+    awc.foreach_node([&](auto n) {
+        if(serial.is_cell_root(n) != parallel.is_cell_root(n))
+        {
+            ++diff;
+            return;
+        }
+        if(!serial.is_cell_root(n))
+            return;
+        std::vector<uint32_t> a, b;
+        serial.foreach_cell_fanin(n, [&](auto l) { a.push_back(l); });
+        parallel.foreach_cell_fanin(n, [&](auto l) { b.push_back(l); });
+        diff += (a != b || serial.cell_function(n) != parallel.cell_function(n)) ? 1u : 0u;
+    });
+    printf("%-6s %u gates, %u LUTs differ\n", name, aig.num_gates(), diff);
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t const num_threads = argc > 2 ? std::atoi(argv[2]) : std::max(2u, std::thread::hardware_concurrency());
+    if(argc > 1)
+    {
+        aig_network aig;
+        write_verilog_params ports;
+        Reader reader(std::string(argv[1]), aig, ports);
+        bench("input", aig, num_threads);
+        return 0;
+    }
+    bench("wide", random_aig(100000u, 2000u), num_threads);
+    bench("deep", random_aig(100000u, 50u), num_threads);
+    return 0;
+}
@@ -0,0 +1,85 @@
+// ***************************************************************************************
+// Copyright (c) 2023-2025 Peng Cheng Laboratory
+// Copyright (c) 2023-2025 Shanghai Anlogic Infotech Co.,Ltd.
+// Copyright (c) 2023-2025 Peking University
+//
+// iMAP-FPGA is licensed under Mulan PSL v2.
+// You can use this software according to the terms and conditions of the Mulan PSL v2.
+// You may obtain a copy of Mulan PSL v2 at:
+// http://license.coscl.org.cn/MulanPSL2
+//
+// THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+// EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+// MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+//
+// See the Mulan PSL v2 for more details.
+// ***************************************************************************************
+
+/**
+ * microbenchmark of the structural hashing: create_and throughput of
+ * random AIG construction, AIGER loading and rewrite
+ * usage: bench_strash [aiger file] [repeat]
+ */
+#include "io/reader.hpp"
+#include "optimization/rewrite.hpp"
+#include "database/network/aig_network.hpp"
+#include "utils/tic_toc.hpp"
+
+#include <random>
+#include <cstdlib>
+
+int main(int argc, char **argv)
+{
+    iFPGA_NAMESPACE::tic_toc t;
+
+    /* random construction, half of the calls hit an existing node */
+    {
+        uint32_t const num_ands = 4000000u;
+        iFPGA_NAMESPACE::aig_network aig;
+        std::vector<iFPGA_NAMESPACE::aig_network::signal> sigs;
+        for(uint32_t i = 0; i < 256u; ++i)
+        {
+            sigs.push_back(aig.create_pi());
+        }
+        std::mt19937_64 rnd(1);
+        t.tic();
+        for(uint32_t i = 0; i < num_ands; ++i)
+        {
+            auto a = sigs[rnd() % sigs.size()] ^ (rnd() & 1u);
+            auto b = sigs[rnd() % sigs.size()] ^ (rnd() & 1u);
+            auto f = aig.create_and(a, b);
+            aig.create_and(b, a);
+            sigs.push_back(f);
+        }
+        double const time = t.toc();
+        printf("random create_and : %u nodes, %.3f s, %.2f M calls/s\n", aig.size(), time, 2.0 * num_ands / time / 1e6);
+    }
+
+    if(argc < 2)
+    {
+        return 0;
+    }
+
+    std::string file = std::string(argv[1]);
+    int const repeat = argc > 2 ? std::atoi(argv[2]) : 10;
+    iFPGA_NAMESPACE::write_verilog_params ports;
+
+    t.tic();
+    uint32_t num_gates = 0u;
+    for(int i = 0; i < repeat; ++i)
+    {
+        iFPGA_NAMESPACE::aig_network aig;
+        iFPGA_NAMESPACE::Reader reader(file, aig, ports);
+        num_gates = aig.num_gates();
+    }
+    double const load = t.toc();
+    printf("aiger load        : %u gates x %d, %.3f s, %.2f M gates/s\n", num_gates, repeat, load, 1.0 * num_gates * repeat / load / 1e6);
+
+    iFPGA_NAMESPACE::aig_network aig;
+    iFPGA_NAMESPACE::Reader reader(file, aig, ports);
+    iFPGA_NAMESPACE::rewrite_params ps;
+    t.tic();
+    auto raig = iFPGA_NAMESPACE::rewrite(aig, ps);
+    printf("rewrite           : %u -> %u gates, %.3f s\n", num_gates, raig.num_gates(), t.toc());
+    return 0;
+}
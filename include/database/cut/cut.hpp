@@ -27,7 +27,6 @@
 
 iFPGA_NAMESPACE_HEADER_START
 
-// state a global variables
 /**
  * @brief the Comparation type
  */
@@ -48,21 +47,6 @@ enum ETypeMode {
   ETM_FLOW,         // area or area flow
 };
 
-/**
- * @brief global variable and functions
- *        
- *    numeration type of gv_etc for marking the step of mapping rounds,      
- *    ifferent mapping rounds may based on different cut_enumeration trics
- */
-ETypeCmp gv_etc{ETC_DELAY};
-ETypeCmp gf_get_etc() { return gv_etc; }
-void gf_set_etc(ETypeCmp const& etc)  { gv_etc = etc; } 
-
-ETypeMode gv_etm{ETM_DELAY};
-ETypeMode gf_get_etm() { return gv_etm; }
-void gf_set_etm(ETypeMode const& etm)  { gv_etm = etm; } 
-
-
 /**
  * @brief the basic cut class for cut_enumeration 
  *  
@@ -76,6 +60,8 @@ void gf_set_etm(ETypeMode const& etm)  { gv_etm = etm; }
 template<int MaxLeaves, typename T = empty_cut_data>
 class cut
 {
+  static_assert( MaxLeaves < 256, "the length of a cut is kept in a byte" );
+
 public:
   /*! \brief Default constructor.
    */
@@ -89,7 +75,7 @@ public:
    */
   cut( cut const& other )
   {
-    _cend = _end = std::copy( other.begin(), other.end(), _leaves.begin() );
+    std::copy( other.begin(), other.end(), _leaves.begin() );
     _length = other._length;
     _signature = other._signature;
     _data = other._data;
@@ -123,19 +109,19 @@ public:
   auto signature() const { return _signature; }
 
   /*! \brief Returns the size of the cut (number of leaves). */
-  auto size() const { return _length; }
+  uint32_t size() const { return _length; }
 
   /*! \brief Begin iterator (constant). */
   auto begin() const { return _leaves.begin(); }
 
   /*! \brief End iterator (constant). */
-  auto end() const { return _cend; }
+  auto end() const { return _leaves.begin() + _length; }
 
   /*! \brief Begin iterator (mutable). */
   auto begin() { return _leaves.begin(); }
 
   /*! \brief End iterator (mutable). */
-  auto end() { return _end; }
+  auto end() { return _leaves.begin() + _length; }
 
   /*! \brief Access to data (mutable). */
   T* operator->() { return &_data; }
@@ -176,10 +162,8 @@ public:
 
 private:
   std::array<uint32_t, MaxLeaves> _leaves;
-  uint32_t                        _length{0};
+  uint8_t                         _length{0};   // the end of the leaves is derived from it
   uint64_t                        _signature{0};
-  typename std::array<uint32_t, MaxLeaves>::const_iterator _cend;
-  typename std::array<uint32_t, MaxLeaves>::iterator       _end;
   T                               _data;
 };
 
@@ -214,7 +198,7 @@ cut<MaxLeaves, T>& cut<MaxLeaves, T>::operator=( cut<MaxLeaves, T> const& other
 {
   if ( &other != this )
   {
-    _cend = _end = std::copy( other.begin(), other.end(), _leaves.begin() );
+    std::copy( other.begin(), other.end(), _leaves.begin() );
     _length = other._length;
     _signature = other._signature;
     _data = other._data;
@@ -226,8 +210,8 @@ template<int MaxLeaves, typename T>
 template<typename Iterator>
 void cut<MaxLeaves, T>::set_leaves( Iterator begin, Iterator end )
 {
-  _cend = _end = std::copy( begin, end, _leaves.begin() );
-  _length = static_cast<uint32_t>( std::distance( begin, end ) );
+  std::copy( begin, end, _leaves.begin() );
+  _length = static_cast<uint8_t>( std::distance( begin, end ) );
   _signature = 0;
 
   while ( begin != end )
@@ -286,22 +270,36 @@ bool cut<MaxLeaves, T>::merge( cut const& that, cut& res, uint32_t cut_size ) co
 {
   if ( _length + that._length > cut_size )
   {
-    const auto sign = _signature + that._signature;
+    const auto sign = _signature | that._signature;
     if ( uint32_t( __builtin_popcount( static_cast<uint32_t>( sign & 0xffffffff ) ) ) + uint32_t( __builtin_popcount( static_cast<uint32_t>( sign >> 32 ) ) ) > cut_size )
     {
       return false;
     }
   }
 
-  auto it = std::set_union( begin(), end(), that.begin(), that.end(), res.begin() );
-  if ( auto length = std::distance( res.begin(), it ); length <= cut_size )
+  /* the union of the sorted leaves, it stops as soon as it has too many leaves */
+  auto it1 = begin(), it2 = that.begin();
+  auto const end1 = end(), end2 = that.end();
+  uint32_t length = 0u;
+  while ( it1 != end1 && it2 != end2 )
   {
-    res._cend = res._end = it;
-    res._length = static_cast<uint32_t>( length );
-    res._signature = _signature | that._signature;
-    return true;
+    if ( length == cut_size )
+    {
+      return false;
+    }
+    auto const l1 = *it1, l2 = *it2;
+    res._leaves[length++] = l1 < l2 ? l1 : l2;
+    it1 += l1 <= l2;
+    it2 += l2 <= l1;
   }
-  return false;
+  if ( length + ( end1 - it1 ) + ( end2 - it2 ) > cut_size )
+  {
+    return false;
+  }
+  auto it = std::copy( it2, end2, std::copy( it1, end1, res._leaves.begin() + length ) );
+  res._length = static_cast<uint8_t>( it - res._leaves.begin() );
+  res._signature = _signature | that._signature;
+  return true;
 }
 
 
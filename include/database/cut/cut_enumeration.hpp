@@ -21,7 +21,9 @@
 #include "cut/cut.hpp"
 #include "cut/cut_set.hpp"
 #include "cut/detail/cut_data.hpp"
-#include "utils/truth_table_cache.hpp"
+#include "cut/detail/cut_function.hpp"
+#include "cut/detail/level_parallel.hpp"
+#include "utils/truth_table_pool.hpp"
 
 #include "kitty/constructors.hpp"
 #include "kitty/dynamic_truth_table.hpp"
@@ -31,6 +33,7 @@
 #include <cassert>
 #include <cstdint>
 #include <iostream>
+#include <memory>
 #include <optional>
 #include <vector>
 
@@ -55,6 +58,13 @@ struct cut_enumeration_params
   /*! \brief Prune cuts by removing don't cares. */
   bool minimize_truth_table{false};
 
+  /*! \brief Number of threads, more than 1 enumerates the cuts level by level in parallel. */
+  uint32_t num_threads{1u};
+
+  /*! \brief The pool the functions of the cuts are interned in, shared by the cut databases
+   *         built with these parameters; each database has its own one when empty. */
+  std::shared_ptr<truth_table_pool<kitty::dynamic_truth_table>> truth_tables;
+
   /*! \brief Be verbose. */
   bool verbose{false};
 
@@ -87,7 +97,8 @@ struct cut_data;
 template<typename T>
 struct cut_data<true, T>
 {
-  uint32_t func_id{0u};
+  uint64_t func_word{0u};   // the function of the cuts of at most max_word_cut_size leaves
+  uint32_t func_id{0u};     // the literal in the truth table cache, for the cuts of more than max_word_cut_size leaves
   T data;
 };
 
@@ -97,16 +108,65 @@ struct cut_data<false, T>
   T data;
 };
 
-template<bool ComputeTruth, typename T>
-using cut_type = cut<max_cut_size, cut_data<ComputeTruth, T>>;
+template<bool ComputeTruth, typename T, uint32_t MaxLeaves = max_cut_size>
+using cut_type = cut<MaxLeaves, cut_data<ComputeTruth, T>>;
+
+/**
+ * @brief the capacity of the cut database, fixed at compile time
+ * @tparam MaxLeaves the max number of leaves of a cut, at least cut_size
+ * @tparam MaxCuts   the max number of cuts of a node during the enumeration, more than cut_limit
+ */
+template<uint32_t MaxLeaves, uint32_t MaxCuts>
+struct cut_config
+{
+  static constexpr uint32_t max_leaves = MaxLeaves;
+  static constexpr uint32_t max_cuts   = MaxCuts;
+};
+
+using default_cut_config = cut_config<max_cut_size, 12u>;
+
+/**
+ * @brief calls fn( Config{} ) with the smallest of the instantiated configurations holding cuts of
+ *        cut_size leaves and cut_limit cuts per node: 4x12, 6x12, 8x12, 6x22 and 8x22
+ * @return false if none holds them, fn is not called
+ */
+template<typename Fn>
+bool dispatch_cut_config( uint32_t cut_size, uint32_t cut_limit, Fn&& fn )
+{
+  if ( cut_limit < 12u )
+  {
+    if ( cut_size <= 4u )
+      fn( cut_config<4u, 12u>{} );
+    else if ( cut_size <= 6u )
+      fn( cut_config<6u, 12u>{} );
+    else if ( cut_size <= 8u )
+      fn( cut_config<8u, 12u>{} );
+    else
+      return false;
+  }
+  else if ( cut_limit < 22u )
+  {
+    if ( cut_size <= 6u )
+      fn( cut_config<6u, 22u>{} );
+    else if ( cut_size <= 8u )
+      fn( cut_config<8u, 22u>{} );
+    else
+      return false;
+  }
+  else
+  {
+    return false;
+  }
+  return true;
+}
 
 /* forward declarations */
 /*! \cond PRIVATE */
-template<typename Ntk, bool ComputeTruth, typename CutData>
+template<typename Ntk, bool ComputeTruth, typename CutData, typename Config>
 struct network_cuts;
 
-template<typename Ntk, bool ComputeTruth = false, typename CutData = empty_cut_data>
-network_cuts<Ntk, ComputeTruth, CutData> cut_enumeration( Ntk const& ntk, cut_enumeration_params const& ps = {}, cut_enumeration_stats * pst = nullptr );
+template<typename Ntk, bool ComputeTruth = false, typename CutData = empty_cut_data, typename Config = default_cut_config>
+network_cuts<Ntk, ComputeTruth, CutData, Config> cut_enumeration( Ntk const& ntk, cut_enumeration_params const& ps = {}, cut_enumeration_stats * pst = nullptr );
 
 /* function to update a cut */
 template<typename CutData>
@@ -125,7 +185,7 @@ struct cut_enumeration_update_cut
 
 namespace detail
 {
-template<typename Ntk, bool ComputeTruth, typename CutData>
+template<typename Ntk, bool ComputeTruth, typename CutData, typename Config>
 class cut_enumeration_impl;
 }
 /*! \endcond */
@@ -151,23 +211,32 @@ struct network_cuts_params
  * An instance of type `network_cuts` can only be constructed from the
  * `cut_enumeration` algorithm.
  */
-template<typename Ntk, bool ComputeTruth, typename CutData>
+template<typename Ntk, bool ComputeTruth, typename CutData, typename Config = default_cut_config>
 struct network_cuts
 {
 public:
-  static constexpr uint32_t max_cut_num = 12;
-  using cut_t     = cut_type<ComputeTruth, CutData>;
+  static constexpr uint32_t max_cut_num = Config::max_cuts;
+  using cut_t     = cut_type<ComputeTruth, CutData, Config::max_leaves>;
   using cut_set_t = cut_set<cut_t, max_cut_num>;
+  using truth_table_pool_t = truth_table_pool<kitty::dynamic_truth_table>;
 
-  explicit network_cuts( uint32_t size ) 
-    : _cuts( size ),
-      _best_cuts( size )
+  /*! \brief Constructor.
+   *
+   * \param size Number of nodes
+   * \param allocate Whether the cut sets take their slabs now, otherwise they
+   *                 hold no memory until they are cleared or acquire a slab
+   * \param truth_tables The pool the functions are interned in, a new one when empty
+   */
+  explicit network_cuts( uint32_t size, bool allocate = true, std::shared_ptr<truth_table_pool_t> truth_tables = {} )
+    : _cuts( size, allocate ? cut_set_t() : cut_set_t( std::vector<cut_t>() ) ),
+      _best_cuts( size ),
+      _truth_tables( truth_tables ? std::move( truth_tables ) : std::make_shared<truth_table_pool_t>() )
   {
     kitty::dynamic_truth_table zero( 0u ), proj( 1u );
     kitty::create_nth_var( proj, 0u );
 
-    _truth_tables.insert( zero );
-    _truth_tables.insert( proj );
+    _zero_lit = _truth_tables->insert( zero );
+    _proj_lit = _truth_tables->insert( proj );
   }
 
 public:
@@ -182,19 +251,62 @@ public:
 
   /*! \brief Returns the truth table of a cut */
   template<bool enabled = ComputeTruth, typename = std::enable_if_t<std::is_same_v<Ntk, Ntk> && enabled>>
-  auto truth_table( cut_t const& cut ) const
+  kitty::dynamic_truth_table truth_table( cut_t const& cut ) const
+  {
+    if ( cut.size() <= max_word_cut_size )
+    {
+      return detail::word_to_truth_table( cut->func_word, cut.size() );
+    }
+    return ( *_truth_tables )[cut->func_id];
+  }
+
+  /*! \brief Complements the function of a cut */
+  template<bool enabled = ComputeTruth, typename = std::enable_if_t<std::is_same_v<Ntk, Ntk> && enabled>>
+  static void complement_truth_table( cut_t& cut )
+  {
+    cut->func_id ^= 1;
+    cut->func_word = ~cut->func_word;
+  }
+
+  /*! \brief Computes the function of a cut of at most 6 leaves on words.
+   *
+   * The functions of the two cuts merged into `res` are moved onto its leaves
+   * and combined by the AND gate `n`.  With `minimize`, the leaves the function
+   * does not depend on are removed from `res`.
+   */
+  template<typename Node, bool enabled = ComputeTruth, typename = std::enable_if_t<std::is_same_v<Ntk, Ntk> && enabled>>
+  void compute_word_function( Ntk const& ntk, Node const& n, std::vector<cut_t const*> const& vcuts, cut_t& res, bool minimize ) const
   {
-    return _truth_tables[cut->func_id];
+    assert( res.size() <= max_word_cut_size );
+    auto const w0 = detail::expand_cut_word( ( *vcuts[0] )->func_word, *vcuts[0], res );
+    auto const w1 = detail::expand_cut_word( ( *vcuts[1] )->func_word, *vcuts[1], res );
+    auto word = ( ntk.is_complemented( ntk.get_child0( n ) ) ? ~w0 : w0 ) & ( ntk.is_complemented( ntk.get_child1( n ) ) ? ~w1 : w1 );
+
+    if ( minimize )
+    {
+      std::array<uint8_t, max_word_cut_size> support;
+      auto const size = detail::min_base_word( word, res.size(), support );
+      if ( size != res.size() )
+      {
+        std::array<uint32_t, max_word_cut_size> leaves;
+        for ( auto i = 0u; i < size; ++i )
+        {
+          leaves[i] = *( res.begin() + support[i] );
+        }
+        res.set_leaves( leaves.begin(), leaves.begin() + size );
+      }
+    }
+    res->func_word = word;
   }
 
   kitty::dynamic_truth_table extend_truth_table_at(uint32_t func_id, cut_t& res)
   {
-    return kitty::extend_to(_truth_tables[func_id], res.size() );
+    return kitty::extend_to( ( *_truth_tables )[func_id], res.size() );
   }
 
   kitty::dynamic_truth_table at(uint32_t id)
   {
-    return _truth_tables[id];
+    return ( *_truth_tables )[id];
   }
 
   /* compute positions of leave indices in cut `sub` (subset) with respect to
@@ -228,26 +340,42 @@ public:
    */
   uint32_t insert_truth_table( kitty::dynamic_truth_table const& tt )
   {
-    return _truth_tables.insert( tt );
+    return _truth_tables->insert( tt );
+  }
+
+  /*! \brief Returns the truth table pool the functions of the cuts are interned in. */
+  truth_table_pool_t& truth_tables()
+  {
+    return *_truth_tables;
+  }
+
+  /*! \brief Returns the shared truth table pool, to build another cut database on it. */
+  std::shared_ptr<truth_table_pool_t> const& shared_truth_tables() const
+  {
+    return _truth_tables;
   }
 
   void add_zero_cut( uint32_t index )
   {
     auto& cut = _cuts[index].add_cut( &index, &index ); /* fake iterator for emptyness */
+    cut.data() = {};  /* the slot may hold the data of an earlier cut */
 
     if constexpr ( ComputeTruth )
     {
-      cut->func_id = 0;
+      cut->func_id = _zero_lit;
+      cut->func_word = 0u;
     }
   }
 
   void add_unit_cut( uint32_t index )
   {
     auto& cut = _cuts[index].add_cut( &index, &index + 1 );
+    cut.data() = {};  /* the slot may hold the data of an earlier cut */
 
     if constexpr ( ComputeTruth )
     {
-      cut->func_id = 2;
+      cut->func_id = _proj_lit;
+      cut->func_word = kitty::detail::projections[0];
     }
   }
 
@@ -257,6 +385,12 @@ public:
     return _total_tuples;
   }
 
+  /*! \brief Returns the total number of tuples that were merged */
+  auto total_merges() const
+  {
+    return _total_merges;
+  }
+
   /*! \brief Returns the total number of cuts in the database. */
   auto total_cuts() const
   {
@@ -265,14 +399,22 @@ public:
 
   void incre_total_cuts(uint32_t size)
   {
+#pragma omp atomic
     _total_cuts += size;
   }
   
   void incre_total_tuples(uint32_t size)
   {
+#pragma omp atomic
     _total_tuples += size;
   }
 
+  void incre_total_merges(uint32_t size)
+  {
+#pragma omp atomic
+    _total_merges += size;
+  }
+
   /*! \brief Returns the number of nodes for which cuts are computed */
   auto nodes_size() const
   {
@@ -281,7 +423,7 @@ public:
   
   auto truth_cache_size() const
   {
-    return _truth_tables.size();
+    return _truth_tables->size();
   }
   
   void print_cuts()
@@ -295,11 +437,11 @@ public:
   }
 
 private:
-  template<typename _Ntk, bool _ComputeTruth, typename _CutData>
+  template<typename _Ntk, bool _ComputeTruth, typename _CutData, typename _Config>
   friend class detail::cut_enumeration_impl;
 
-  template<typename _Ntk, bool _ComputeTruth, typename _CutData>
-  friend network_cuts<_Ntk, _ComputeTruth, _CutData> cut_enumeration( _Ntk const& ntk, cut_enumeration_params const& ps, cut_enumeration_stats * pst );
+  template<typename _Ntk, bool _ComputeTruth, typename _CutData, typename _Config>
+  friend network_cuts<_Ntk, _ComputeTruth, _CutData, _Config> cut_enumeration( _Ntk const& ntk, cut_enumeration_params const& ps, cut_enumeration_stats * pst );
 
 private:
   /* compressed representation of cuts */
@@ -307,11 +449,14 @@ private:
   /* store the current best cuts of the nodes, not include the PIs and constants */
   std::vector<cut_t>     _best_cuts;
 
-  /* cut truth tables */
-  truth_table_cache<kitty::dynamic_truth_table> _truth_tables;
+  /* cut truth tables, possibly shared with other cut databases */
+  std::shared_ptr<truth_table_pool_t> _truth_tables;
+  uint32_t _zero_lit{0u};
+  uint32_t _proj_lit{2u};
 
   /* statistics */
   uint32_t    _total_tuples{};
+  std::size_t _total_merges{};
   std::size_t _total_cuts{};
 };
 
@@ -319,25 +464,33 @@ private:
 namespace detail
 {
 
-template<typename Ntk, bool ComputeTruth, typename CutData>
+template<typename Ntk, bool ComputeTruth, typename CutData, typename Config = default_cut_config>
 class cut_enumeration_impl
 {
 public:
-  using cut_t = typename network_cuts<Ntk, ComputeTruth, CutData>::cut_t;
-  using cut_set_t = typename network_cuts<Ntk, ComputeTruth, CutData>::cut_set_t;
+  using network_cuts_t = network_cuts<Ntk, ComputeTruth, CutData, Config>;
+  using cut_t = typename network_cuts_t::cut_t;
+  using cut_set_t = typename network_cuts_t::cut_set_t;
 
-  explicit cut_enumeration_impl( Ntk const& ntk, cut_enumeration_params const& ps, cut_enumeration_stats& st, network_cuts<Ntk, ComputeTruth, CutData>& cuts )
+  explicit cut_enumeration_impl( Ntk const& ntk, cut_enumeration_params const& ps, cut_enumeration_stats& st, network_cuts_t& cuts )
       : ntk( ntk ),
         ps( ps ),
         st( st ),
         cuts( cuts )
   {
     assert( ps.cut_limit < cuts.max_cut_num && "cut_limit exceeds the compile-time limit for the maximum number of cuts" );
+    assert( ps.cut_size <= Config::max_leaves && "cut_size exceeds the compile-time limit for the maximum number of leaves" );
   }
 
 public:
   void run()
   {
+    if ( ps.num_threads > 1u )
+    {
+      run_parallel();
+      return;
+    }
+
     ntk.foreach_node( [this]( auto node ) {
       const auto index = ntk.node_to_index( node );
 
@@ -358,9 +511,44 @@ public:
       }
       else
       {
-        merge_cuts2( index );
+        merge_cuts2( index, *cuts._truth_tables );
+      }
+    } );
+  }
+
+  /**
+   * @brief the cuts of the nodes of one level only depend on lower levels, they are computed in parallel
+   */
+  void run_parallel()
+  {
+    std::vector<uint32_t> gates;
+    ntk.foreach_node( [&]( auto node ) {
+      const auto index = ntk.node_to_index( node );
+      if ( ntk.is_constant( node ) )
+      {
+        cuts.add_zero_cut( index );
+      }
+      else if ( ntk.is_pi( node ) )
+      {
+        cuts.add_unit_cut( index );
+      }
+      else
+      {
+        gates.push_back( index );
       }
     } );
+
+    const auto levels = group_by_level<uint32_t>( ntk.size(), gates, [this]( auto index, auto&& fn ) {
+      const auto node = ntk.index_to_node( index );
+      fn( ntk.node_to_index( ntk.get_node( ntk.get_child0( node ) ) ) );
+      fn( ntk.node_to_index( ntk.get_node( ntk.get_child1( node ) ) ) );
+    } );
+    for ( auto const& group : levels )
+    {
+      enumerate_level_parallel( cuts, group, ps.num_threads, [this]( auto index, auto& cache ) {
+        merge_cuts2( index, cache );
+      } );
+    }
   }
   
   /**
@@ -370,15 +558,17 @@ public:
    *      2. store the privious best cut to current
    *      3. limited the cut_set size to C
    * @param index the node's index for priority cut computation 
-   * @param limit the limited priority cut size
+   * @param cache the truth table cache of the new functions
    * 
    */
-  void merge_cuts2( uint32_t index)
+  template<typename Cache>
+  void merge_cuts2( uint32_t index, Cache& cache )
   {
     auto node = ntk.index_to_node( index );
     const auto fanin = 2;
     uint32_t pairs{1};
     std::array<uint32_t, 2> children_id;      // store the children's index
+    std::array<cut_set_t*, 3> lcuts;
 
     auto child0_index = ntk.get_node( ntk.get_child0(node) );
     auto child1_index = ntk.get_node( ntk.get_child1(node) );
@@ -406,8 +596,10 @@ public:
 
     for ( auto const& c1 : *lcuts[0] )
     {
-      for ( auto const& c2 : *lcuts[1] )
+      /* the pairs whose signatures have too many leaves are skipped at once */
+      for ( auto mask = lcuts[1]->mergeable( *c1, ps.cut_size ); mask; mask &= mask - 1u )
       {
+        auto const* c2 = &( *lcuts[1] )[__builtin_ctz( mask )];
         if ( !c1->merge( *c2, new_cut, ps.cut_size ) )
         {
           continue;
@@ -422,7 +614,7 @@ public:
         {
           vcuts[0] = c1;
           vcuts[1] = c2;
-          new_cut->func_id = compute_truth_table( index, vcuts, new_cut );
+          compute_truth_table( index, vcuts, new_cut, cache );
         }
 
         cut_enumeration_update_cut<CutData>::apply( new_cut, cuts, ntk, node );
@@ -434,7 +626,7 @@ public:
     /* limit the maximum number of cuts, and reserve one position for trival cut */
     rcuts.limit( ps.cut_limit - 1 );
 
-    cuts._total_cuts += rcuts.size();
+    cuts.incre_total_cuts( rcuts.size() );
     /* add trival cut ,and it directlt add at the end of cuts */ 
     if ( rcuts.size() > 1 || ( *rcuts.begin() )->size() > 1 )
     {
@@ -443,23 +635,28 @@ public:
   }
 
   /**
-   * @brief compute the truth table of a cut
+   * @brief compute the truth table of a cut, a word for at most max_word_cut_size leaves
    * 
    * @param index 
    * @param vcuts 
    * @param res 
-   * @return uint32_t 
+   * @param cache the cache the wider functions are interned in
    */
-  uint32_t compute_truth_table( uint32_t index, std::vector<cut_t const*> const& vcuts, cut_t& res )
+  template<typename Cache>
+  void compute_truth_table( uint32_t index, std::vector<cut_t const*> const& vcuts, cut_t& res, Cache& cache )
   {
+    if ( res.size() <= max_word_cut_size )
+    {
+      cuts.compute_word_function( ntk, ntk.index_to_node( index ), vcuts, res, ps.minimize_truth_table );
+      return;
+    }
 
     std::vector<kitty::dynamic_truth_table> tt( vcuts.size() );
     auto i = 0;
 
     for ( auto const& cut : vcuts )
     {
-      assert( ( ( *cut )->func_id >> 1 ) <= cuts._truth_tables.size() );
-      tt[i] = kitty::extend_to( cuts._truth_tables[( *cut )->func_id], res.size() );
+      tt[i] = kitty::extend_to( cuts.truth_table( *cut ), res.size() );
       const auto supp = cuts.compute_truth_table_support( *cut, res );
       kitty::expand_inplace( tt[i], supp );
       ++i;
@@ -483,29 +680,33 @@ public:
           *it_leaves++ = leaves_before[*it_support++];
         }
         res.set_leaves( leaves_after.begin(), leaves_after.end() );
-        return cuts._truth_tables.insert( tt_res_shrink );
+        if ( res.size() <= max_word_cut_size )
+        {
+          res->func_word = detail::truth_table_to_word( tt_res_shrink );
+          return;
+        }
+        res->func_id = cache.insert( tt_res_shrink );
+        return;
       }
     }
 
-    return cuts._truth_tables.insert( tt_res );
+    res->func_id = cache.insert( tt_res );
   }
 
 private:
   Ntk const& ntk;
   cut_enumeration_params const& ps;
   cut_enumeration_stats& st;
-  network_cuts<Ntk, ComputeTruth, CutData>& cuts;
-
-  std::array<cut_set_t*, Ntk::max_fanin_size + 1> lcuts;
+  network_cuts_t& cuts;
 };
 } /* namespace detail */
 
-template<typename Ntk, bool ComputeTruth, typename CutData>
-network_cuts<Ntk, ComputeTruth, CutData> cut_enumeration( Ntk const& ntk, cut_enumeration_params const& ps, cut_enumeration_stats * pst )
+template<typename Ntk, bool ComputeTruth, typename CutData, typename Config>
+network_cuts<Ntk, ComputeTruth, CutData, Config> cut_enumeration( Ntk const& ntk, cut_enumeration_params const& ps, cut_enumeration_stats * pst )
 {
   cut_enumeration_stats st;
-  network_cuts<Ntk, ComputeTruth, CutData> res( ntk.size() );
-  detail::cut_enumeration_impl<Ntk, ComputeTruth, CutData> p( ntk, ps, st, res );
+  network_cuts<Ntk, ComputeTruth, CutData, Config> res( ntk.size(), true, ps.truth_tables );
+  detail::cut_enumeration_impl<Ntk, ComputeTruth, CutData, Config> p( ntk, ps, st, res );
   p.run();
 
   if ( ps.verbose )
@@ -17,11 +17,13 @@
 
 #pragma once
 #include "cut.hpp"
+#include "detail/cut_signatures.hpp"
 
 #include <vector>
 #include <array>
 #include <iterator>
 #include <algorithm>
+#include <utility>
 #include <assert.h>
 
 iFPGA_NAMESPACE_HEADER_START
@@ -30,11 +32,58 @@ iFPGA_NAMESPACE_HEADER_START
  * @brief some operation of a cut_set
  *    CutType, the cut type , Cut<MaxLeaves , data_type> , eg: Cut<10 , uing32_t>
  *    MaxCuts, control the max number of cuts a cut_set could hold
+ *
+ *    the cuts live in a slab of MaxCuts slots, their order is a permutation of the slot indices,
+ *    the first size() entries are the cuts of the set and the others are the free slots.
+ *    The signatures of the cuts are kept in order next to it, for the tests against the whole set
  */
 template<typename CutType, int MaxCuts>
 class cut_set
 {
+  static_assert( MaxCuts < 32, "the cuts of a cut_set are tested in a 32-bit mask" );
+
 public:
+  /**
+   * @brief iterates the cuts in order, dereferences to a pointer of the cut
+   */
+  template<typename Cut>
+  class order_iterator
+  {
+  public:
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type        = Cut*;
+    using difference_type   = std::ptrdiff_t;
+    using pointer           = Cut* const*;
+    using reference         = Cut*;
+
+    order_iterator() = default;
+    order_iterator( Cut* slab, uint8_t const* pos ) : _slab( slab ), _pos( pos ) {}
+
+    Cut* operator*() const { return _slab + *_pos; }
+    Cut* operator[]( difference_type i ) const { return _slab + _pos[i]; }
+
+    order_iterator& operator++() { ++_pos; return *this; }
+    order_iterator& operator--() { --_pos; return *this; }
+    order_iterator operator++( int ) { auto it = *this; ++_pos; return it; }
+    order_iterator operator--( int ) { auto it = *this; --_pos; return it; }
+    order_iterator& operator+=( difference_type i ) { _pos += i; return *this; }
+    order_iterator& operator-=( difference_type i ) { _pos -= i; return *this; }
+    order_iterator operator+( difference_type i ) const { return { _slab, _pos + i }; }
+    order_iterator operator-( difference_type i ) const { return { _slab, _pos - i }; }
+    difference_type operator-( order_iterator const& other ) const { return _pos - other._pos; }
+
+    bool operator==( order_iterator const& other ) const { return _pos == other._pos; }
+    bool operator!=( order_iterator const& other ) const { return _pos != other._pos; }
+    bool operator<( order_iterator const& other ) const { return _pos < other._pos; }
+
+  private:
+    Cut*           _slab{nullptr};
+    uint8_t const* _pos{nullptr};
+  };
+
+  using iterator       = order_iterator<CutType>;
+  using const_iterator = order_iterator<CutType const>;
+
   /**
    * @brief constructor
    */
@@ -44,27 +93,31 @@ public:
   }
 
   /**
-   * @brief release data and pointer the _pcuts to _cuts
+   * @brief constructor over a slab, an empty slab holds no memory until clear() or acquire()
+   */
+  explicit cut_set( std::vector<CutType>&& slab )
+    : _cuts( std::move( slab ) )
+  {
+    repointer();
+  }
+
+  /**
+   * @brief release data and reset the order to the slab
    */
   void clear()
   {
     _cuts.resize(MaxCuts);
-    _length = 0u;
-    _pcend = _pend = _pcuts.begin();
-    auto it = _pcuts.begin();
-    for(auto& c : _cuts)
-      *it++ = &c;
+    repointer();
   }
 
   /**
-   * @brief pointer point to the new memory chunk
+   * @brief reset the order to the slots of the slab
    */
   void repointer()
   {
-    _pcend = _pend = _pcuts.begin();
-    auto it = _pcuts.begin();
-    for(auto& c : _cuts)
-      *it++ = &c;
+    _size = 0u;
+    for(auto i = 0u; i < _order.size(); ++i)
+      _order[i] = static_cast<uint8_t>( i );
   }
 
   /**
@@ -74,7 +127,6 @@ public:
   {
     _cuts.clear();
     _cuts.shrink_to_fit();
-    _length = 0u;
     repointer();
   }
 
@@ -83,45 +135,68 @@ public:
    */
   void resize_to_fit()
   {
+    auto const num_cuts = size();
     _cuts[0] = best();
-    _cuts.resize(size());
+    _cuts.resize(num_cuts);
     _cuts.shrink_to_fit();
-    _length = size();
     repointer();
   }
-  
-  auto begin() const  { return _pcuts.begin(); }
-  auto end()   const  { return _pcend; }
-  auto begin()        { return _pcuts.begin(); }
-  auto end()          { return _pend; }
-  auto size()  const  { return _pcend - _pcuts.begin(); }
+
+  /**
+   * @brief hand the slab over, the set holds no memory afterwards
+   */
+  std::vector<CutType> release()
+  {
+    repointer();
+    return std::exchange( _cuts, {} );
+  }
+
+  /**
+   * @brief take the slab of a released set
+   */
+  void acquire( std::vector<CutType>&& slab )
+  {
+    _cuts = std::move( slab );
+    _cuts.resize(MaxCuts);
+    repointer();
+  }
+
+  /**
+   * @brief whether the set holds a slab
+   */
+  bool has_slab() const { return !_cuts.empty(); }
+
+  const_iterator begin() const  { return { _cuts.data(), _order.data() }; }
+  const_iterator end()   const  { return { _cuts.data(), _order.data() + _size }; }
+  iterator begin()              { return { _cuts.data(), _order.data() }; }
+  iterator end()                { return { _cuts.data(), _order.data() + _size }; }
+  uint32_t size()        const  { return _size; }
 
   /**
    * @brief return the index's cut itself 
    */
   auto const& operator[]( uint32_t index) const
   {
-    return *_pcuts[index];
+    return _cuts[_order[index]];
   }
 
   auto const& best() const
   {
-    return *_pcuts[0];
+    return _cuts[_order[0]];
   }
 
   auto& best()
   {
-    return *_pcuts[0];
+    return _cuts[_order[0]];
   }
 
   template<typename Iterator>
   CutType& add_cut(Iterator begin, Iterator end)
   {
-    assert( _pcend != _pcuts.end() );
-    auto& cut = **_pend++;
+    assert( _size != MaxCuts );
+    auto& cut = _cuts[_order[_size]];
     cut.set_leaves(begin, end);
-    ++_pcend;
-    ++_length;
+    _signs[_size++] = cut.signature();
     return cut;
   }
 
@@ -131,51 +206,110 @@ public:
    */
   bool is_dominated(CutType const& cut) const
   {
-    return std::find_if( _pcuts.begin(), _pcend, [&cut]( auto const* other ) { return other->dominates( cut ); } ) != _pcend;
+    for ( auto mask = detail::subset_signatures( _signs.data(), _size, cut.signature() ); mask; mask &= mask - 1u )
+    {
+      if ( _cuts[_order[__builtin_ctz( mask )]].dominates( cut ) )
+      {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /**
+   * @brief   the cuts that may merge with cut into at most cut_size leaves
+   * @return  the mask of their positions, the others do not merge
+   */
+  uint32_t mergeable(CutType const& cut, uint32_t cut_size) const
+  {
+    return detail::mergeable_signatures( _signs.data(), _size, cut.signature(), cut_size );
+  }
+
+  /**
+   * @brief   whether a cut of signature sign may dominate a cut of the set
+   */
+  bool may_dominate(uint64_t sign) const
+  {
+    return detail::superset_signatures( _signs.data(), _size, sign ) != 0u;
+  }
+
+  /**
+   * @brief   the slot of a cut of the set in the slab, it does not move with the order
+   */
+  uint32_t slot(CutType const& cut) const
+  {
+    return static_cast<uint32_t>( &cut - _cuts.data() );
   }
 
   /**
    * @brief insert a cut in _cuts
    *        the dominates between cut and _cuts[i]  
    *        in a sorted way
+   * @return  the copy of cut in the set, nullptr when the set is full and cut is the last
    */
-  void insert(CutType const& cut)
+  CutType* insert(CutType const& cut)
+  {
+    return insert( cut, []( auto const& c1, auto const& c2 ) { return c1 < c2; } );
+  }
+
+  /**
+   * @brief insert a cut in _cuts, sorted by less instead of operator<
+   */
+  template<typename Less>
+  CutType* insert(CutType const& cut, Less const& less)
   {
     assert(cut.size());
-    _pcend = _pend = std::stable_partition( _pcuts.begin(), _pend, [&cut]( auto const* other ) { return !cut.dominates( *other ); } );
-    auto ipos = std::lower_bound( _pcuts.begin(), _pend, &cut, []( auto a, auto b ) { return *a < *b; } );
+
+    /* the dominated cuts move behind the others, which keep their order */
+    uint32_t last = _size;
+    if ( auto mask = detail::superset_signatures( _signs.data(), _size, cut.signature() ); mask )
+    {
+      std::array<uint8_t, MaxCuts> removed;
+      uint32_t num_removed = 0u;
+      last = 0u;
+      for ( auto i = 0u; i < _size; ++i )
+      {
+        if ( ( mask >> i & 1u ) && cut.dominates( _cuts[_order[i]] ) )
+        {
+          removed[num_removed++] = _order[i];
+          continue;
+        }
+        _signs[last] = _signs[i];
+        _order[last++] = _order[i];
+      }
+      std::copy( removed.begin(), removed.begin() + num_removed, _order.begin() + last );
+    }
+    auto const first = _order.begin();
+    auto ipos = static_cast<uint32_t>( std::lower_bound( first, first + last, cut, [&]( auto slot, auto const& c ) { return less( _cuts[slot], c ); } ) - first );
 
     /* too many cuts, we need to remove one */
-    if ( _pend == _pcuts.end() )
+    if ( last == MaxCuts )
     {
-      if ( ipos == _pend )
+      if ( ipos == last )
       {
-        return;
+        _size = static_cast<uint8_t>( last );
+        return nullptr;
       }
       else
       {
-        --_pend;
-        --_pcend;
+        --last;
       }
     }
 
-    auto& icut = *_pend;
-    icut->set_leaves( cut.begin(), cut.end() );
-    icut->data() = cut.data();
+    auto const slot = _order[last];
+    auto& icut = _cuts[slot];
+    icut.set_leaves( cut.begin(), cut.end() );
+    icut.data() = cut.data();
 
-    if ( ipos != _pend )
+    for ( auto i = last; i > ipos; --i )
     {
-      auto it = _pend;
-      while ( it > ipos )
-      {
-        std::swap( *it, *( it - 1 ) );
-        --it;
-      }
+      _order[i] = _order[i - 1];
+      _signs[i] = _signs[i - 1];
     }
-
-    _pcend++;
-    _pend++;
-    ++_length;
+    _order[ipos] = slot;
+    _signs[ipos] = icut.signature();
+    _size = static_cast<uint8_t>( last + 1 );
+    return &icut;
   }
 
   /**
@@ -183,12 +317,8 @@ public:
    */
   void update_best( uint32_t index)
   {
-    auto* best = _pcuts[index];
-    for ( auto i = index; i > 0; --i )
-    {
-      _pcuts[i] = _pcuts[i - 1];
-    }
-    _pcuts[0] = best;
+    std::rotate( _order.begin(), _order.begin() + index, _order.begin() + index + 1 );
+    std::rotate( _signs.begin(), _signs.begin() + index, _signs.begin() + index + 1 );
   }
 
   /**
@@ -196,10 +326,9 @@ public:
    */
   void limit( uint32_t size)
   {
-    if ( std::distance( _pcuts.begin(), _pend ) > static_cast<long>( size ) )
+    if ( _size > size )
     {
-      _pcend = _pend = _pcuts.begin() + size - 1;
-      _length = size;
+      _size = static_cast<uint8_t>( size - 1 );
     }
   }
 
@@ -208,14 +337,9 @@ public:
    */
   void remove( uint32_t index)
   {
-    auto* bad = _pcuts[index];
-    for (auto i = index; i < size()-1; ++i )
-    {
-      _pcuts[i] = _pcuts[i + 1];
-    }
-    _pcend--;
-    _pend--;
-    _length--;
+    std::rotate( _order.begin() + index, _order.begin() + index + 1, _order.begin() + _size );
+    std::rotate( _signs.begin() + index, _signs.begin() + index + 1, _signs.begin() + _size );
+    --_size;
   }
 
   /**
@@ -223,8 +347,7 @@ public:
    */
   void resize(uint8_t size)
   {
-    _pcend = _pend = _pcuts.begin() + size;
-    _length = size;
+    _size = size;
   }
 
   friend std::ostream& operator<<( std::ostream& os, cut_set const& set )
@@ -237,11 +360,10 @@ public:
   }
 
 private:
-  std::vector<CutType>          _cuts;
-  std::array<CutType*, MaxCuts> _pcuts;
-  uint8_t                       _length{0u};
-  typename std::array<CutType*, MaxCuts>::const_iterator _pcend{_pcuts.begin()};
-  typename std::array<CutType*, MaxCuts>::iterator _pend{_pcuts.begin()};
+  std::vector<CutType>             _cuts;     // the slab of the cuts
+  std::array<uint8_t, MaxCuts>     _order;    // the slots of the cuts in order, then the free slots
+  std::array<uint64_t, ( MaxCuts + detail::signature_block - 1 ) / detail::signature_block * detail::signature_block> _signs{};  // the signatures of the cuts in order
+  uint8_t                          _size{0u};
 };  // end class cut_set
 
 iFPGA_NAMESPACE_HEADER_END
\ No newline at end of file
@@ -0,0 +1,133 @@
+// ***************************************************************************************
+// Copyright (c) 2023-2025 Peng Cheng Laboratory
+// Copyright (c) 2023-2025 Shanghai Anlogic Infotech Co.,Ltd.
+// Copyright (c) 2023-2025 Peking University
+//
+// iMAP-FPGA is licensed under Mulan PSL v2.
+// You can use this software according to the terms and conditions of the Mulan PSL v2.
+// You may obtain a copy of Mulan PSL v2 at:
+// http://license.coscl.org.cn/MulanPSL2
+//
+// THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+// EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+// MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+//
+// See the Mulan PSL v2 for more details.
+// ***************************************************************************************
+
+#pragma once
+#include "utils/ifpga_namespaces.hpp"
+
+#include "kitty/dynamic_truth_table.hpp"
+#include "kitty/detail/constants.hpp"
+
+#include <array>
+#include <cassert>
+#include <cstdint>
+
+iFPGA_NAMESPACE_HEADER_START
+
+/*! \brief The cuts with up to so many leaves keep their function as one word. */
+static constexpr uint32_t max_word_cut_size = 6u;
+
+namespace detail
+{
+
+/*
+ * The function of a cut of at most 6 leaves is a word over 6 variables, leaf i is variable i and
+ * the variables above the cut size are don't cares, so the word is its truth table repeated.
+ */
+
+/**
+ * @brief swaps the variables i < j of a word
+ */
+inline uint64_t swap_word_vars( uint64_t word, uint32_t i, uint32_t j )
+{
+  assert( i < j && j < 6u );
+  auto const up = kitty::detail::projections[i] & kitty::detail::projections_neg[j];
+  auto const down = kitty::detail::projections_neg[i] & kitty::detail::projections[j];
+  auto const shift = ( 1u << j ) - ( 1u << i );
+  return ( word & ~( up | down ) ) | ( ( word & up ) << shift ) | ( ( word & down ) >> shift );
+}
+
+/**
+ * @brief the word of a cut moved onto the leaves of a cut containing it
+ *  the leaves of both cuts are sorted, each variable moves up to the position of its leaf in sup
+ */
+template<typename Cut>
+uint64_t expand_cut_word( uint64_t word, Cut const& sub, Cut const& sup )
+{
+  std::array<uint8_t, max_word_cut_size> support;
+  uint32_t size = 0u;
+  uint8_t pos = 0u;
+  auto itp = sup.begin();
+  for ( auto leaf : sub )
+  {
+    while ( *itp != leaf )
+    {
+      ++itp;
+      ++pos;
+    }
+    support[size++] = pos;
+  }
+
+  for ( auto v = size; v-- > 0u; )
+  {
+    if ( support[v] != v )
+    {
+      word = swap_word_vars( word, v, support[v] );
+    }
+  }
+  return word;
+}
+
+/**
+ * @brief removes the variables a word does not depend on, the others move down in order
+ * @param support the positions of the remaining variables
+ * @return the number of remaining variables
+ */
+inline uint32_t min_base_word( uint64_t& word, uint32_t num_vars, std::array<uint8_t, max_word_cut_size>& support )
+{
+  uint32_t size = 0u;
+  for ( auto v = 0u; v < num_vars; ++v )
+  {
+    if ( ( ( word >> ( 1u << v ) ) ^ word ) & kitty::detail::projections_neg[v] )
+    {
+      if ( size != v )
+      {
+        word = swap_word_vars( word, size, v );
+      }
+      support[size++] = static_cast<uint8_t>( v );
+    }
+  }
+  return size;
+}
+
+/**
+ * @brief the truth table of a word of num_vars variables
+ */
+inline kitty::dynamic_truth_table word_to_truth_table( uint64_t word, uint32_t num_vars )
+{
+  kitty::dynamic_truth_table tt( num_vars );
+  tt._bits[0] = word;
+  tt.mask_bits();
+  return tt;
+}
+
+/**
+ * @brief the word of a truth table of at most 6 variables, repeated over the variables above
+ */
+inline uint64_t truth_table_to_word( kitty::dynamic_truth_table const& tt )
+{
+  assert( tt.num_vars() <= max_word_cut_size );
+  auto word = tt._bits[0];
+  for ( auto v = tt.num_vars(); v < max_word_cut_size; ++v )
+  {
+    word |= word << ( 1u << v );
+  }
+  return word;
+}
+
+} // namespace detail
+
+iFPGA_NAMESPACE_HEADER_END
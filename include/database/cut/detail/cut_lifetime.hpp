@@ -0,0 +1,139 @@
+// ***************************************************************************************
+// Copyright (c) 2023-2025 Peng Cheng Laboratory
+// Copyright (c) 2023-2025 Shanghai Anlogic Infotech Co.,Ltd.
+// Copyright (c) 2023-2025 Peking University
+//
+// iMAP-FPGA is licensed under Mulan PSL v2.
+// You can use this software according to the terms and conditions of the Mulan PSL v2.
+// You may obtain a copy of Mulan PSL v2 at:
+// http://license.coscl.org.cn/MulanPSL2
+//
+// THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+// EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+// MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+//
+// See the Mulan PSL v2 for more details.
+// ***************************************************************************************
+
+#pragma once
+#include "utils/ifpga_namespaces.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+iFPGA_NAMESPACE_HEADER_START
+
+namespace detail
+{
+
+/**
+ * @brief the lifetime of the cut sets in a mapping round
+ *
+ *  the cut set of a node takes a slab from the pool when the node is mapped and gives it back once
+ *  the nodes reading it are mapped, so the live cut sets are those of the topological frontier.
+ *  The cut sets of the nodes that are not mapped, the CIs and the constant, stay.
+ * @tparam NetworkCuts the network_cuts, built without allocation
+ */
+template<typename NetworkCuts>
+class cut_lifetime
+{
+public:
+  using slab_t = std::vector<typename NetworkCuts::cut_t>;
+
+  /**
+   * @brief counts the readers of the cut sets
+   * @param size the number of nodes of the network
+   * @param nodes the mapped nodes, in topological order
+   * @param foreach_dep calls fn( d ) for each node d the cuts of n are computed from
+   */
+  template<typename Nodes, typename Deps>
+  void init( uint32_t size, Nodes const& nodes, Deps&& foreach_dep )
+  {
+    _readers.assign( size, 0u );
+    _mapped.assign( size, 0u );
+    for ( auto const& n : nodes )
+    {
+      _mapped[n] = 1u;
+      foreach_dep( n, [&]( auto const& d ) { ++_readers[d]; } );
+    }
+    _live = _readers;
+  }
+
+  /**
+   * @brief all the readers of the next round are pending
+   */
+  void start_round()
+  {
+    _live = _readers;
+  }
+
+  /**
+   * @brief the cut set of a node takes a slab before its cuts are computed
+   */
+  void acquire( NetworkCuts& cuts, uint32_t index )
+  {
+    auto& set = cuts.cuts( index );
+    if ( set.has_slab() )
+    {
+      return;
+    }
+    if ( _pool.empty() )
+    {
+      set.clear();
+    }
+    else
+    {
+      set.acquire( std::move( _pool.back() ) );
+      _pool.pop_back();
+    }
+    _peak = std::max( _peak, ++_num_live );
+  }
+
+  /**
+   * @brief a node is mapped, the cut sets it was the last reader of return to the pool
+   *  and so does its own one if nothing reads it
+   */
+  template<typename Deps>
+  void release( NetworkCuts& cuts, uint32_t index, Deps&& foreach_dep )
+  {
+    foreach_dep( index, [&]( auto const& d ) {
+      if ( --_live[d] == 0u )
+      {
+        reclaim( cuts, d );
+      }
+    } );
+    if ( _readers[index] == 0u )
+    {
+      reclaim( cuts, index );
+    }
+  }
+
+  /**
+   * @brief the largest number of cut sets holding a slab at once
+   */
+  uint32_t peak() const { return _peak; }
+
+private:
+  void reclaim( NetworkCuts& cuts, uint32_t index )
+  {
+    if ( !_mapped[index] )
+    {
+      return;
+    }
+    _pool.push_back( cuts.cuts( index ).release() );
+    --_num_live;
+  }
+
+private:
+  std::vector<uint32_t> _readers;     // the number of mapped nodes reading the cut set of a node
+  std::vector<uint32_t> _live;        // the readers not yet mapped in the current round
+  std::vector<uint8_t>  _mapped;
+  std::vector<slab_t>   _pool;        // the slabs of the released cut sets
+  uint32_t              _num_live{0u};
+  uint32_t              _peak{0u};
+};
+
+} // namespace detail
+
+iFPGA_NAMESPACE_HEADER_END
@@ -0,0 +1,181 @@
+// ***************************************************************************************
+// Copyright (c) 2023-2025 Peng Cheng Laboratory
+// Copyright (c) 2023-2025 Shanghai Anlogic Infotech Co.,Ltd.
+// Copyright (c) 2023-2025 Peking University
+//
+// iMAP-FPGA is licensed under Mulan PSL v2.
+// You can use this software according to the terms and conditions of the Mulan PSL v2.
+// You may obtain a copy of Mulan PSL v2 at:
+// http://license.coscl.org.cn/MulanPSL2
+//
+// THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+// EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+// MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+//
+// See the Mulan PSL v2 for more details.
+// ***************************************************************************************
+
+#pragma once
+#include "utils/ifpga_namespaces.hpp"
+
+#include <cstdint>
+
+#if defined( __AVX2__ )
+#include <immintrin.h>
+#elif defined( __SSE2__ )
+#include <emmintrin.h>
+#endif
+
+iFPGA_NAMESPACE_HEADER_START
+
+namespace detail
+{
+
+/*
+ * The signatures of the cuts of a cut_set are tested against one cut in a single pass, with AVX2
+ * or SSE2 when the target has them.  Each function returns the mask of the signatures passing the
+ * test, bit i for signs[i]; the array is read in blocks of 4, its size must be a multiple of 4.
+ * A signature sets bit ( leaf & 63 ) of each leaf, the tests are necessary conditions only.
+ */
+
+/*! \brief The number of signatures of a block. */
+static constexpr uint32_t signature_block = 4u;
+
+#if defined( __AVX2__ )
+inline __m256i popcount_epi64( __m256i v )
+{
+  auto const m1 = _mm256_set1_epi8( 0x55 );
+  auto const m2 = _mm256_set1_epi8( 0x33 );
+  auto const m4 = _mm256_set1_epi8( 0x0f );
+  v = _mm256_sub_epi8( v, _mm256_and_si256( _mm256_srli_epi64( v, 1 ), m1 ) );
+  v = _mm256_add_epi8( _mm256_and_si256( v, m2 ), _mm256_and_si256( _mm256_srli_epi64( v, 2 ), m2 ) );
+  v = _mm256_and_si256( _mm256_add_epi8( v, _mm256_srli_epi64( v, 4 ) ), m4 );
+  return _mm256_sad_epu8( v, _mm256_setzero_si256() );
+}
+
+inline uint32_t movemask_epi64( __m256i v )
+{
+  return static_cast<uint32_t>( _mm256_movemask_pd( _mm256_castsi256_pd( v ) ) );
+}
+#elif defined( __SSE2__ )
+inline __m128i popcount_epi64( __m128i v )
+{
+  auto const m1 = _mm_set1_epi8( 0x55 );
+  auto const m2 = _mm_set1_epi8( 0x33 );
+  auto const m4 = _mm_set1_epi8( 0x0f );
+  v = _mm_sub_epi8( v, _mm_and_si128( _mm_srli_epi64( v, 1 ), m1 ) );
+  v = _mm_add_epi8( _mm_and_si128( v, m2 ), _mm_and_si128( _mm_srli_epi64( v, 2 ), m2 ) );
+  v = _mm_and_si128( _mm_add_epi8( v, _mm_srli_epi64( v, 4 ) ), m4 );
+  return _mm_sad_epu8( v, _mm_setzero_si128() );
+}
+
+/* SSE2 has no 64-bit comparison, both halves of a lane must be equal */
+inline __m128i cmpeq_epi64( __m128i a, __m128i b )
+{
+  auto const eq = _mm_cmpeq_epi32( a, b );
+  return _mm_and_si128( eq, _mm_shuffle_epi32( eq, _MM_SHUFFLE( 2, 3, 0, 1 ) ) );
+}
+
+inline uint32_t movemask_epi64( __m128i v )
+{
+  return static_cast<uint32_t>( _mm_movemask_pd( _mm_castsi128_pd( v ) ) );
+}
+#endif
+
+/**
+ * @brief the signatures included in sign, the cuts that may dominate a cut of signature sign
+ */
+inline uint32_t subset_signatures( uint64_t const* signs, uint32_t n, uint64_t sign )
+{
+  uint32_t mask = 0u;
+#if defined( __AVX2__ )
+  auto const q = _mm256_set1_epi64x( static_cast<int64_t>( sign ) );
+  for ( auto i = 0u; i < n; i += 4u )
+  {
+    auto const v = _mm256_loadu_si256( reinterpret_cast<__m256i const*>( signs + i ) );
+    mask |= movemask_epi64( _mm256_cmpeq_epi64( _mm256_and_si256( v, q ), v ) ) << i;
+  }
+#elif defined( __SSE2__ )
+  auto const q = _mm_set1_epi64x( static_cast<int64_t>( sign ) );
+  for ( auto i = 0u; i < n; i += 2u )
+  {
+    auto const v = _mm_loadu_si128( reinterpret_cast<__m128i const*>( signs + i ) );
+    mask |= movemask_epi64( cmpeq_epi64( _mm_and_si128( v, q ), v ) ) << i;
+  }
+#else
+  for ( auto i = 0u; i < n; ++i )
+  {
+    mask |= static_cast<uint32_t>( ( signs[i] & sign ) == signs[i] ) << i;
+  }
+#endif
+  return mask & ( ( 1u << n ) - 1u );
+}
+
+/**
+ * @brief the signatures including sign, the cuts a cut of signature sign may dominate
+ */
+inline uint32_t superset_signatures( uint64_t const* signs, uint32_t n, uint64_t sign )
+{
+  uint32_t mask = 0u;
+#if defined( __AVX2__ )
+  auto const q = _mm256_set1_epi64x( static_cast<int64_t>( sign ) );
+  for ( auto i = 0u; i < n; i += 4u )
+  {
+    auto const v = _mm256_loadu_si256( reinterpret_cast<__m256i const*>( signs + i ) );
+    mask |= movemask_epi64( _mm256_cmpeq_epi64( _mm256_and_si256( v, q ), q ) ) << i;
+  }
+#elif defined( __SSE2__ )
+  auto const q = _mm_set1_epi64x( static_cast<int64_t>( sign ) );
+  for ( auto i = 0u; i < n; i += 2u )
+  {
+    auto const v = _mm_loadu_si128( reinterpret_cast<__m128i const*>( signs + i ) );
+    mask |= movemask_epi64( cmpeq_epi64( _mm_and_si128( v, q ), q ) ) << i;
+  }
+#else
+  for ( auto i = 0u; i < n; ++i )
+  {
+    mask |= static_cast<uint32_t>( ( signs[i] & sign ) == sign ) << i;
+  }
+#endif
+  return mask & ( ( 1u << n ) - 1u );
+}
+
+/**
+ * @brief the signatures whose union with sign has at most cut_size bits, the cuts that may merge
+ *  with a cut of signature sign into a cut of at most cut_size leaves
+ */
+inline uint32_t mergeable_signatures( uint64_t const* signs, uint32_t n, uint64_t sign, uint32_t cut_size )
+{
+  uint32_t mask = 0u;
+#if defined( __AVX2__ )
+  auto const q = _mm256_set1_epi64x( static_cast<int64_t>( sign ) );
+  auto const limit = _mm256_set1_epi64x( static_cast<int64_t>( cut_size ) );
+  for ( auto i = 0u; i < n; i += 4u )
+  {
+    auto const v = _mm256_loadu_si256( reinterpret_cast<__m256i const*>( signs + i ) );
+    auto const count = popcount_epi64( _mm256_or_si256( v, q ) );
+    mask |= ( ~movemask_epi64( _mm256_cmpgt_epi64( count, limit ) ) & 0xfu ) << i;
+  }
+#elif defined( __SSE2__ )
+  auto const q = _mm_set1_epi64x( static_cast<int64_t>( sign ) );
+  auto const limit = _mm_set1_epi32( static_cast<int32_t>( cut_size ) );
+  for ( auto i = 0u; i < n; i += 2u )
+  {
+    auto const v = _mm_loadu_si128( reinterpret_cast<__m128i const*>( signs + i ) );
+    /* the counts are at most 64, the low halves of the lanes compare as 32-bit integers */
+    auto const count = popcount_epi64( _mm_or_si128( v, q ) );
+    auto const over = _mm_shuffle_epi32( _mm_cmpgt_epi32( count, limit ), _MM_SHUFFLE( 2, 2, 0, 0 ) );
+    mask |= ( ~movemask_epi64( over ) & 0x3u ) << i;
+  }
+#else
+  for ( auto i = 0u; i < n; ++i )
+  {
+    mask |= static_cast<uint32_t>( static_cast<uint32_t>( __builtin_popcountll( signs[i] | sign ) ) <= cut_size ) << i;
+  }
+#endif
+  return mask & ( ( 1u << n ) - 1u );
+}
+
+} // namespace detail
+
+iFPGA_NAMESPACE_HEADER_END
@@ -0,0 +1,85 @@
+// ***************************************************************************************
+// Copyright (c) 2023-2025 Peng Cheng Laboratory
+// Copyright (c) 2023-2025 Shanghai Anlogic Infotech Co.,Ltd.
+// Copyright (c) 2023-2025 Peking University
+//
+// iMAP-FPGA is licensed under Mulan PSL v2.
+// You can use this software according to the terms and conditions of the Mulan PSL v2.
+// You may obtain a copy of Mulan PSL v2 at:
+// http://license.coscl.org.cn/MulanPSL2
+//
+// THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+// EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+// MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+//
+// See the Mulan PSL v2 for more details.
+// ***************************************************************************************
+
+#pragma once
+#include "utils/ifpga_namespaces.hpp"
+
+#include <omp.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+iFPGA_NAMESPACE_HEADER_START
+
+namespace detail
+{
+
+/**
+ * @brief groups the nodes by level for the level-parallel cut enumeration
+ *  the cuts of a node only depend on the nodes listed by foreach_dep( n, fn ), which are in lower levels,
+ *  so the nodes of one level can be processed in any order
+ * @param size the number of nodes of the network
+ * @param nodes the nodes to group, in topological order
+ * @param foreach_dep calls fn( d ) for each node d the cuts of n are computed from
+ */
+template<typename Node, typename Nodes, typename Deps>
+std::vector<std::vector<Node>> group_by_level( uint32_t size, Nodes const& nodes, Deps&& foreach_dep )
+{
+  std::vector<uint32_t> levels( size, 0u );
+  std::vector<std::vector<Node>> groups;
+  for ( auto const& n : nodes )
+  {
+    uint32_t level = 0u;
+    foreach_dep( n, [&]( auto const& d ) { level = std::max( level, levels[d] + 1u ); } );
+    levels[n] = level;
+    if ( groups.size() <= level )
+    {
+      groups.resize( level + 1u );
+    }
+    groups[level].push_back( n );
+  }
+  return groups;
+}
+
+/**
+ * @brief computes the cuts of the nodes of one level over the threads
+ *
+ *  merge( n, pool ) computes the cut set of n and interns the new functions in pool, the truth
+ *  table pool of the cuts, which the threads insert into concurrently.  The literals of the new
+ *  functions depend on the order of the inserts, the functions do not; the functions of the
+ *  fanins were interned at lower levels and stay where they are.
+ *  The cuts of at most max_word_cut_size leaves keep their function in the cut.
+ * @param cuts the network_cuts
+ * @param group the nodes of the level
+ * @param num_threads the number of threads
+ */
+template<typename NetworkCuts, typename Node, typename Merge>
+void enumerate_level_parallel( NetworkCuts& cuts, std::vector<Node> const& group, uint32_t num_threads, Merge&& merge )
+{
+  auto& pool = cuts.truth_tables();
+
+#pragma omp parallel for num_threads( num_threads ) schedule( dynamic, 16 )
+  for ( int64_t i = 0; i < static_cast<int64_t>( group.size() ); ++i )
+  {
+    merge( group[i], pool );
+  }
+}
+
+} // namespace detail
+
+iFPGA_NAMESPACE_HEADER_END
@@ -22,106 +22,120 @@
 iFPGA_NAMESPACE_HEADER_START
 static const float_t   gv_eps = 0.005f;       // abc-epsilon
 
-template< bool ComputeTruth>
-bool operator<( cut_type<ComputeTruth, empty_cut_data> const& c1, cut_type<ComputeTruth, empty_cut_data> const& c2 )
+template<int MaxLeaves, bool ComputeTruth>
+bool operator<( cut<MaxLeaves, cut_data<ComputeTruth, empty_cut_data>> const& c1, cut<MaxLeaves, cut_data<ComputeTruth, empty_cut_data>> const& c2 )
 {
   return c1.size() < c2.size();
 }
 
-// template< bool ComputeTruth, ETypeCmp etc, class cut_enum_data = general_cut_data>
-template< bool ComputeTruth>
-bool operator<( cut_type<ComputeTruth, general_cut_data> const& c1, cut_type<ComputeTruth, general_cut_data> const& c2 )
-{  
-  
-  if(gf_get_etc() == ETC_DELAY)
-  {
-    if ( c1->data.delay < c2->data.delay - gv_eps )
-      return true;
-    if ( c1->data.delay > c2->data.delay + gv_eps )
-      return false;
-    if(c1.size() < c2.size())
-      return true;
-    if(c1.size() > c2.size())
-      return false;
-    if ( c1->data.area < c2->data.area - gv_eps )
-      return true;
-    if ( c1->data.area > c2->data.area + gv_eps )
-      return false;
-    if ( c1->data.edge < c2->data.edge - gv_eps )
-      return true;
-    if ( c1->data.edge > c2->data.edge + gv_eps )
-      return false;
-    if ( c1->data.power < c2->data.power - gv_eps )
-      return true;
-    if ( c1->data.power > c2->data.power + gv_eps )
-      return false;
-    if ( c1->data.useless < c2->data.useless )
-      return true;
-    if ( c1->data.useless > c2->data.useless )
-      return false;
-    return false;
-  }
-  else if(gf_get_etc() == ETC_DELAY2)
-  {
-    if ( c1->data.delay < c2->data.delay - gv_eps )
-      return true;
-    if ( c1->data.delay > c2->data.delay + gv_eps )
-      return false;
-    if ( c1->data.useless < c2->data.useless )
-      return true;
-    if ( c1->data.useless > c2->data.useless )
-      return false;
-    if ( c1->data.area < c2->data.area - gv_eps )
-      return true;
-    if ( c1->data.area > c2->data.area + gv_eps )
-      return false;
-    if ( c1->data.edge < c2->data.edge - gv_eps )
-      return true;
-    if ( c1->data.edge > c2->data.edge + gv_eps )
-      return false;
-    if ( c1->data.power < c2->data.power - gv_eps )
-      return true;
-    if ( c1->data.power > c2->data.power + gv_eps )
-      return false;
-    return (c1.size() < c2.size());      
-  }
-  else if(gf_get_etc() == ETC_AREA)
-  {
-    if ( c1->data.area < c2->data.area - gv_eps )
-      return true;
-    if ( c1->data.area > c2->data.area + gv_eps )
-      return false;
-    if ( c1->data.edge < c2->data.edge - gv_eps )
-      return true;
-    if ( c1->data.edge > c2->data.edge + gv_eps )
-      return false;
-    if ( c1->data.power < c2->data.power - gv_eps )
-      return true;
-    if ( c1->data.power > c2->data.power + gv_eps )
-      return false;
-    if ( c1->data.delay < c2->data.delay - gv_eps )
-      return true;
-    if ( c1->data.delay > c2->data.delay + gv_eps )
-      return false;
-    if(c1.size() < c2.size())
-      return true;
-    if(c1.size() > c2.size())
-      return false;
-    if ( c1->data.useless < c2->data.useless )
-      return true;
-    if ( c1->data.useless > c2->data.useless )
-      return false;
-    return false;
-  }
-  else  // default
+/**
+ * @brief orders the cuts of general_cut_data by the sort mode of a mapping round, the mode is
+ *        held by the comparator so that concurrent mappings may sort differently
+ */
+struct general_cut_less
+{
+  ETypeCmp etc{ETC_DELAY};
+
+  template<int MaxLeaves, bool ComputeTruth>
+  bool operator()( cut<MaxLeaves, cut_data<ComputeTruth, general_cut_data>> const& c1, cut<MaxLeaves, cut_data<ComputeTruth, general_cut_data>> const& c2 ) const
   {
-    if ( c1->data.delay < c2->data.delay - gv_eps)
-      return true;
-    if ( c1->data.delay > c2->data.delay + gv_eps)
-      return false;
-    else
-      return c1.size() < c2.size();
+    if(etc == ETC_DELAY)
+    {
+      if ( c1->data.delay < c2->data.delay - gv_eps )
+        return true;
+      if ( c1->data.delay > c2->data.delay + gv_eps )
+        return false;
+      if(c1.size() < c2.size())
+        return true;
+      if(c1.size() > c2.size())
+        return false;
+      if ( c1->data.area < c2->data.area - gv_eps )
+        return true;
+      if ( c1->data.area > c2->data.area + gv_eps )
+        return false;
+      if ( c1->data.edge < c2->data.edge - gv_eps )
+        return true;
+      if ( c1->data.edge > c2->data.edge + gv_eps )
+        return false;
+      if ( c1->data.power < c2->data.power - gv_eps )
+        return true;
+      if ( c1->data.power > c2->data.power + gv_eps )
+        return false;
+      if ( c1->data.useless < c2->data.useless )
+        return true;
+      if ( c1->data.useless > c2->data.useless )
+        return false;
+      return false;
+    }
+    else if(etc == ETC_DELAY2)
+    {
+      if ( c1->data.delay < c2->data.delay - gv_eps )
+        return true;
+      if ( c1->data.delay > c2->data.delay + gv_eps )
+        return false;
+      if ( c1->data.useless < c2->data.useless )
+        return true;
+      if ( c1->data.useless > c2->data.useless )
+        return false;
+      if ( c1->data.area < c2->data.area - gv_eps )
+        return true;
+      if ( c1->data.area > c2->data.area + gv_eps )
+        return false;
+      if ( c1->data.edge < c2->data.edge - gv_eps )
+        return true;
+      if ( c1->data.edge > c2->data.edge + gv_eps )
+        return false;
+      if ( c1->data.power < c2->data.power - gv_eps )
+        return true;
+      if ( c1->data.power > c2->data.power + gv_eps )
+        return false;
+      return (c1.size() < c2.size());      
+    }
+    else if(etc == ETC_AREA)
+    {
+      if ( c1->data.area < c2->data.area - gv_eps )
+        return true;
+      if ( c1->data.area > c2->data.area + gv_eps )
+        return false;
+      if ( c1->data.edge < c2->data.edge - gv_eps )
+        return true;
+      if ( c1->data.edge > c2->data.edge + gv_eps )
+        return false;
+      if ( c1->data.power < c2->data.power - gv_eps )
+        return true;
+      if ( c1->data.power > c2->data.power + gv_eps )
+        return false;
+      if ( c1->data.delay < c2->data.delay - gv_eps )
+        return true;
+      if ( c1->data.delay > c2->data.delay + gv_eps )
+        return false;
+      if(c1.size() < c2.size())
+        return true;
+      if(c1.size() > c2.size())
+        return false;
+      if ( c1->data.useless < c2->data.useless )
+        return true;
+      if ( c1->data.useless > c2->data.useless )
+        return false;
+      return false;
+    }
+    else  // default
+    {
+      if ( c1->data.delay < c2->data.delay - gv_eps)
+        return true;
+      if ( c1->data.delay > c2->data.delay + gv_eps)
+        return false;
+      else
+        return c1.size() < c2.size();
+    }
   }
+};
+
+/* outside of a mapping round, the cuts are sorted by delay */
+template<int MaxLeaves, bool ComputeTruth>
+bool operator<( cut<MaxLeaves, cut_data<ComputeTruth, general_cut_data>> const& c1, cut<MaxLeaves, cut_data<ComputeTruth, general_cut_data>> const& c2 )
+{
+  return general_cut_less{}( c1, c2 );
 }
 
 
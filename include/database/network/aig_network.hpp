@@ -21,6 +21,8 @@
 #include "details/node.hpp"
 #include "details/storage.hpp"
 #include "details/events.hpp"
+#include "details/fanout_index.hpp"
+#include "details/paged_vector.hpp"
 
 #include "utils/range.hpp"
 #include "utils/traits.hpp"
@@ -31,31 +33,73 @@
 
 #include <vector>
 #include <list>
+#include <numeric>
+#include <algorithm>
 #include <stack>
 #include <memory>
 #include <optional>
+#include <array>
+#include <functional>
+#include <utility>
+#include <limits>
 
 iFPGA_NAMESPACE_HEADER_START
 
+/**
+ * @brief the values and the visited marks of the aig nodes, indexed by node
+ *  they live beside the copy-on-write node pages, so a traversal never duplicates a page shared with a snapshot,
+ *  the arrays grow on the first write past their end, a copy of the storage starts without them
+ */
+struct aig_traversal_state
+{
+  aig_traversal_state() = default;
+  aig_traversal_state( aig_traversal_state const& ) {}
+  aig_traversal_state& operator=( aig_traversal_state const& )
+  {
+    values.clear();
+    visited.clear();
+    return *this;
+  }
+
+  std::vector<uint32_t> values;
+  std::vector<uint32_t> visited;
+};
+
 struct aig_storage_data
 {
   uint32_t              num_pis{0u};
   uint32_t              num_pos{0u};
   std::vector<uint32_t> latches{};
-  uint32_t              trav_id{0u};  
+  uint32_t              trav_id{0u};
+  aig_traversal_state   traversal{};
 };
 
 /**
  * @brief aig node
- *        data[0].h1: Fan-out size (we use MSB to indicate whether a node is dead)
- *        data[0].h2: Application-specific value
- *        data[1].h1: Visited flag
- *        data[1].h2: flags
+ *        data[0].fanout: Fan-out size, up to 2^28 - 1
+ *        data[0].flags: phase and marks
+ *        data[0].dead: whether the node is dead
+ *        the values and the visited marks are in aig_traversal_state,
+ *        the strash table keeps 32-bit node indices, as size() does,
+ *        the nodes are kept in copy-on-write pages shared with the snapshots
  */
  
-using aig_storage = storage< fixed_node<2,2>, aig_storage_data >;
+using aig_storage = storage< fixed_node<2, 1, 1, aig_node_state>, aig_storage_data, uint32_t,
+                             paged_vector< fixed_node<2, 1, 1, aig_node_state> > >;
+
+/**
+ * @brief compact aig node, the children are 32-bit literals (31-bit index + complement)
+ *        and the strash table keeps 32-bit indices, so the network is limited to 2^31 nodes
+ */
+using compact_aig_storage = storage< fixed_node<2, 1, 1, aig_node_state, uint32_t>, aig_storage_data, uint32_t,
+                                     paged_vector< fixed_node<2, 1, 1, aig_node_state, uint32_t> > >;
 
-class aig_network
+/**
+ * @brief the and-inverter graph
+ * @tparam AigStorage the node storage, aig_storage or compact_aig_storage
+ */
+template<typename AigStorage = aig_storage>
+class basic_aig_network
 {
 public:
 #pragma region Types and constructors
@@ -63,8 +107,8 @@ public:
   static constexpr auto max_fanin_size = 2u;
 
 
-  using base_type = aig_network;
-  using storage = std::shared_ptr<aig_storage>;
+  using base_type = basic_aig_network;
+  using storage = std::shared_ptr<AigStorage>;
   using node = uint64_t;
   /// redefine NULL for equiv linked list, since 0 means const0 already
   static constexpr node AIG_NULL{0x7FFFFFFFFFFFFFFFu}; 
@@ -84,7 +128,7 @@ public:
     {
     }
 
-    signal( aig_storage::node_type::pointer_type const& p )
+    signal( typename AigStorage::node_type::pointer_type const& p )
         : complement( p.weight ), index( p.index )
     {
     }
@@ -143,13 +187,13 @@ public:
       return data < other.data;
     }
 
-    operator aig_storage::node_type::pointer_type() const
+    operator typename AigStorage::node_type::pointer_type() const
     {
       return {index, complement};
     }
 
 #if __cplusplus > 201703L
-    bool operator==( aig_storage::node_type::pointer_type const& other ) const
+    bool operator==( typename AigStorage::node_type::pointer_type const& other ) const
     {
       return data == other.data;
     }
@@ -157,7 +201,7 @@ public:
   };
 
 
-  /// the flag bit in data[1].h2
+  /// the flag bits in data[0].flags
   enum FLAG_TYPE
   {
     F_PHASE = 0x1,
@@ -165,19 +209,17 @@ public:
     F_MARKB = 0x1 << 2,
 
   };
-  aig_network()
-      : _storage( std::make_shared<aig_storage>() ),
-        _events( std::make_shared<decltype( _events )::element_type>() )
+  basic_aig_network()
+      : _storage( std::make_shared<AigStorage>() )
   {
   }
 
-  aig_network( std::shared_ptr<aig_storage> storage )
-      : _storage( storage ),
-        _events( std::make_shared<decltype( _events )::element_type>() )
+  basic_aig_network( std::shared_ptr<AigStorage> storage )
+      : _storage( storage )
   {
   }
 
-  bool operator==(const aig_network& other) { return _storage == other._storage; }
+  bool operator==(const basic_aig_network& other) { return _storage == other._storage; }
 #pragma endregion
 
 #pragma region Primary I / O and constants
@@ -205,7 +247,7 @@ public:
     (void)name;
 
     /* increase ref-count to children */
-    _storage->nodes[f.index].data[0].h1++;
+    _storage->nodes[f.index].data[0].fanout++;
     auto const po_index = _storage->outputs.size();
     _storage->outputs.emplace_back( f.index, f.complement );
     ++_storage->data.num_pos;
@@ -228,7 +270,7 @@ public:
     (void)name;
 
     /* increase ref-count to children */
-    _storage->nodes[f.index].data[0].h1++;
+    _storage->nodes[f.index].data[0].fanout++;
     auto const ri_index = _storage->outputs.size();
     _storage->outputs.emplace_back( f.index, f.complement );
     _storage->data.latches.emplace_back( reset );
@@ -254,17 +296,17 @@ public:
 
   bool is_ci( node const& n ) const
   {
-    return _storage->nodes[n].children[0].data == _storage->nodes[n].children[1].data;
+    return storage_node( n ).children[0].data == storage_node( n ).children[1].data;
   }
 
   bool is_pi( node const& n ) const
   {
-    return _storage->nodes[n].children[0].data == _storage->nodes[n].children[1].data && _storage->nodes[n].children[0].data < static_cast<uint64_t>(_storage->data.num_pis);
+    return storage_node( n ).children[0].data == storage_node( n ).children[1].data && storage_node( n ).children[0].data < static_cast<uint64_t>(_storage->data.num_pis);
   }
 
   bool is_ro( node const& n ) const
   {
-    return _storage->nodes[n].children[0].data == _storage->nodes[n].children[1].data && _storage->nodes[n].children[0].data >= static_cast<uint64_t>(_storage->data.num_pis);
+    return storage_node( n ).children[0].data == storage_node( n ).children[1].data && storage_node( n ).children[0].data >= static_cast<uint64_t>(_storage->data.num_pis);
   }
 
   bool constant_value( node const& n ) const
@@ -301,11 +343,12 @@ public:
       return true;
     }
 
-    storage::element_type::node_type node;
+    typename AigStorage::node_type node;
     node.children[0] = a;
     node.children[1] = b;
 
     /* structural hashing */
+    refresh_strash();
     uint64_t found = _storage->hash_find(node);
     return found != 0;
   }
@@ -328,11 +371,12 @@ public:
       return a.complement ? b : get_constant( false );
     }
 
-    storage::element_type::node_type node;
+    typename AigStorage::node_type node;
     node.children[0] = a;
     node.children[1] = b;
 
     /* structural hashing */
+    refresh_strash();
     uint64_t found = _storage->hash_find(node);
     if(found)
     {
@@ -341,12 +385,7 @@ public:
     }
 
     const auto index = _storage->nodes.size();
-
-    if ( index >= .9 * _storage->nodes.capacity() )
-    {
-      _storage->nodes.reserve( static_cast<uint64_t>( 3.1415f * index ) );
-      //_storage->reserve( static_cast<uint64_t>( 3.1415f * index ) );
-    }
+    assert( index <= ( std::numeric_limits<typename AigStorage::index_type>::max() >> 1 ) );
 
     _storage->nodes.push_back( node );
     _storage->hash_insert( node, index );
@@ -355,13 +394,15 @@ public:
     phase(index, (phase(a.index) ^ a.complement) & (phase(b.index) ^ b.complement));
 
     /* increase ref-count to children */
-    _storage->nodes[a.index].data[0].h1++;
-    _storage->nodes[b.index].data[0].h1++;
+    _storage->nodes[a.index].data[0].fanout++;
+    _storage->nodes[b.index].data[0].fanout++;
 
-    for ( auto const& fn : _events->on_add )
+    if ( _fanout_index )
     {
-      fn( index );
+      _fanout_index->insert( a.index, index );
+      _fanout_index->insert( b.index, index );
     }
+    _events.add( *this, index );
 
     return {index, 0};
   }
@@ -453,7 +494,7 @@ public:
 #pragma endregion
 
 #pragma region Create arbitrary functions
-  signal clone_node( aig_network const& other, node const& source, std::vector<signal> const& children )
+  signal clone_node( basic_aig_network const& other, node const& source, std::vector<signal> const& children )
   {
     (void)other;
     (void)source;
@@ -465,6 +506,7 @@ public:
 #pragma region Restructuring
   std::optional<std::pair<node, signal>> replace_in_node( node const& n, node const& old_node, signal new_signal )
   {
+    refresh_strash();
     auto& node = _storage->nodes[n];
 
     uint32_t fanin = 0u;
@@ -504,7 +546,7 @@ public:
     }
 
     // node already in hash table
-    storage::element_type::node_type _hash_obj;
+    typename AigStorage::node_type _hash_obj;
     _hash_obj.children[0] = child0;
     _hash_obj.children[1] = child1;
     if(uint64_t found = _storage->hash_find(_hash_obj); found != 0 && found != old_node)
@@ -517,7 +559,7 @@ public:
     const auto old_child1 = signal{node.children[1]};
 
     // erase old node in hash table
-    _storage->hash_erase(node);
+    _storage->hash_erase(node, n);
 
     // insert updated node into hash table
     node.children[0] = child0;
@@ -525,12 +567,9 @@ public:
     _storage->hash_insert(node, n);
 
     // update the reference counter of the new signal
-    _storage->nodes[new_signal.index].data[0].h1++;
+    _storage->nodes[new_signal.index].data[0].fanout++;
 
-    for ( auto const& fn : _events->on_modified )
-    {
-      fn( n, {old_child0, old_child1} );
-    }
+    notify_modified( n, old_child0, old_child1 );
 
     return std::nullopt;
   }
@@ -550,7 +589,7 @@ public:
         if ( old_node != new_signal.index )
         {
           /* increment fan-in of new node */
-          _storage->nodes[new_signal.index].data[0].h1++;
+          _storage->nodes[new_signal.index].data[0].fanout++;
         }
       }
     }
@@ -563,13 +602,21 @@ public:
       return;
 
     /* delete the node (ignoring it's current fanout_size) */
+    refresh_strash();
     auto& nobj = _storage->nodes[n];
-    nobj.data[0].h1 = UINT32_C( 0x80000000 ); /* fanout size 0, but dead */
-    _storage->hash_erase(nobj);
+    nobj.data[0].fanout = 0u; /* fanout size 0, but dead */
+    nobj.data[0].dead = 1u;
+    _storage->hash_erase(nobj, n);
 
-    for ( auto const& fn : _events->on_delete )
+    if ( _fanout_index )
     {
-      fn( n );
+      _fanout_index->erase( nobj.children[0].index, n );
+      _fanout_index->erase( nobj.children[1].index, n );
+    }
+    _events.deleted( *this, n );
+    if ( _on_take_out )
+    {
+      ( *_on_take_out )( n );
     }
 
     /* if the node has been deleted, then deref fanout_size of
@@ -589,7 +636,7 @@ public:
 
   inline bool is_dead( node const& n ) const
   {
-    return ( _storage->nodes[n].data[0].h1 >> 31 ) & 1;
+    return storage_node( n ).data[0].dead;
   }
 
   void substitute_node( node const& old_node, signal const& new_signal )
@@ -602,16 +649,15 @@ public:
       const auto [_old, _new] = to_substitute.top();
       to_substitute.pop();
 
-      for ( auto idx = 1u; idx < _storage->nodes.size(); ++idx )
-      {
+      foreach_fanout_candidate( _old, [&]( node const& idx ) {
         if ( is_ci( idx ) || is_dead( idx ) )
-          continue; /* ignore CIs */
+          return; /* ignore CIs */
 
         if ( const auto repl = replace_in_node( idx, _old, _new ); repl )
         {
           to_substitute.push( *repl );
         }
-      }
+      } );
 
       /* check outputs */
       replace_in_outputs( _old, _new );
@@ -654,9 +700,11 @@ public:
                            std::end( substitutions ) );
     };
 
-    /* register event to delete substitutions if their right-hand side
-       nodes get deleted */
-    _events->on_delete.push_back( clean_substitutions );
+    /* delete substitutions if their right-hand side nodes get deleted,
+       without going through the events which may be disabled */
+    std::function<void( node const& )> const clean_hook = clean_substitutions;
+    auto const* const previous_hook = _on_take_out;
+    _on_take_out = &clean_hook;
 
     /* increment fanout_size of all signals to be used in
        substitutions to ensure that they will not be deleted */
@@ -670,16 +718,15 @@ public:
       auto const [old_node, new_signal] = substitutions.front();
       substitutions.pop_front();
 
-      for ( auto index = 1u; index < _storage->nodes.size(); ++index )
-      {
+      foreach_fanout_candidate( old_node, [&]( node const& index ) {
         /* skip CIs and dead nodes */
         if ( is_ci( index ) || is_dead( index ) )
-          continue;
+          return;
 
         /* skip nodes that will be deleted */
         if ( std::find_if( std::begin( substitutions ), std::end( substitutions ),
                            [&index]( auto s ){ return s.first == index; } ) != std::end( substitutions ) )
-          continue;
+          return;
 
         /* replace in node */
         if ( const auto repl = replace_in_node( index, old_node, new_signal ); repl )
@@ -687,7 +734,7 @@ public:
           incr_fanout_size( get_node( repl->second ) );
           substitutions.emplace_back( *repl );
         }
-      }
+      } );
 
       /* replace in outputs */
       replace_in_outputs( old_node, new_signal );
@@ -713,8 +760,221 @@ public:
       decr_fanout_size( get_node( new_signal ) );
     }
 
-    _events->on_delete.pop_back();
+    _on_take_out = previous_hook;
+  }
+
+  /**
+   * @brief remove the dead and dangling gates in place, the cheap alternative to cleanup_dangling
+   *  the gates reachable from the COs are kept, renumbered in topological order (constant, CIs
+   *  in order, then gates in index order after their fanins) and moved down within the node pages;
+   *  the children, the fanout sizes, the CIs, the COs, the strash table and the fanout index are
+   *  rebuilt on the new indices, no event is emitted for the removed gates
+   * @return the new index of each old node, std::numeric_limits<uint32_t>::max() for the removed ones
+   * @note the node indices kept outside of the network (views, node maps) are invalidated
+   */
+  std::vector<uint32_t> compact()
+  {
+    constexpr uint32_t removed = std::numeric_limits<uint32_t>::max();
+    constexpr uint32_t reached = removed - 1u;
+
+    /* the fanout sizes may be stale after the passes, only the CO cones survive */
+    uint64_t const size = _storage->nodes.size();
+    std::vector<uint32_t> old_to_new( size, removed );
+    std::vector<node> stack;
+    for ( auto const& co : _storage->outputs )
+    {
+      stack.push_back( co.index );
+    }
+    while ( !stack.empty() )
+    {
+      node const n = stack.back();
+      stack.pop_back();
+      if ( old_to_new[n] != removed )
+        continue;
+      old_to_new[n] = reached;
+      if ( n != 0u && !is_ci( n ) )
+      {
+        stack.push_back( storage_node( n ).children[0].index );
+        stack.push_back( storage_node( n ).children[1].index );
+      }
+    }
+
+    /* new indices: the CIs keep their order, a gate is numbered after its fanins */
+    uint32_t next = 0u;
+    old_to_new[0] = next++;
+    for ( auto const& ci : _storage->inputs )
+    {
+      old_to_new[ci] = next++;
+    }
+    for ( node n = 1u; n < size; ++n )
+    {
+      if ( old_to_new[n] != reached )
+        continue;
+
+      /* the children have lower indices unless a substitution moved a node after its fanouts */
+      stack.push_back( n );
+      while ( !stack.empty() )
+      {
+        auto const& nobj = storage_node( stack.back() );
+        if ( old_to_new[nobj.children[0].index] == reached )
+        {
+          stack.push_back( nobj.children[0].index );
+        }
+        else if ( old_to_new[nobj.children[1].index] == reached )
+        {
+          stack.push_back( nobj.children[1].index );
+        }
+        else
+        {
+          old_to_new[stack.back()] = next++;
+          stack.pop_back();
+        }
+      }
+    }
+    uint32_t const num_nodes = next;
+
+    /* complete the permutation with the removed nodes, then apply it cycle by cycle */
+    auto& nodes = _storage->nodes;
+    {
+      std::vector<uint32_t> permutation( old_to_new );
+      for ( node n = 0u; n < size; ++n )
+      {
+        if ( permutation[n] == removed )
+          permutation[n] = next++;
+      }
+
+      std::vector<bool> placed( size, false );
+      for ( node n = 0u; n < size; ++n )
+      {
+        if ( placed[n] || permutation[n] == n )
+          continue;
+
+        auto carry = std::as_const( nodes )[n];
+        for ( node m = permutation[n]; m != n; m = permutation[m] )
+        {
+          std::swap( carry, nodes[m] );
+          placed[m] = true;
+        }
+        nodes[n] = carry;
+        placed[n] = true;
+      }
+    }
+    nodes.truncate( num_nodes );
+
+    /* the traversal state follows the nodes */
+    for ( auto* state : {&_storage->data.traversal.values, &_storage->data.traversal.visited} )
+    {
+      if ( state->empty() )
+        continue;
+      std::vector<uint32_t> renumbered( num_nodes, 0u );
+      for ( node n = 0u; n < std::min<uint64_t>( size, state->size() ); ++n )
+      {
+        if ( old_to_new[n] < num_nodes )
+          renumbered[old_to_new[n]] = ( *state )[n];
+      }
+      state->swap( renumbered );
+    }
+
+    /* renumber the references, the unchanged nodes are not written to keep the pages shared */
+    for ( auto& ci : _storage->inputs )
+    {
+      ci = old_to_new[ci];
+    }
+    std::vector<uint32_t> fanouts( num_nodes, 0u );
+    for ( auto& co : _storage->outputs )
+    {
+      co.index = old_to_new[co.index];
+      ++fanouts[co.index];
+    }
+
+    _storage->hash.clear();
+    _storage->hash_reserve( num_nodes - num_cis() - 1u );
+    _storage->hash_stale = false;
+    for ( node n = num_cis() + 1u; n < num_nodes; ++n )
+    {
+      auto const& nobj = storage_node( n );
+      uint64_t const c0 = old_to_new[nobj.children[0].index];
+      uint64_t const c1 = old_to_new[nobj.children[1].index];
+      if ( c0 != nobj.children[0].index || c1 != nobj.children[1].index )
+      {
+        nodes[n].children[0].index = c0;
+        nodes[n].children[1].index = c1;
+      }
+      ++fanouts[c0];
+      ++fanouts[c1];
+      _storage->hash_insert( storage_node( n ), n );
+    }
+    for ( node n = 0u; n < num_nodes; ++n )
+    {
+      auto const& state = storage_node( n ).data[0];
+      if ( state.fanout != fanouts[n] || state.dead )
+      {
+        nodes[n].data[0].fanout = fanouts[n]; /* also revives the dead gates still in use */
+        nodes[n].data[0].dead = 0u;
+      }
+    }
+
+    if ( _fanout_index )
+    {
+      build_fanout_index();
+    }
+    return old_to_new;
+  }
+
+private:
+  /**
+   * @brief apply fn on the candidate nodes having n as a fanin, in increasing order
+   *  the fanouts of n if the fanout index is enabled, otherwise all the nodes
+   */
+  template<typename Fn>
+  void foreach_fanout_candidate( node const& n, Fn&& fn )
+  {
+    if ( _fanout_index )
+    {
+      /* fn may modify the fanouts of n */
+      std::vector<node> fanouts;
+      _fanout_index->foreach_fanout( n, [&]( auto const& fo ) { fanouts.push_back( fo ); } );
+      std::sort( fanouts.begin(), fanouts.end() );
+      std::for_each( fanouts.begin(), fanouts.end(), fn );
+    }
+    else
+    {
+      for ( node idx = 1u; idx < _storage->nodes.size(); ++idx )
+      {
+        fn( idx );
+      }
+    }
+  }
+
+  /**
+   * @brief read-only access to a node, it keeps the node pages shared with the snapshots
+   */
+  typename AigStorage::node_type const& storage_node( node const& n ) const
+  {
+    return std::as_const( _storage->nodes )[n];
   }
+
+  /**
+   * @brief rebuild the strash table of a snapshot before its first structural change
+   */
+  void refresh_strash()
+  {
+    if ( !_storage->hash_stale )
+      return;
+
+    _storage->hash_stale = false;
+    _storage->hash.clear();
+    _storage->hash_reserve( _storage->stale_hash_size );
+    for ( node n = 1u; n < _storage->nodes.size(); ++n )
+    {
+      if ( !is_ci( n ) && !is_dead( n ) )
+      {
+        _storage->hash_insert( storage_node( n ), n );
+      }
+    }
+  }
+
+public:
 #pragma endregion
 
 #pragma region Structural properties
@@ -774,17 +1034,17 @@ public:
 
   uint32_t fanout_size( node const& n ) const
   {
-    return _storage->nodes[n].data[0].h1 & UINT32_C( 0x7FFFFFFF );
+    return storage_node( n ).data[0].fanout;
   }
 
   uint32_t incr_fanout_size( node const& n ) const
   {
-    return _storage->nodes[n].data[0].h1++ & UINT32_C( 0x7FFFFFFF );  // & avoid overflow
+    return _storage->nodes[n].data[0].fanout++;
   }
 
   uint32_t decr_fanout_size( node const& n ) const
   {
-    return --_storage->nodes[n].data[0].h1 & UINT32_C( 0x7FFFFFFF );
+    return --_storage->nodes[n].data[0].fanout;
   }
 
   bool is_and( node const& n ) const
@@ -915,8 +1175,8 @@ public:
 
   uint32_t ci_index( node const& n ) const
   {
-    assert( _storage->nodes[n].children[0].data == _storage->nodes[n].children[1].data );
-    return static_cast<uint32_t>( _storage->nodes[n].children[0].data );
+    assert( storage_node( n ).children[0].data == storage_node( n ).children[1].data );
+    return static_cast<uint32_t>( storage_node( n ).children[0].data );
   }
 
   uint32_t co_index( signal const& s ) const
@@ -935,10 +1195,10 @@ public:
 
   uint32_t pi_index( node const& n ) const
   {
-    assert( _storage->nodes[n].children[0].data == _storage->nodes[n].children[1].data );
-    assert( _storage->nodes[n].children[0].data < _storage->data.num_pis );
+    assert( storage_node( n ).children[0].data == storage_node( n ).children[1].data );
+    assert( storage_node( n ).children[0].data < _storage->data.num_pis );
 
-    return static_cast<uint32_t>( _storage->nodes[n].children[0].data );
+    return static_cast<uint32_t>( storage_node( n ).children[0].data );
   }
 
   uint32_t po_index( signal const& s ) const
@@ -957,10 +1217,10 @@ public:
 
   uint32_t ro_index( node const& n ) const
   {
-    assert( _storage->nodes[n].children[0].data == _storage->nodes[n].children[1].data );
-    assert( _storage->nodes[n].children[0].data >= _storage->data.num_pis );
+    assert( storage_node( n ).children[0].data == storage_node( n ).children[1].data );
+    assert( storage_node( n ).children[0].data >= _storage->data.num_pis );
 
-    return static_cast<uint32_t>( _storage->nodes[n].children[0].data - _storage->data.num_pis );
+    return static_cast<uint32_t>( storage_node( n ).children[0].data - _storage->data.num_pis );
   }
 
   uint32_t ri_index( signal const& s ) const
@@ -979,7 +1239,7 @@ public:
 
   signal ro_to_ri( signal const& s ) const
   {
-    return *( _storage->outputs.begin() + _storage->data.num_pos + _storage->nodes[s.index].children[0].data - _storage->data.num_pis );
+    return *( _storage->outputs.begin() + _storage->data.num_pos + storage_node( s.index ).children[0].data - _storage->data.num_pis );
   }
 
   node ri_to_ro( signal const& s ) const
@@ -1102,44 +1362,50 @@ public:
     /* we don't use foreach_element here to have better performance */
     if constexpr ( detail::is_callable_without_index_v<Fn, signal, bool> )
     {
-      if ( !fn( signal{_storage->nodes[n].children[0]} ) )
+      if ( !fn( signal{storage_node( n ).children[0]} ) )
         return;
-      fn( signal{_storage->nodes[n].children[1]} );
+      fn( signal{storage_node( n ).children[1]} );
     }
     else if constexpr ( detail::is_callable_with_index_v<Fn, signal, bool> )
     {
-      if ( !fn( signal{_storage->nodes[n].children[0]}, 0 ) )
+      if ( !fn( signal{storage_node( n ).children[0]}, 0 ) )
         return;
-      fn( signal{_storage->nodes[n].children[1]}, 1 );
+      fn( signal{storage_node( n ).children[1]}, 1 );
     }
     else if constexpr ( detail::is_callable_without_index_v<Fn, signal, void> )
     {
-      fn( signal{_storage->nodes[n].children[0]} );
-      fn( signal{_storage->nodes[n].children[1]} );
+      fn( signal{storage_node( n ).children[0]} );
+      fn( signal{storage_node( n ).children[1]} );
     }
     else if constexpr ( detail::is_callable_with_index_v<Fn, signal, void> )
     {
-      fn( signal{_storage->nodes[n].children[0]}, 0 );
-      fn( signal{_storage->nodes[n].children[1]}, 1 );
+      fn( signal{storage_node( n ).children[0]}, 0 );
+      fn( signal{storage_node( n ).children[1]}, 1 );
     }
   }
 
   signal get_child0(node const& p) const
   {
-    return _storage->nodes[p].children[0];
+    return storage_node( p ).children[0];
   }
 
   signal get_child1(node const& p) const
   {
-    return _storage->nodes[p].children[1];
+    return storage_node( p ).children[1];
   }
 
   void set_child0(node& p, signal c) {
+    const auto old_child0 = signal{storage_node( p ).children[0]};
+    const auto old_child1 = signal{storage_node( p ).children[1]};
     _storage->nodes[p].children[0] = c;
+    notify_modified( p, old_child0, old_child1 );
   }
 
   void set_child1(node& p, signal c) {
+    const auto old_child0 = signal{storage_node( p ).children[0]};
+    const auto old_child1 = signal{storage_node( p ).children[1]};
     _storage->nodes[p].children[1] = c;
+    notify_modified( p, old_child0, old_child1 );
   }
 
 
@@ -1158,8 +1424,8 @@ public:
 
     assert( n != 0 && !is_ci( n ) );
 
-    auto const& c1 = _storage->nodes[n].children[0];
-    auto const& c2 = _storage->nodes[n].children[1];
+    auto const& c1 = storage_node( n ).children[0];
+    auto const& c2 = storage_node( n ).children[1];
 
     auto v1 = *begin++;
     auto v2 = *begin++;
@@ -1175,8 +1441,8 @@ public:
 
     assert( n != 0 && !is_ci( n ) );
 
-    auto const& c1 = _storage->nodes[n].children[0];
-    auto const& c2 = _storage->nodes[n].children[1];
+    auto const& c1 = storage_node( n ).children[0];
+    auto const& c2 = storage_node( n ).children[1];
 
     auto tt1 = *begin++;
     auto tt2 = *begin++;
@@ -1193,8 +1459,8 @@ public:
     (void)end;
     assert( n != 0 && !is_ci( n ) );
 
-    auto const& c1 = _storage->nodes[n].children[0];
-    auto const& c2 = _storage->nodes[n].children[1];
+    auto const& c1 = storage_node( n ).children[0];
+    auto const& c2 = storage_node( n ).children[1];
 
     auto tt1 = *begin++;
     auto tt2 = *begin++;
@@ -1213,44 +1479,46 @@ public:
 #pragma region Custom node values
   void clear_values() const
   {
-    std::for_each( _storage->nodes.begin(), _storage->nodes.end(), []( auto& n ) { n.data[0].h2 = 0; } );
+    _storage->data.traversal.values.assign( _storage->nodes.size(), 0u );
   }
 
-  auto value( node const& n ) const
+  uint32_t value( node const& n ) const
   {
-    return _storage->nodes[n].data[0].h2;
+    auto const& values = _storage->data.traversal.values;
+    return n < values.size() ? values[n] : 0u;
   }
 
   void set_value( node const& n, uint32_t v ) const
   {
-    _storage->nodes[n].data[0].h2 = v;
+    traversal_slot( _storage->data.traversal.values, n ) = v;
   }
 
-  auto incr_value( node const& n ) const
+  uint32_t incr_value( node const& n ) const
   {
-    return _storage->nodes[n].data[0].h2++;
+    return traversal_slot( _storage->data.traversal.values, n )++;
   }
 
-  auto decr_value( node const& n ) const
+  uint32_t decr_value( node const& n ) const
   {
-    return --_storage->nodes[n].data[0].h2;
+    return --traversal_slot( _storage->data.traversal.values, n );
   }
 #pragma endregion
 
 #pragma region Visited flags
   void clear_visited() const
   {
-    std::for_each( _storage->nodes.begin(), _storage->nodes.end(), []( auto& n ) { n.data[1].h1 = 0; } );
+    _storage->data.traversal.visited.assign( _storage->nodes.size(), 0u );
   }
 
-  auto visited( node const& n ) const
+  uint32_t visited( node const& n ) const
   {
-    return _storage->nodes[n].data[1].h1;
+    auto const& visited = _storage->data.traversal.visited;
+    return n < visited.size() ? visited[n] : 0u;
   }
 
   void set_visited( node const& n, uint32_t v ) const
   {
-    _storage->nodes[n].data[1].h1 = v;
+    traversal_slot( _storage->data.traversal.visited, n ) = v;
   }
 
   uint32_t trav_id() const
@@ -1262,93 +1530,258 @@ public:
   {
     ++_storage->data.trav_id;
   }
+
+private:
+  /// the entry of n in a traversal array, grown to the network size on the first write past its end
+  uint32_t& traversal_slot( std::vector<uint32_t>& state, node const& n ) const
+  {
+    if ( n >= state.size() )
+    {
+      state.resize( std::max<uint64_t>( n + 1u, _storage->nodes.size() ), 0u );
+    }
+    return state[n];
+  }
+
+public:
 #pragma endregion
 
 #pragma region flags
   bool phase(node const& n) const
   {
-    return _storage->nodes[n].data[1].h2 & F_PHASE; 
+    return storage_node( n ).data[0].flags & F_PHASE; 
   }
 
   void phase(node const& n, bool b)
   {
+    if ( phase( n ) == b )
+      return; /* keep the page shared */
     if(b)
     {
-      _storage->nodes[n].data[1].h2 |= F_PHASE;
+      _storage->nodes[n].data[0].flags |= F_PHASE;
     }
     else
     {
-      _storage->nodes[n].data[1].h2 &= ~F_PHASE;
+      _storage->nodes[n].data[0].flags &= ~F_PHASE;
     }
   }
 
   bool mark_a(node const& n) const
   {
-    return _storage->nodes[n].data[1].h2 & F_MARKA;
+    return storage_node( n ).data[0].flags & F_MARKA;
   }
 
   void mark_a(node const& n, bool b)
   {
+    if ( mark_a( n ) == b )
+      return; /* keep the page shared */
     if(b)
     {
-      _storage->nodes[n].data[1].h2 |= F_MARKA;
+      _storage->nodes[n].data[0].flags |= F_MARKA;
     }
     else
     {
-      _storage->nodes[n].data[1].h2 &= ~F_MARKA;
+      _storage->nodes[n].data[0].flags &= ~F_MARKA;
     }
   }
 
   bool mark_b(node const& n) const
   {
-    return _storage->nodes[n].data[1].h2 & F_MARKB;
+    return storage_node( n ).data[0].flags & F_MARKB;
   }
 
   void mark_b(node const& n, bool b)
   {
+    if ( mark_b( n ) == b )
+      return; /* keep the page shared */
     if(b)
     {
-      _storage->nodes[n].data[1].h2 |= F_MARKB;
+      _storage->nodes[n].data[0].flags |= F_MARKB;
     }
     else
     {
-      _storage->nodes[n].data[1].h2 &= ~F_MARKB;
+      _storage->nodes[n].data[0].flags &= ~F_MARKB;
     }
   }
 
 
 #pragma endregion
 
+#pragma region Fanout index
+  /**
+   * @brief build the fanout index, the network keeps it up to date without going through its events
+   * @note the index is shared by the copies of this network made afterwards, it is updated
+   *  before the event handlers are called so that they can rely on it
+   */
+  void enable_fanout_index()
+  {
+    if ( _fanout_index )
+      return;
+
+    _fanout_index = std::make_shared<fanout_index_type>();
+    build_fanout_index();
+  }
+
+  bool has_fanout_index() const
+  {
+    return _fanout_index != nullptr;
+  }
+
+  /**
+   * @brief stop maintaining the fanout index, the copies made while it was enabled keep their own reference
+   */
+  void disable_fanout_index()
+  {
+    _fanout_index.reset();
+  }
+
+private:
+  /**
+   * @brief update the fanout index after the children of n changed, then call the event handlers
+   */
+  void notify_modified( node const& n, signal const& old_child0, signal const& old_child1 )
+  {
+    if ( _fanout_index )
+    {
+      auto const& nobj = storage_node( n );
+      /* only update the fanins which changed, matching the unchanged ones once */
+      bool kept[2] = {false, false};
+      for ( auto const& s : {old_child0, old_child1} )
+      {
+        auto const i = ( !kept[0] && s.index == nobj.children[0].index ) ? 0u
+                     : ( !kept[1] && s.index == nobj.children[1].index ) ? 1u : 2u;
+        if ( i < 2u )
+          kept[i] = true;
+        else
+          _fanout_index->erase( s.index, n );
+      }
+      for ( auto i = 0u; i < 2u; ++i )
+      {
+        if ( !kept[i] )
+          _fanout_index->insert( nobj.children[i].index, n );
+      }
+    }
+    _events.modified( *this, n, std::array<signal, 2u>{old_child0, old_child1} );
+  }
+
+  void build_fanout_index()
+  {
+    _fanout_index->build( _storage->nodes.size(), [this]( auto&& fn ) {
+      foreach_gate( [&]( auto const& n ) {
+        fn( storage_node( n ).children[0].index, n );
+        fn( storage_node( n ).children[1].index, n );
+      } );
+    } );
+  }
+
+public:
+
+  /**
+   * @brief apply fn on each gate having n as a fanin, fn may return false to stop
+   * @note requires enable_fanout_index(), the order of the fanouts is unspecified
+   */
+  template<typename Fn>
+  void foreach_fanout( node const& n, Fn&& fn ) const
+  {
+    assert( _fanout_index );
+    static_assert( detail::is_callable_without_index_v<Fn, node, bool> ||
+                   detail::is_callable_without_index_v<Fn, node, void> );
+
+    _fanout_index->foreach_fanout( n, [&]( auto const& fo ) { return fn( node( fo ) ); } );
+  }
+#pragma endregion
+
 #pragma region General methods
   auto& events() const
   {
     return *_events;
   }
+
+  /**
+   * @brief a copy of the network sharing the unchanged node pages with this one
+   *  the pages are duplicated by the first side writing to them, so keeping a snapshot
+   *  costs the memory of the pages modified afterwards; the events and the fanout
+   *  index are not carried over
+   */
+  basic_aig_network snapshot() const
+  {
+    return basic_aig_network( _storage->snapshot() );
+  }
 #pragma endregion
 
 public:
-  std::shared_ptr<aig_storage> _storage;
-  std::shared_ptr<network_events<base_type>> _events;
-};  // end class aig_network
+  using fanout_index_type = fanout_index<typename AigStorage::index_type>;
 
-iFPGA_NAMESPACE_HEADER_END
+  std::shared_ptr<AigStorage> _storage;
+  network_event_dispatcher<base_type> _events;
+  std::shared_ptr<fanout_index_type> _fanout_index;
 
+private:
+  std::function<void( node const& )> const* _on_take_out{nullptr}; ///< the cleanup of substitute_nodes
+};  // end class basic_aig_network
 
-namespace std
+using aig_network         = basic_aig_network<aig_storage>;
+using compact_aig_network = basic_aig_network<compact_aig_storage>;
+
+/**
+ * @brief the hash of an aig signal, shared by all the storage layouts
+ */
+template<typename AigStorage>
+struct aig_signal_hash
 {
-  template<>  // 模板特例化
-  struct hash< iFPGA_NAMESPACE::aig_network::signal >
+  uint64_t operator() ( typename basic_aig_network<AigStorage>::signal const& s) const noexcept
+  {
+    uint64_t k = s.data;
+    k ^= k >> 33;
+    k *= 0xff51afd7ed558ccd;
+    k ^= k >> 33;
+    k *= 0xc4ceb9fe1a85ec53;
+    k ^= k >> 33;
+    return k;
+  }
+};  // end struct aig_signal_hash
+
+/**
+ * @brief enables the fanout index of a network for the lifetime of the scope
+ *  the index is disabled on exit unless the network already had it, so a pass leaves the network as it got it
+ */
+template<typename Ntk>
+class fanout_index_scope
+{
+public:
+  explicit fanout_index_scope( Ntk& ntk )
+      : _ntk( ntk ),
+        _owned( !ntk.has_fanout_index() )
+  {
+    _ntk.enable_fanout_index();
+  }
+
+  ~fanout_index_scope()
   {
-    uint64_t operator() ( iFPGA_NAMESPACE::aig_network::signal const& s) const noexcept
+    if ( _owned )
     {
-      uint64_t k = s.data;
-      k ^= k >> 33;
-      k *= 0xff51afd7ed558ccd;
-      k ^= k >> 33;
-      k *= 0xc4ceb9fe1a85ec53;
-      k ^= k >> 33;
-      return k;
+      _ntk.disable_fanout_index();
     }
-  };  // end struct hash
+  }
+
+  fanout_index_scope( fanout_index_scope const& ) = delete;
+  fanout_index_scope& operator=( fanout_index_scope const& ) = delete;
+
+private:
+  Ntk& _ntk;
+  bool _owned;
+};  // end class fanout_index_scope
+
+iFPGA_NAMESPACE_HEADER_END
+
+
+namespace std
+{
+  template<>  // 模板特例化
+  struct hash< iFPGA_NAMESPACE::aig_network::signal > : iFPGA_NAMESPACE::aig_signal_hash< iFPGA_NAMESPACE::aig_storage >
+  { };
+
+  template<>
+  struct hash< iFPGA_NAMESPACE::compact_aig_network::signal > : iFPGA_NAMESPACE::aig_signal_hash< iFPGA_NAMESPACE::compact_aig_storage >
+  { };
 
 } // end namespace std
@@ -20,6 +20,9 @@
 #include "utils/common_properties.hpp"
 #include <vector>
 #include <functional>
+#include <iterator>
+#include <memory>
+#include <type_traits>
 
 iFPGA_NAMESPACE_HEADER_START
 
@@ -35,4 +38,59 @@ struct network_events
 
 };  // end struct network_events
 
-iFPGA_NAMESPACE_HEADER_END
\ No newline at end of file
+/**
+ * @brief calls the handlers registered in the network_events of a network
+ *  the network calls add( ntk, n ), modified( ntk, n, previous_children ) and deleted( ntk, n ),
+ *  previous_children is any range of signals, copied only when on_modified has handlers;
+ *  the handlers are shared by the copies of the network
+ * @note the methods are templates, the network type is incomplete where its dispatcher is declared
+ */
+template<typename Ntk>
+class network_event_dispatcher
+{
+public:
+  network_event_dispatcher()
+      : _events( std::make_shared<network_events<Ntk>>() )
+  {
+  }
+
+  network_events<Ntk>* operator->() const { return _events.get(); }
+  network_events<Ntk>& operator*() const { return *_events; }
+
+  template<typename Node>
+  void add( Ntk const&, Node const& n ) const
+  {
+    for ( auto const& fn : _events->on_add )
+    {
+      fn( n );
+    }
+  }
+
+  template<typename Node, typename Range>
+  void modified( Ntk const&, Node const& n, Range const& previous ) const
+  {
+    if ( _events->on_modified.empty() )
+      return;
+
+    using signal_type = std::decay_t<decltype( *std::begin( previous ) )>;
+    std::vector<signal_type> const children( std::begin( previous ), std::end( previous ) );
+    for ( auto const& fn : _events->on_modified )
+    {
+      fn( n, children );
+    }
+  }
+
+  template<typename Node>
+  void deleted( Ntk const&, Node const& n ) const
+  {
+    for ( auto const& fn : _events->on_delete )
+    {
+      fn( n );
+    }
+  }
+
+private:
+  std::shared_ptr<network_events<Ntk>> _events;
+};  // end class network_event_dispatcher
+
+iFPGA_NAMESPACE_HEADER_END
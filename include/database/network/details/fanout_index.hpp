@@ -0,0 +1,267 @@
+// ***************************************************************************************
+// Copyright (c) 2023-2025 Peng Cheng Laboratory
+// Copyright (c) 2023-2025 Shanghai Anlogic Infotech Co.,Ltd.
+// Copyright (c) 2023-2025 Peking University
+//
+// iMAP-FPGA is licensed under Mulan PSL v2.
+// You can use this software according to the terms and conditions of the Mulan PSL v2.
+// You may obtain a copy of Mulan PSL v2 at:
+// http://license.coscl.org.cn/MulanPSL2
+//
+// THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+// EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+// MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+//
+// See the Mulan PSL v2 for more details.
+// ***************************************************************************************
+
+#pragma once
+
+#include <stdint.h>
+#include <vector>
+#include <algorithm>
+#include <type_traits>
+#include <cassert>
+
+#include "utils/ifpga_namespaces.hpp"
+iFPGA_NAMESPACE_HEADER_START
+
+/**
+ * @brief the fanout lists of all nodes of a network
+ *  - the lists are stored as compressed sparse rows, built in one pass over the fanins
+ *  - a fanout added to a full row goes to the overflow area, a linked list per node
+ *  - a fanout removed from a row is refilled by the overflow head, so the rows stay dense
+ *  - the rows are rebuilt once the overflow area grows as large as the rows
+ * @tparam Index the node index type
+ */
+template<typename Index = uint32_t>
+class fanout_index
+{
+public:
+  using index_type = Index;
+
+  /**
+   * @brief build the rows from scratch
+   * @param num_nodes the number of nodes of the network
+   * @param foreach_edge foreach_edge(fn) calls fn(fanin, fanout) for each fanin of each live gate, in node order
+   */
+  template<typename EdgeFn>
+  void build( uint64_t num_nodes, EdgeFn&& foreach_edge )
+  {
+    clear();
+    _rows.resize( num_nodes );
+    foreach_edge( [&]( uint64_t fanin, uint64_t ) { ++_rows[fanin].capacity; } );
+
+    uint32_t begin = 0u;
+    for ( auto& r : _rows )
+    {
+      r.begin = begin;
+      begin += r.capacity;
+    }
+    _csr.resize( begin );
+    foreach_edge( [&]( uint64_t fanin, uint64_t fanout ) {
+      auto& r = _rows[fanin];
+      _csr[r.begin + r.size++] = static_cast<Index>( fanout );
+    } );
+  }
+
+  void clear()
+  {
+    std::vector<row>().swap( _rows );
+    std::vector<Index>().swap( _csr );
+    _links.assign( 1u, link{} ); /* link 0 ends the overflow lists */
+    _free = 0u;
+    _num_links = 0u;
+  }
+
+  /**
+   * @brief add fanout to the list of node fanin
+   */
+  void insert( uint64_t fanin, uint64_t fanout )
+  {
+    if ( fanin >= _rows.size() )
+    {
+      _rows.resize( fanin + 1u, row{static_cast<uint32_t>( _csr.size() ), 0u, 0u, 0u} );
+    }
+
+    auto& r = _rows[fanin];
+    if ( r.size < r.capacity )
+    {
+      _csr[r.begin + r.size++] = static_cast<Index>( fanout );
+      return;
+    }
+
+    uint32_t const l = alloc_link();
+    _links[l].fanout = static_cast<Index>( fanout );
+    _links[l].next = r.overflow;
+    r.overflow = l;
+    ++_num_links;
+
+    if ( _num_links > std::max<uint64_t>( _csr.size(), MIN_OVERFLOW ) )
+    {
+      compact();
+    }
+  }
+
+  /**
+   * @brief remove fanout from the list of node fanin
+   * @return false if fanout is not in the list
+   */
+  bool erase( uint64_t fanin, uint64_t fanout )
+  {
+    if ( fanin >= _rows.size() )
+      return false;
+
+    auto& r = _rows[fanin];
+    Index* const first = _csr.data() + r.begin;
+    for ( uint32_t i = 0u; i < r.size; ++i )
+    {
+      if ( first[i] != fanout )
+        continue;
+
+      if ( r.overflow != 0u )
+      {
+        /* refill the hole from the overflow area */
+        uint32_t const l = r.overflow;
+        first[i] = _links[l].fanout;
+        r.overflow = _links[l].next;
+        free_link( l );
+      }
+      else
+      {
+        first[i] = first[--r.size];
+      }
+      return true;
+    }
+
+    for ( uint32_t* prev = &r.overflow; *prev != 0u; prev = &_links[*prev].next )
+    {
+      uint32_t const l = *prev;
+      if ( _links[l].fanout == fanout )
+      {
+        *prev = _links[l].next;
+        free_link( l );
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /**
+   * @brief apply fn on each fanout of node n, fn may return false to stop
+   */
+  template<typename Fn>
+  void foreach_fanout( uint64_t n, Fn&& fn ) const
+  {
+    if ( n >= _rows.size() )
+      return;
+
+    auto const& r = _rows[n];
+    for ( Index const* it = _csr.data() + r.begin, *end = it + r.size; it != end; ++it )
+    {
+      if constexpr ( std::is_same_v<std::invoke_result_t<Fn, Index>, bool> )
+      {
+        if ( !fn( *it ) )
+          return;
+      }
+      else
+      {
+        fn( *it );
+      }
+    }
+    for ( uint32_t l = r.overflow; l != 0u; l = _links[l].next )
+    {
+      if constexpr ( std::is_same_v<std::invoke_result_t<Fn, Index>, bool> )
+      {
+        if ( !fn( _links[l].fanout ) )
+          return;
+      }
+      else
+      {
+        fn( _links[l].fanout );
+      }
+    }
+  }
+
+  /// the number of fanouts in the list of node n
+  uint32_t fanout_count( uint64_t n ) const
+  {
+    if ( n >= _rows.size() )
+      return 0u;
+    uint32_t count = _rows[n].size;
+    for ( uint32_t l = _rows[n].overflow; l != 0u; l = _links[l].next )
+      ++count;
+    return count;
+  }
+
+  /// the number of fanouts kept in the overflow area
+  uint64_t overflow_size() const { return _num_links; }
+
+  /**
+   * @brief rebuild the rows with the overflow lists merged in
+   */
+  void compact()
+  {
+    std::vector<Index> csr;
+    csr.reserve( _csr.size() + _num_links );
+    for ( auto& r : _rows )
+    {
+      uint32_t const begin = static_cast<uint32_t>( csr.size() );
+      csr.insert( csr.end(), _csr.begin() + r.begin, _csr.begin() + r.begin + r.size );
+      for ( uint32_t l = r.overflow; l != 0u; l = _links[l].next )
+        csr.push_back( _links[l].fanout );
+      r.begin = begin;
+      r.size = r.capacity = static_cast<uint32_t>( csr.size() ) - begin;
+      r.overflow = 0u;
+    }
+    _csr.swap( csr );
+    _links.assign( 1u, link{} );
+    _free = 0u;
+    _num_links = 0u;
+  }
+
+private:
+  static constexpr uint64_t MIN_OVERFLOW = 1024u;
+
+  struct row
+  {
+    uint32_t begin{0u};     ///< the first fanout in the rows
+    uint32_t size{0u};      ///< the number of fanouts in the rows
+    uint32_t capacity{0u};  ///< the room of the node in the rows
+    uint32_t overflow{0u};  ///< the head link of the overflow list
+  };
+
+  struct link
+  {
+    Index    fanout{0};
+    uint32_t next{0u};
+  };
+
+  uint32_t alloc_link()
+  {
+    if ( _free != 0u )
+    {
+      uint32_t const l = _free;
+      _free = _links[l].next;
+      return l;
+    }
+    _links.emplace_back();
+    return static_cast<uint32_t>( _links.size() - 1u );
+  }
+
+  void free_link( uint32_t l )
+  {
+    _links[l].next = _free;
+    _free = l;
+    --_num_links;
+  }
+
+private:
+  std::vector<row>   _rows;
+  std::vector<Index> _csr;
+  std::vector<link>  _links{1u};  ///< the overflow area, link 0 is the list end
+  uint32_t           _free{0u};   ///< the head of the free links
+  uint64_t           _num_links{0u};
+};  // end class fanout_index
+
+iFPGA_NAMESPACE_HEADER_END
@@ -26,45 +26,51 @@ iFPGA_NAMESPACE_HEADER_START
 
 /**
  * @brief the pointer of a node with a weight on the first bit
+ * @tparam W the word holding weight and index, uint64_t by default,
+ *         uint32_t for the compact 32-bit literal layout
  */
-template<int PointerFieldSize = 0>
+template<int PointerFieldSize = 0, typename W = uint64_t>
 struct node_pointer
 {
 private:
-  static constexpr auto _len = sizeof( uint64_t ) * 8;
+  static constexpr auto _len = sizeof( W ) * 8;
 
 public:
+  using word_type = W;
+
   node_pointer() = default;
   node_pointer( uint64_t index, uint64_t weight ) : weight( weight ), index( index ) {}
 
   union {
     struct
     {
-      uint64_t weight : PointerFieldSize;
-      uint64_t index : _len - PointerFieldSize;
+      W weight : PointerFieldSize;
+      W index : _len - PointerFieldSize;
     };
-    uint64_t data;
+    W data;
   };
 
-  bool operator==( node_pointer<PointerFieldSize> const& other ) const
+  bool operator==( node_pointer<PointerFieldSize, W> const& other ) const
   {
     return data == other.data;
   }
 };
 
-template<>
-struct node_pointer<0>
+template<typename W>
+struct node_pointer<0, W>
 {
 public:
-  node_pointer<0>() = default;
-  node_pointer<0>( uint64_t index ) : index( index ) {}
+  using word_type = W;
+
+  node_pointer() = default;
+  node_pointer( uint64_t index ) : index( index ) {}
 
   union {
-    uint64_t index;
-    uint64_t data;
+    W index;
+    W data;
   };
 
-  bool operator==( node_pointer<0> const& other ) const
+  bool operator==( node_pointer<0, W> const& other ) const
   {
     return data == other.data;
   }
@@ -84,18 +90,34 @@ union node_state {
   uint64_t n{0};
 };
 
+/**
+ * @brief the 32-bit state of an aig node, the values and the visited marks are kept beside the nodes
+ *  (fanout size, flags, dead mark)
+ */
+union aig_node_state {
+  struct
+  {
+    uint32_t fanout : 28;
+    uint32_t flags : 3;
+    uint32_t dead : 1;
+  };
+  uint32_t n{0};
+};
+
 /**
  * @brief the node's fanin and size are fixed
+ * @tparam W the word of the children pointers,
+ *         uint32_t gives the compact layout limited to 2^31 nodes
  */
-template<int Fanin ,int StateSize , int PointerFieldSize = 1, typename T=node_state>
+template<int Fanin ,int StateSize , int PointerFieldSize = 1, typename T=node_state, typename W = uint64_t>
 struct fixed_node
 {
-  using pointer_type = node_pointer<PointerFieldSize>;
+  using pointer_type = node_pointer<PointerFieldSize, W>;
+  using index_type   = W;
   std::array< pointer_type, Fanin >       children;
   std::array< T, StateSize >     data;         // the state of the node
-  uint64_t next{0};                        // the linked list in hash table
 
-  bool operator==(fixed_node<Fanin, StateSize, PointerFieldSize, T> const& other) const
+  bool operator==(fixed_node<Fanin, StateSize, PointerFieldSize, T, W> const& other) const
   {
     return children == other.children;
   }               
@@ -116,5 +138,23 @@ struct mixed_node
   }
 };
 
+/**
+ * @brief the unfixed fanins type of a node without its own allocation
+ *  up to Inline fanins are stored in the node, the larger fanin lists in a pool of the storage,
+ *  children[0] is then their offset in the pool
+ */
+template<int Inline, int StateSize, typename T=node_state>
+struct pooled_node
+{
+  using pointer_type = node_pointer<0>;
+  static constexpr uint32_t max_inline_fanin = Inline;
+
+  std::array< uint32_t, Inline >        children{};
+  uint32_t                              num_children{0};
+  std::array< T, StateSize >            data;
+
+  bool is_pooled() const { return num_children > Inline; }
+};
+
 iFPGA_NAMESPACE_HEADER_END
 
@@ -0,0 +1,399 @@
+// ***************************************************************************************
+// Copyright (c) 2023-2025 Peng Cheng Laboratory
+// Copyright (c) 2023-2025 Shanghai Anlogic Infotech Co.,Ltd.
+// Copyright (c) 2023-2025 Peking University
+//
+// iMAP-FPGA is licensed under Mulan PSL v2.
+// You can use this software according to the terms and conditions of the Mulan PSL v2.
+// You may obtain a copy of Mulan PSL v2 at:
+// http://license.coscl.org.cn/MulanPSL2
+//
+// THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+// EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+// MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+//
+// See the Mulan PSL v2 for more details.
+// ***************************************************************************************
+
+#pragma once
+
+#include <stdint.h>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <iterator>
+#include <algorithm>
+#include <new>
+#include <type_traits>
+#include <cassert>
+
+#include "utils/ifpga_namespaces.hpp"
+iFPGA_NAMESPACE_HEADER_START
+
+/**
+ * @brief a vector of pages shared copy-on-write between its copies
+ *  - the first pages grow geometrically from 64 elements up to the page size, the next ones all have the page size,
+ *    so a small vector stays small and a large one grows without relocating or copying its elements
+ *  - copying the vector only shares the pages, each page keeps the number of vectors using it
+ *  - the mutable accessors duplicate a shared page before handing out a reference,
+ *    the const accessors never do, so reading a copy costs no memory
+ *  - the elements never move, a reference stays valid until the page is duplicated
+ *  - the unsharing is safe against concurrent mutable accesses, growing the vector is not
+ * @tparam T the trivially copyable element type
+ * @tparam PageBits the log2 of the number of elements per full page
+ */
+template<typename T, uint32_t PageBits = 12u>
+class paged_vector
+{
+  static_assert( std::is_trivially_copyable_v<T>, "the pages are copied and released as raw memory" );
+
+public:
+  static constexpr uint64_t PAGE_SIZE = uint64_t( 1u ) << PageBits;
+
+  using value_type = T;
+  using size_type  = uint64_t;
+  using reference  = T&;
+  using const_reference = T const&;
+
+  template<bool Const>
+  class basic_iterator
+  {
+  public:
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type        = T;
+    using difference_type   = std::ptrdiff_t;
+    using pointer           = std::conditional_t<Const, T const*, T*>;
+    using reference         = std::conditional_t<Const, T const&, T&>;
+    using container         = std::conditional_t<Const, paged_vector const, paged_vector>;
+
+    basic_iterator() = default;
+    basic_iterator( container* v, uint64_t i ) : _v( v ), _i( i ) {}
+
+    reference operator*() const { return ( *_v )[_i]; }
+    pointer operator->() const { return &( *_v )[_i]; }
+    reference operator[]( difference_type n ) const { return ( *_v )[_i + n]; }
+
+    basic_iterator& operator++() { ++_i; return *this; }
+    basic_iterator operator++( int ) { auto it = *this; ++_i; return it; }
+    basic_iterator& operator--() { --_i; return *this; }
+    basic_iterator operator--( int ) { auto it = *this; --_i; return it; }
+    basic_iterator& operator+=( difference_type n ) { _i += n; return *this; }
+    basic_iterator& operator-=( difference_type n ) { _i -= n; return *this; }
+    basic_iterator operator+( difference_type n ) const { return {_v, _i + n}; }
+    basic_iterator operator-( difference_type n ) const { return {_v, _i - n}; }
+    difference_type operator-( basic_iterator const& other ) const { return difference_type( _i ) - difference_type( other._i ); }
+
+    bool operator==( basic_iterator const& other ) const { return _i == other._i; }
+    bool operator!=( basic_iterator const& other ) const { return _i != other._i; }
+    bool operator<( basic_iterator const& other ) const { return _i < other._i; }
+
+  private:
+    container* _v{nullptr};
+    uint64_t   _i{0u};
+  };
+
+  using iterator       = basic_iterator<false>;
+  using const_iterator = basic_iterator<true>;
+
+  paged_vector() = default;
+
+  paged_vector( paged_vector const& other )
+  {
+    share( other );
+  }
+
+  paged_vector& operator=( paged_vector const& other )
+  {
+    if ( this != &other )
+    {
+      clear();
+      share( other );
+    }
+    return *this;
+  }
+
+  paged_vector( paged_vector&& other ) noexcept
+  {
+    swap( other );
+  }
+
+  paged_vector& operator=( paged_vector&& other ) noexcept
+  {
+    if ( this != &other )
+    {
+      clear();
+      swap( other );
+    }
+    return *this;
+  }
+
+  void swap( paged_vector& other ) noexcept
+  {
+    _table.swap( other._table );
+    std::swap( _num_pages, other._num_pages );
+    std::swap( _table_capacity, other._table_capacity );
+    std::swap( _size, other._size );
+  }
+
+  ~paged_vector()
+  {
+    clear();
+  }
+
+  uint64_t size() const { return _size; }
+  bool empty() const { return _size == 0u; }
+  uint64_t capacity() const { return page_begin( _num_pages ); }
+  uint64_t num_pages() const { return _num_pages; }
+
+  /// the number of pages shared with other copies
+  uint64_t num_shared_pages() const
+  {
+    uint64_t count = 0u;
+    for ( uint64_t p = 0u; p < _num_pages; ++p )
+    {
+      count += ( _table[p].load( std::memory_order_relaxed ) & SHARED ) != 0u;
+    }
+    return count;
+  }
+
+  T const& operator[]( uint64_t i ) const
+  {
+    assert( i < _size );
+    auto const [p, offset] = locate( i );
+    return items_of( page_of( _table[p].load( std::memory_order_acquire ) ) )[offset];
+  }
+
+  T& operator[]( uint64_t i )
+  {
+    assert( i < _size );
+    auto const [p, offset] = locate( i );
+    uintptr_t e = _table[p].load( std::memory_order_acquire );
+    if ( e & SHARED )
+    {
+      e = unshare( p );
+    }
+    return items_of( page_of( e ) )[offset];
+  }
+
+  T const& back() const { return ( *this )[_size - 1u]; }
+  T& back() { return ( *this )[_size - 1u]; }
+
+  void push_back( T const& value )
+  {
+    emplace_back() = value;
+  }
+
+  /// append a value-initialized element
+  T& emplace_back()
+  {
+    if ( _size == capacity() )
+    {
+      add_page();
+    }
+    auto& e = ( *this )[_size++];
+    e = T{};
+    return e;
+  }
+
+  /// reserve the page table, pages are only allocated when filled
+  void reserve( uint64_t n )
+  {
+    if ( n != 0u )
+    {
+      reserve_table( locate( n - 1u ).first + 1u );
+    }
+  }
+
+  /// drop the elements from n on, the pages past the new end are released
+  void truncate( uint64_t n )
+  {
+    if ( n >= _size )
+      return;
+    uint64_t const num_pages = n == 0u ? 0u : locate( n - 1u ).first + 1u;
+    for ( uint64_t p = num_pages; p < _num_pages; ++p )
+    {
+      release( page_of( _table[p].load( std::memory_order_relaxed ) ) );
+    }
+    _num_pages = num_pages;
+    _size = n;
+  }
+
+  void clear()
+  {
+    for ( uint64_t p = 0u; p < _num_pages; ++p )
+    {
+      release( page_of( _table[p].load( std::memory_order_relaxed ) ) );
+    }
+    _num_pages = 0u;
+    _size = 0u;
+  }
+
+  /**
+   * @brief apply fn on each element as a mutable reference, one page at a time
+   *  much cheaper than the iterators for sweeping the whole vector
+   */
+  template<typename Fn>
+  void foreach_item( Fn&& fn )
+  {
+    for ( uint64_t p = 0u; p < _num_pages; ++p )
+    {
+      uintptr_t e = _table[p].load( std::memory_order_acquire );
+      if ( e & SHARED )
+      {
+        e = unshare( p );
+      }
+      T* const first = items_of( page_of( e ) );
+      T* const last  = first + std::min<uint64_t>( page_size( p ), _size - page_begin( p ) );
+      std::for_each( first, last, fn );
+    }
+  }
+
+  iterator begin() { return {this, 0u}; }
+  iterator end() { return {this, _size}; }
+  const_iterator begin() const { return {this, 0u}; }
+  const_iterator end() const { return {this, _size}; }
+
+private:
+  static constexpr uint64_t  MASK       = PAGE_SIZE - 1u;
+  static constexpr uint32_t  FIRST_BITS = std::min<uint32_t>( PageBits, 6u );  ///< the log2 of the size of the first page
+  static constexpr uint64_t  NUM_SMALL  = PageBits - FIRST_BITS + 1u;          ///< the number of pages before the first full one
+  static constexpr uintptr_t SHARED     = 1u;  ///< the tag of a page slot whose page may be used by another copy
+
+  /// the page header, the elements follow it in the same allocation
+  struct page
+  {
+    std::atomic<uint32_t> refs{1u};
+  };
+
+  static constexpr uint64_t ITEMS_OFFSET = ( sizeof( page ) + alignof( T ) - 1u ) / alignof( T ) * alignof( T );
+
+  /// the page and the offset in the page of element i
+  static std::pair<uint64_t, uint64_t> locate( uint64_t i )
+  {
+    if ( i >= PAGE_SIZE )
+    {
+      return {( i >> PageBits ) + NUM_SMALL - 1u, i & MASK};
+    }
+    if ( i < ( uint64_t( 1u ) << FIRST_BITS ) )
+    {
+      return {0u, i};
+    }
+    uint32_t const bits = 63u - static_cast<uint32_t>( __builtin_clzll( i ) );
+    return {bits - FIRST_BITS + 1u, i - ( uint64_t( 1u ) << bits )};
+  }
+
+  /// the index of the first element of page p
+  static uint64_t page_begin( uint64_t p )
+  {
+    if ( p >= NUM_SMALL )
+    {
+      return ( p - NUM_SMALL + 1u ) << PageBits;
+    }
+    return p == 0u ? 0u : uint64_t( 1u ) << ( FIRST_BITS + p - 1u );
+  }
+
+  static uint64_t page_size( uint64_t p )
+  {
+    return p >= NUM_SMALL ? PAGE_SIZE : uint64_t( 1u ) << ( FIRST_BITS + ( p == 0u ? 0u : p - 1u ) );
+  }
+
+  static page* page_of( uintptr_t e )
+  {
+    return reinterpret_cast<page*>( e & ~SHARED );
+  }
+
+  static T* items_of( page* p )
+  {
+    return reinterpret_cast<T*>( reinterpret_cast<char*>( p ) + ITEMS_OFFSET );
+  }
+
+  /// a page of n value-initialized elements
+  static page* new_page( uint64_t n )
+  {
+    page* const p = new ( ::operator new( ITEMS_OFFSET + n * sizeof( T ) ) ) page;
+    std::uninitialized_value_construct_n( items_of( p ), n );
+    return p;
+  }
+
+  static void release( page* p )
+  {
+    if ( p->refs.fetch_sub( 1u, std::memory_order_acq_rel ) == 1u )
+    {
+      p->~page();
+      ::operator delete( p );
+    }
+  }
+
+  /// share the pages of other, both sides duplicate them before writing
+  void share( paged_vector const& other )
+  {
+    reserve_table( other._num_pages );
+    for ( uint64_t p = 0u; p < other._num_pages; ++p )
+    {
+      uintptr_t const e = other._table[p].load( std::memory_order_relaxed ) | SHARED;
+      page_of( e )->refs.fetch_add( 1u, std::memory_order_relaxed );
+      other._table[p].store( e, std::memory_order_relaxed );
+      _table[p].store( e, std::memory_order_relaxed );
+    }
+    _num_pages = other._num_pages;
+    _size = other._size;
+  }
+
+  /// give page p a private copy, duplicating the shared one if still used by another copy
+  uintptr_t unshare( uint64_t p )
+  {
+    auto& slot = _table[p];
+    std::lock_guard<std::mutex> lock( _mutex );
+    uintptr_t e = slot.load( std::memory_order_acquire );
+    if ( ( e & SHARED ) == 0u )
+      return e; /* unshared by another thread meanwhile */
+
+    page* const old = page_of( e );
+    if ( old->refs.load( std::memory_order_acquire ) == 1u )
+    {
+      e = reinterpret_cast<uintptr_t>( old ); /* the other copies are gone */
+    }
+    else
+    {
+      uint64_t const n = page_size( p );
+      page* const copy = new ( ::operator new( ITEMS_OFFSET + n * sizeof( T ) ) ) page;
+      std::uninitialized_copy_n( items_of( old ), n, items_of( copy ) );
+      release( old );
+      e = reinterpret_cast<uintptr_t>( copy );
+    }
+    slot.store( e, std::memory_order_release );
+    return e;
+  }
+
+  void add_page()
+  {
+    if ( _num_pages == _table_capacity )
+    {
+      reserve_table( std::max<uint64_t>( 2u * _table_capacity, 16u ) );
+    }
+    _table[_num_pages].store( reinterpret_cast<uintptr_t>( new_page( page_size( _num_pages ) ) ), std::memory_order_relaxed );
+    ++_num_pages;
+  }
+
+  void reserve_table( uint64_t num_pages )
+  {
+    if ( num_pages <= _table_capacity )
+      return;
+    std::unique_ptr<std::atomic<uintptr_t>[]> table( new std::atomic<uintptr_t>[num_pages] );
+    for ( uint64_t p = 0u; p < _num_pages; ++p )
+    {
+      table[p].store( _table[p].load( std::memory_order_relaxed ), std::memory_order_relaxed );
+    }
+    _table.swap( table );
+    _table_capacity = num_pages;
+  }
+
+private:
+  std::unique_ptr<std::atomic<uintptr_t>[]> _table;  ///< the tagged page pointers
+  uint64_t   _num_pages{0u};
+  uint64_t   _table_capacity{0u};
+  uint64_t   _size{0u};
+  std::mutex _mutex;
+};  // end class paged_vector
+
+iFPGA_NAMESPACE_HEADER_END
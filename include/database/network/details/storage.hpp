@@ -18,9 +18,12 @@
 #pragma once
 #include "node.hpp"
 #include "node_hash.hpp"
+#include "strash_table.hpp"
 
 #include <string>
 #include <vector>
+#include <memory>
+#include <utility>
 #include <cassert>
 #include <unordered_map>
 iFPGA_NAMESPACE_HEADER_START
@@ -37,103 +40,75 @@ struct empty_storate_data
 /**
  * @brief the storage of a network, mainly contains:
  *      nodes/ inputs/ outputs/ latches/ hash/ data
+ * @tparam Index the node index kept by the strash table, should match the word of Node's pointers
+ * @tparam Nodes the node container, std::vector or the copy-on-write paged_vector
  */
-template<typename Node ,typename T = empty_storate_data >
+template<typename Node ,typename T = empty_storate_data, typename Index = uint64_t, typename Nodes = std::vector<Node> >
 struct storage
 {
   storage()
   {
-    nodes.reserve(10000u);
-    //hash.reserve(10000u);
-    hash.assign(10000u, 0);
-    num_entries = 0;
-
     nodes.emplace_back();     // the first node generally is a constant node
   }
 
-  using node_type = Node;
+  using node_type  = Node;
+  using index_type = Index;
 
-  uint64_t abc_hash(const node_type& n, uint64_t size)
+  /**
+   * @brief the strash key of a two-fanin node, the fanins should be ordered
+   */
+  static uint32_t hash_key(const node_type& n)
   {
-    uint64_t key = 0;
-    key += n.children[0].index * 7937;
-    key += n.children[1].index * 2971;
-    key += n.children[0].weight * 911;
-    key += n.children[1].weight * 353;
-    return key % size;
+    return strash_table<Index>::hash_key( n.children[0].data, n.children[1].data );
   }
 
   uint64_t hash_find(const node_type& n)
   {
-    uint64_t key = abc_hash(n, hash.size());
-    // here 0 means no next, not found
-    for(uint64_t node = hash[key]; node != 0; node = nodes[node].next)
-    {
-      if(nodes[node] == n) return node;
-    }
-    return 0;
+    return hash.find( hash_key(n), [&]( Index index ) { return std::as_const( nodes )[index] == n; } );
   }
 
   void hash_reserve(uint64_t size)
   {
-    assert(size > 0);
-    std::vector<uint64_t> new_hash(size, 0);
-    for(uint64_t i = 0; i < hash.size(); ++i)
-    {
-      for(uint64_t pEnt = hash[i], pEnt2 = pEnt ? nodes[pEnt].next : 0;
-          pEnt != 0;
-          pEnt = pEnt2, pEnt2 = pEnt ? nodes[pEnt].next : 0)
-          {
-            uint64_t key = abc_hash(nodes[pEnt], size);
-            nodes[pEnt].next = new_hash[key];
-            new_hash[key] = pEnt;
-          }
-    }
-    hash.swap(new_hash);
+    hash.reserve( size );
   }
 
-  void hash_insert(node_type n, uint64_t index)
+  void hash_insert(node_type const& n, uint64_t index)
   {
-    if(num_entries > 2 * hash.size())
-    {
-      hash_reserve( static_cast<uint64_t>( 3.1415f * hash.size()) );
-    }
-    uint64_t key = abc_hash(n, hash.size());
-    nodes[index].next = hash[key];
-    hash[key] = index;
-    ++num_entries;
+    hash.insert( hash_key(n), static_cast<Index>( index ), [&]( Index other ) { return std::as_const( nodes )[other] == n; } );
   }
 
-  void hash_erase(node_type n)
+  void hash_erase(node_type const& n, uint64_t index)
   {
-    uint64_t key = abc_hash(n, hash.size());
-    uint64_t cur = hash[key], pre = hash[key];
-    while(!(n == nodes[cur]) && nodes[cur].next != 0)
-    {
-      pre = cur;
-      cur = nodes[cur].next;
-    }
-    assert(n == nodes[cur]);
-    if(cur == hash[key])
-    {
-      hash[key] = nodes[cur].next;
-    }
-    else
-    {
-      nodes[pre].next = nodes[cur].next;
-    }
-    --num_entries;
+    hash.erase( hash_key(n), static_cast<Index>( index ) );
   }
 
-  uint64_t hash_size() { return num_entries; }
+  uint64_t hash_size() { return hash_stale ? stale_hash_size : hash.size(); }
+
+  /**
+   * @brief a copy sharing the node pages (with a paged node container) instead of copying them
+   *  the strash table is not copied, the network rebuilds it on the first structural change
+   */
+  std::shared_ptr<storage> snapshot()
+  {
+    auto s = std::make_shared<storage>();
+    s->nodes             = nodes;
+    s->inputs            = inputs;
+    s->outputs           = outputs;
+    s->latch_information = latch_information;
+    s->data              = data;
+    s->hash_stale        = true;
+    s->stale_hash_size   = hash_size();
+    return s;
+  }
 
-  std::vector<node_type> nodes;
+  Nodes nodes;
   std::vector<uint64_t> inputs;
   std::vector<typename node_type::pointer_type> outputs;
   std::unordered_map<uint64_t, latch_info> latch_information;
 
-  std::vector<uint64_t> hash; 
-  uint64_t num_entries;
+  strash_table<Index> hash;
+  bool     hash_stale{false};      ///< the strash table is empty and must be rebuilt from the nodes
+  uint64_t stale_hash_size{0u};   ///< the number of hashed nodes while the table is stale
   T data;
 };  // end struct storage
 
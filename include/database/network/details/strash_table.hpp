@@ -0,0 +1,275 @@
+// ***************************************************************************************
+// Copyright (c) 2023-2025 Peng Cheng Laboratory
+// Copyright (c) 2023-2025 Shanghai Anlogic Infotech Co.,Ltd.
+// Copyright (c) 2023-2025 Peking University
+//
+// iMAP-FPGA is licensed under Mulan PSL v2.
+// You can use this software according to the terms and conditions of the Mulan PSL v2.
+// You may obtain a copy of Mulan PSL v2 at:
+// http://license.coscl.org.cn/MulanPSL2
+//
+// THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+// EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+// MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+//
+// See the Mulan PSL v2 for more details.
+// ***************************************************************************************
+
+#pragma once
+
+#include <stdint.h>
+#include <vector>
+#include <limits>
+#include <utility>
+#include <cassert>
+
+#include "utils/ifpga_namespaces.hpp"
+iFPGA_NAMESPACE_HEADER_START
+
+/**
+ * @brief open-addressing structural hash table of the two-fanin nodes
+ *  - a slot keeps the 32-bit fingerprint of the key inline with the node index,
+ *    the home slot is taken from the high bits of the fingerprint, so probing, deletion
+ *    and growth never touch the node array, the key is only compared on a fingerprint hit
+ *  - linear probing with backward-shift deletion
+ *  - the growth is incremental, the previous table is drained a few slots per operation
+ *  - equal keys are kept in LIFO order, the latest inserted node is found first
+ * @tparam Index the node index type, 0 (the constant node) marks an empty slot
+ */
+template<typename Index = uint64_t>
+class strash_table
+{
+public:
+  using index_type = Index;
+
+  struct slot
+  {
+    uint32_t fp{0};
+    Index    index{0};
+  };
+
+  /**
+   * @brief the fingerprint of the (ordered) fanin literals
+   *  a multiplicative mix of both literals keeping the high 32 bits, structurally
+   *  close nodes get regularly spaced homes, which the hardware prefetcher follows
+   */
+  static uint32_t hash_key( uint64_t lit0, uint64_t lit1 )
+  {
+    uint64_t const k = lit0 * UINT64_C( 0x9E3779B97F4A7C15 ) + lit1 * UINT64_C( 0xC2B2AE3D27D4EB4F );
+    return static_cast<uint32_t>( k >> 32 );
+  }
+
+  /**
+   * @brief find the latest inserted node with the key
+   * @param eq eq(index) compares the key of node index with the searched one
+   * @return the node index, 0 if not found
+   */
+  template<typename Eq>
+  Index find( uint32_t fp, Eq&& eq ) const
+  {
+    if ( _table.empty() )
+      return 0;
+    if ( Index found = probe( _table, fp, eq ); found != 0 )
+      return found;
+    return _old.empty() ? 0 : probe( _old, fp, eq );
+  }
+
+  /**
+   * @brief insert node index under the fingerprint
+   * @param eq eq(other) compares the key of node other with the inserted node
+   */
+  template<typename Eq>
+  void insert( uint32_t fp, Index index, Eq&& eq )
+  {
+    assert( index != 0 && index != TOMB );
+    if ( ( _size + 1u ) * 4u > _table.size() * 3u )
+    {
+      grow();
+    }
+    migrate();
+
+    uint64_t const mask = _table.size() - 1u;
+    for ( uint64_t pos = home( fp, mask ); ; pos = ( pos + 1u ) & mask )
+    {
+      auto& s = _table[pos];
+      if ( s.index == 0 )
+      {
+        s.fp = fp;
+        s.index = index;
+        break;
+      }
+      if ( s.fp == fp && eq( s.index ) )
+      {
+        /* keep the latest node in front of the older duplicate */
+        std::swap( s.index, index );
+      }
+    }
+    ++_size;
+  }
+
+  /**
+   * @brief erase the node index stored under the fingerprint
+   * @return false if the node is not in the table
+   */
+  bool erase( uint32_t fp, Index index )
+  {
+    if ( _table.empty() )
+      return false;
+    migrate();
+
+    uint64_t const mask = _table.size() - 1u;
+    for ( uint64_t pos = home( fp, mask ); _table[pos].index != 0; pos = ( pos + 1u ) & mask )
+    {
+      if ( _table[pos].index == index )
+      {
+        backward_shift( pos );
+        --_size;
+        return true;
+      }
+    }
+
+    if ( !_old.empty() )
+    {
+      uint64_t const old_mask = _old.size() - 1u;
+      for ( uint64_t pos = home( fp, old_mask ); _old[pos].index != 0; pos = ( pos + 1u ) & old_mask )
+      {
+        if ( _old[pos].index == index )
+        {
+          _old[pos].index = TOMB;
+          --_size;
+          return true;
+        }
+      }
+    }
+    return false;
+  }
+
+  void clear()
+  {
+    std::vector<slot>().swap( _table );
+    std::vector<slot>().swap( _old );
+    _cursor = 0u;
+    _size = 0u;
+  }
+
+  /**
+   * @brief allocate the table for at least n entries without incremental growth
+   */
+  void reserve( uint64_t n )
+  {
+    uint64_t cap = INIT_CAPACITY;
+    while ( cap * 3u < n * 4u )
+      cap <<= 1u;
+    if ( cap <= _table.size() )
+      return;
+    drain();
+    std::vector<slot> table( cap );
+    std::swap( table, _table );
+    for ( auto const& s : table )
+    {
+      if ( s.index != 0 && s.index != TOMB )
+        place( s );
+    }
+  }
+
+  uint64_t size() const { return _size; }
+  uint64_t capacity() const { return _table.size(); }
+
+private:
+  static constexpr Index    TOMB          = std::numeric_limits<Index>::max();
+  static constexpr uint64_t INIT_CAPACITY = 64u;
+  static constexpr uint64_t MIGRATE_STEP  = 8u;
+
+  /// the home slot is taken from the high bits of the fingerprint
+  static uint64_t home( uint32_t fp, uint64_t mask )
+  {
+    return ( static_cast<uint64_t>( fp ) * ( mask + 1u ) ) >> 32;
+  }
+
+  template<typename Eq>
+  static Index probe( std::vector<slot> const& table, uint32_t fp, Eq& eq )
+  {
+    uint64_t const mask = table.size() - 1u;
+    for ( uint64_t pos = home( fp, mask ); table[pos].index != 0; pos = ( pos + 1u ) & mask )
+    {
+      auto const& s = table[pos];
+      if ( s.fp == fp && s.index != TOMB && eq( s.index ) )
+        return s.index;
+    }
+    return 0;
+  }
+
+  /// insert without duplicate check, the slot goes behind the ones of its probe chain
+  void place( slot const& s )
+  {
+    uint64_t const mask = _table.size() - 1u;
+    uint64_t pos = home( s.fp, mask );
+    while ( _table[pos].index != 0 )
+      pos = ( pos + 1u ) & mask;
+    _table[pos] = s;
+  }
+
+  void backward_shift( uint64_t hole )
+  {
+    uint64_t const mask = _table.size() - 1u;
+    for ( uint64_t pos = ( hole + 1u ) & mask; _table[pos].index != 0; pos = ( pos + 1u ) & mask )
+    {
+      uint64_t const origin = home( _table[pos].fp, mask );
+      /* move the slot if its home is not in the cyclic range (hole, pos] */
+      if ( ( ( pos - origin ) & mask ) >= ( ( pos - hole ) & mask ) )
+      {
+        _table[hole] = _table[pos];
+        hole = pos;
+      }
+    }
+    _table[hole] = slot{};
+  }
+
+  void grow()
+  {
+    if ( _table.empty() )
+    {
+      _table.resize( INIT_CAPACITY );
+      return;
+    }
+    drain();
+    _old.swap( _table );
+    _table.assign( _old.size() * 2u, slot{} );
+    _cursor = 0u;
+  }
+
+  /// move a few slots of the previous table into the current one
+  void migrate()
+  {
+    if ( _old.empty() )
+      return;
+    for ( uint64_t end = std::min<uint64_t>( _cursor + MIGRATE_STEP, _old.size() ); _cursor < end; ++_cursor )
+    {
+      auto& s = _old[_cursor];
+      if ( s.index != 0 && s.index != TOMB )
+      {
+        place( s );
+        s.index = TOMB; /* keep the probe chains of the remaining slots */
+      }
+    }
+    if ( _cursor == _old.size() )
+    {
+      std::vector<slot>().swap( _old );
+      _cursor = 0u;
+    }
+  }
+
+  void drain()
+  {
+    while ( !_old.empty() )
+      migrate();
+  }
+
+private:
+  std::vector<slot> _table;
+  std::vector<slot> _old;     ///< the table being drained by the incremental growth
+  uint64_t          _cursor{0u};
+  uint64_t          _size{0u};
+};  // end class strash_table
+
+iFPGA_NAMESPACE_HEADER_END
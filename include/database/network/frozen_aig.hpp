@@ -0,0 +1,481 @@
+// ***************************************************************************************
+// Copyright (c) 2023-2025 Peng Cheng Laboratory
+// Copyright (c) 2023-2025 Shanghai Anlogic Infotech Co.,Ltd.
+// Copyright (c) 2023-2025 Peking University
+//
+// iMAP-FPGA is licensed under Mulan PSL v2.
+// You can use this software according to the terms and conditions of the Mulan PSL v2.
+// You may obtain a copy of Mulan PSL v2 at:
+// http://license.coscl.org.cn/MulanPSL2
+//
+// THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+// EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+// MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+//
+// See the Mulan PSL v2 for more details.
+// ***************************************************************************************
+
+
+#pragma once
+#include "utils/ifpga_namespaces.hpp"
+
+#include "aig_network.hpp"
+#include "details/foreach.hpp"
+#include "utils/range.hpp"
+#include "utils/traits.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <limits>
+#include <memory>
+#include <vector>
+
+iFPGA_NAMESPACE_HEADER_START
+
+/**
+ * @brief the flat arrays of a frozen aig, shared by its copies
+ *  the nodes are numbered constant, CIs, then gates after their fanins; a literal is 2 * node + complement
+ */
+struct frozen_aig_storage
+{
+  std::vector<uint32_t> fanin0;          ///< the first fanin literal of each node, 0 for the constant and the CIs
+  std::vector<uint32_t> fanin1;          ///< the second fanin literal of each node
+  std::vector<uint32_t> levels;          ///< the level of each node, 0 for the constant and the CIs
+  std::vector<uint32_t> fanout_offsets;  ///< the fanouts of n are fanouts[fanout_offsets[n] .. fanout_offsets[n + 1]]
+  std::vector<uint32_t> fanouts;         ///< the gate fanouts, sorted
+  std::vector<uint32_t> fanout_sizes;    ///< the gate fanouts and the CO references of each node
+  std::vector<uint32_t> cos;             ///< the CO literals
+  std::vector<uint32_t> equivs;          ///< the next node of the choice class, empty without choices
+  std::vector<uint64_t> source;          ///< the node of the source network
+  uint32_t num_pis{0};
+  uint32_t num_cis{0};
+  uint32_t num_pos{0};
+  uint32_t depth{0};
+};
+
+/**
+ * @brief an immutable copy of an aig for the read-mostly phases (mapping, simulation, choices, CEC)
+ *
+ *  The nodes are stored as structure of arrays in topological order: 32-bit fanin literals, levels,
+ *  a CSR fanout table, the CO literals and, for an aig_with_choice, the chain of the choice nodes.
+ *  The network is built in linear time from a source network and then only supports the `foreach_*`
+ *  iteration and the structural queries, so it can be shared by threads without copying; the
+ *  traversal state lives in a `traversal_context`.  The dead nodes are dropped, `source_node` gives
+ *  the node of the source network.
+ *
+ * @tparam Ntk the source network, aig_network or aig_with_choice, whose node and signal types are used
+ */
+template<typename Ntk = aig_network>
+class frozen_aig
+{
+public:
+#pragma region Types and constructors
+  static constexpr auto min_fanin_size = 2u;
+  static constexpr auto max_fanin_size = 2u;
+  static constexpr bool is_topologically_sorted = true;
+
+  using base_type = frozen_aig;
+  using storage = std::shared_ptr<frozen_aig_storage>;
+  using node = typename Ntk::node;
+  using signal = typename Ntk::signal;
+
+  /// the end of a choice chain, the one of the aig networks
+  static constexpr node AIG_NULL = Ntk::AIG_NULL;
+
+  frozen_aig()
+      : _storage( std::make_shared<frozen_aig_storage>() )
+  {
+    _storage->fanin0.push_back( 0u );
+    _storage->fanin1.push_back( 0u );
+    _storage->levels.push_back( 0u );
+    _storage->fanout_offsets.assign( 2u, 0u );
+    _storage->fanout_sizes.push_back( 0u );
+    _storage->source.push_back( 0u );
+  }
+
+  explicit frozen_aig( Ntk const& ntk )
+      : _storage( std::make_shared<frozen_aig_storage>() )
+  {
+    build( ntk );
+  }
+#pragma endregion
+
+#pragma region Primary I / O and constants
+  signal get_constant( bool value ) const
+  {
+    return signal( 0u, value ? 1u : 0u );
+  }
+
+  bool is_constant( node const& n ) const
+  {
+    return n == 0u;
+  }
+
+  bool is_ci( node const& n ) const
+  {
+    return n >= 1u && n <= _storage->num_cis;
+  }
+
+  bool is_pi( node const& n ) const
+  {
+    return n >= 1u && n <= _storage->num_pis;
+  }
+
+  bool is_and( node const& n ) const
+  {
+    return n > _storage->num_cis;
+  }
+
+  bool is_dead( node const& ) const
+  {
+    return false;
+  }
+#pragma endregion
+
+#pragma region Structural properties
+  uint32_t size() const
+  {
+    return static_cast<uint32_t>( _storage->fanin0.size() );
+  }
+
+  uint32_t num_cis() const
+  {
+    return _storage->num_cis;
+  }
+
+  uint32_t num_cos() const
+  {
+    return static_cast<uint32_t>( _storage->cos.size() );
+  }
+
+  uint32_t num_pis() const
+  {
+    return _storage->num_pis;
+  }
+
+  uint32_t num_pos() const
+  {
+    return _storage->num_pos;
+  }
+
+  uint32_t num_gates() const
+  {
+    return size() - _storage->num_cis - 1u;
+  }
+
+  uint32_t fanin_size( node const& n ) const
+  {
+    return is_and( n ) ? 2u : 0u;
+  }
+
+  uint32_t fanout_size( node const& n ) const
+  {
+    return _storage->fanout_sizes[n];
+  }
+
+  uint32_t level( node const& n ) const
+  {
+    return _storage->levels[n];
+  }
+
+  uint32_t depth() const
+  {
+    return _storage->depth;
+  }
+#pragma endregion
+
+#pragma region Nodes and signals
+  node get_node( signal const& f ) const
+  {
+    return f.index;
+  }
+
+  signal make_signal( node const& n ) const
+  {
+    return signal( n, 0u );
+  }
+
+  bool is_complemented( signal const& f ) const
+  {
+    return f.complement;
+  }
+
+  uint32_t node_to_index( node const& n ) const
+  {
+    return static_cast<uint32_t>( n );
+  }
+
+  node index_to_node( uint32_t index ) const
+  {
+    return index;
+  }
+
+  signal get_child0( node const& n ) const
+  {
+    return to_signal( _storage->fanin0[n] );
+  }
+
+  signal get_child1( node const& n ) const
+  {
+    return to_signal( _storage->fanin1[n] );
+  }
+
+  /// the node of the source network
+  node source_node( node const& n ) const
+  {
+    return _storage->source[n];
+  }
+#pragma endregion
+
+#pragma region Choices
+  bool has_choices() const
+  {
+    return !_storage->equivs.empty();
+  }
+
+  /// the next node of the choice class of n, AIG_NULL at the end
+  node get_equiv_node( node const& n ) const
+  {
+    if ( _storage->equivs.empty() || _storage->equivs[n] == NO_NODE )
+      return AIG_NULL;
+    return _storage->equivs[n];
+  }
+
+  bool is_repr( node const& n ) const
+  {
+    return get_equiv_node( n ) != AIG_NULL && fanout_size( n ) > 0;
+  }
+#pragma endregion
+
+#pragma region Node and signal iterators
+  template<typename Fn>
+  void foreach_node( Fn&& fn ) const
+  {
+    auto r = range<uint64_t>( size() );
+    detail::foreach_element( r.begin(), r.end(), fn );
+  }
+
+  template<typename Fn>
+  void foreach_gate( Fn&& fn ) const
+  {
+    auto r = range<uint64_t>( _storage->num_cis + 1u, size() );
+    detail::foreach_element( r.begin(), r.end(), fn );
+  }
+
+  template<typename Fn>
+  void foreach_ci( Fn&& fn ) const
+  {
+    auto r = range<uint64_t>( 1u, _storage->num_cis + 1u );
+    detail::foreach_element( r.begin(), r.end(), fn );
+  }
+
+  template<typename Fn>
+  void foreach_pi( Fn&& fn ) const
+  {
+    auto r = range<uint64_t>( 1u, _storage->num_pis + 1u );
+    detail::foreach_element( r.begin(), r.end(), fn );
+  }
+
+  template<typename Fn>
+  void foreach_co( Fn&& fn ) const
+  {
+    detail::foreach_element_transform<std::vector<uint32_t>::const_iterator, signal>(
+        _storage->cos.begin(), _storage->cos.end(), []( auto lit ) { return to_signal( lit ); }, fn );
+  }
+
+  template<typename Fn>
+  void foreach_po( Fn&& fn ) const
+  {
+    detail::foreach_element_transform<std::vector<uint32_t>::const_iterator, signal>(
+        _storage->cos.begin(), _storage->cos.begin() + _storage->num_pos, []( auto lit ) { return to_signal( lit ); }, fn );
+  }
+
+  template<typename Fn>
+  void foreach_fanin( node const& n, Fn&& fn ) const
+  {
+    if ( !is_and( n ) )
+      return;
+
+    static_assert( detail::is_callable_without_index_v<Fn, signal, bool> ||
+                   detail::is_callable_with_index_v<Fn, signal, bool> ||
+                   detail::is_callable_without_index_v<Fn, signal, void> ||
+                   detail::is_callable_with_index_v<Fn, signal, void> );
+
+    auto const f0 = to_signal( _storage->fanin0[n] );
+    auto const f1 = to_signal( _storage->fanin1[n] );
+    if constexpr ( detail::is_callable_without_index_v<Fn, signal, bool> )
+    {
+      if ( !fn( f0 ) )
+        return;
+      fn( f1 );
+    }
+    else if constexpr ( detail::is_callable_with_index_v<Fn, signal, bool> )
+    {
+      if ( !fn( f0, 0 ) )
+        return;
+      fn( f1, 1 );
+    }
+    else if constexpr ( detail::is_callable_without_index_v<Fn, signal, void> )
+    {
+      fn( f0 );
+      fn( f1 );
+    }
+    else if constexpr ( detail::is_callable_with_index_v<Fn, signal, void> )
+    {
+      fn( f0, 0 );
+      fn( f1, 1 );
+    }
+  }
+
+  /**
+   * @brief apply fn on each gate having n as a fanin, in increasing order, fn may return false to stop
+   */
+  template<typename Fn>
+  void foreach_fanout( node const& n, Fn&& fn ) const
+  {
+    static_assert( detail::is_callable_without_index_v<Fn, node, bool> ||
+                   detail::is_callable_without_index_v<Fn, node, void> );
+
+    auto const* it = _storage->fanouts.data() + _storage->fanout_offsets[n];
+    auto const* end = _storage->fanouts.data() + _storage->fanout_offsets[n + 1u];
+    for ( ; it != end; ++it )
+    {
+      if constexpr ( detail::is_callable_without_index_v<Fn, node, bool> )
+      {
+        if ( !fn( node( *it ) ) )
+          return;
+      }
+      else
+      {
+        fn( node( *it ) );
+      }
+    }
+  }
+#pragma endregion
+
+private:
+  static constexpr uint32_t NO_NODE = std::numeric_limits<uint32_t>::max();
+
+  static signal to_signal( uint32_t lit )
+  {
+    return signal( lit >> 1u, lit & 1u );
+  }
+
+  void build( Ntk const& ntk )
+  {
+    auto& st = *_storage;
+    std::vector<uint32_t> to_new( ntk.size(), NO_NODE );
+
+    auto const literal = [&]( signal const& f ) {
+      return ( to_new[ntk.get_node( f )] << 1u ) | ( ntk.is_complemented( f ) ? 1u : 0u );
+    };
+    auto const add = [&]( node const& n, uint32_t f0, uint32_t f1, uint32_t level ) {
+      to_new[n] = static_cast<uint32_t>( st.fanin0.size() );
+      st.fanin0.push_back( f0 );
+      st.fanin1.push_back( f1 );
+      st.levels.push_back( level );
+      st.source.push_back( n );
+    };
+
+    auto const num_nodes = ntk.size();
+    st.fanin0.reserve( num_nodes );
+    st.fanin1.reserve( num_nodes );
+    st.levels.reserve( num_nodes );
+    st.source.reserve( num_nodes );
+
+    /* constant and CIs */
+    add( ntk.get_node( ntk.get_constant( false ) ), 0u, 0u, 0u );
+    ntk.foreach_ci( [&]( auto const& n ) {
+      add( n, 0u, 0u, 0u );
+    } );
+    st.num_cis = ntk.num_cis();
+    st.num_pis = ntk.num_pis();
+
+    /* gates in index order, a gate after its fanins; the DFS only runs on unsorted networks */
+    std::vector<std::pair<node, bool>> stack;
+    ntk.foreach_gate( [&]( auto const& root ) {
+      if ( to_new[root] != NO_NODE )
+        return;
+      stack.emplace_back( root, false );
+      while ( !stack.empty() )
+      {
+        auto const [n, expanded] = stack.back();
+        stack.pop_back();
+        if ( to_new[n] != NO_NODE )
+          continue;
+
+        auto const c0 = ntk.get_node( ntk.get_child0( n ) );
+        auto const c1 = ntk.get_node( ntk.get_child1( n ) );
+        if ( !expanded && ( to_new[c0] == NO_NODE || to_new[c1] == NO_NODE ) )
+        {
+          stack.emplace_back( n, true );
+          if ( to_new[c1] == NO_NODE )
+            stack.emplace_back( c1, false );
+          if ( to_new[c0] == NO_NODE )
+            stack.emplace_back( c0, false );
+          continue;
+        }
+        auto const f0 = literal( ntk.get_child0( n ) );
+        auto const f1 = literal( ntk.get_child1( n ) );
+        add( n, f0, f1, std::max( st.levels[f0 >> 1u], st.levels[f1 >> 1u] ) + 1u );
+      }
+    } );
+
+    /* COs */
+    st.cos.reserve( ntk.num_cos() );
+    ntk.foreach_co( [&]( auto const& f ) {
+      auto const lit = literal( f );
+      st.cos.push_back( lit );
+      st.depth = std::max( st.depth, st.levels[lit >> 1u] );
+    } );
+    st.num_pos = ntk.num_pos();
+
+    /* fanout CSR, the gates are visited in increasing order so the fanouts are sorted */
+    auto const size = st.fanin0.size();
+    st.fanout_offsets.assign( size + 1u, 0u );
+    for ( auto n = st.num_cis + 1u; n < size; ++n )
+    {
+      ++st.fanout_offsets[( st.fanin0[n] >> 1u ) + 1u];
+      ++st.fanout_offsets[( st.fanin1[n] >> 1u ) + 1u];
+    }
+    for ( auto n = 0u; n < size; ++n )
+    {
+      st.fanout_offsets[n + 1u] += st.fanout_offsets[n];
+    }
+    st.fanouts.resize( st.fanout_offsets[size] );
+    std::vector<uint32_t> fill( st.fanout_offsets.begin(), st.fanout_offsets.end() - 1 );
+    for ( auto n = st.num_cis + 1u; n < size; ++n )
+    {
+      st.fanouts[fill[st.fanin0[n] >> 1u]++] = n;
+      st.fanouts[fill[st.fanin1[n] >> 1u]++] = n;
+    }
+    st.fanout_sizes.resize( size );
+    for ( auto n = 0u; n < size; ++n )
+    {
+      st.fanout_sizes[n] = st.fanout_offsets[n + 1u] - st.fanout_offsets[n];
+    }
+    for ( auto const lit : st.cos )
+    {
+      ++st.fanout_sizes[lit >> 1u];
+    }
+
+    /* choices */
+    if constexpr ( has_get_equiv_node_v<Ntk> )
+    {
+      st.equivs.assign( size, NO_NODE );
+      for ( auto n = 0u; n < size; ++n )
+      {
+        auto const e = ntk.get_equiv_node( st.source[n] );
+        if ( e != Ntk::AIG_NULL && e < to_new.size() )
+        {
+          st.equivs[n] = to_new[e];
+        }
+      }
+    }
+  }
+
+private:
+  std::shared_ptr<frozen_aig_storage> _storage;
+};  // end class frozen_aig
+
+iFPGA_NAMESPACE_HEADER_END
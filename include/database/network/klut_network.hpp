@@ -23,33 +23,41 @@
 
 #include "utils/traits.hpp"
 #include "utils/range.hpp"
-#include "utils/truth_table_cache.hpp"
+#include "utils/lut_function_cache.hpp"
 #include "kitty/dynamic_truth_table.hpp"
 #include "kitty/constructors.hpp"
 
+#include <algorithm>
+#include <initializer_list>
+#include <iterator>
+
 iFPGA_NAMESPACE_HEADER_START
 
 struct klut_storage_data
 {
-  truth_table_cache< kitty::dynamic_truth_table > cache;
+  lut_function_cache    cache;
   uint32_t              num_pis{0u};
   uint32_t              num_pos{0u};
   std::vector<uint32_t> latches{};
   uint32_t              trav_id{0u};  
+  std::vector<uint32_t> fanins{};     ///< the fanin lists of the nodes with more than 6 fanins
 };
 
 /**
  * @brief klut node
+ *        children:   up to 6 fanins, or the offset of the fanins in klut_storage_data::fanins,
+ *                    the CI index for a CI
  *        data[0].h1: Fan-out size
  *        data[0].h2: Application-specific value
  *        data[1].h1: Function literal in truth table cache
  *        data[2].h2: Visited flags
  */
-struct klut_storage_node : mixed_node<2>
+struct klut_storage_node : pooled_node<6, 2>
 {
+  /// the pooled fanins compare by their offset
   bool operator==( klut_storage_node const& other ) const
   {
-    return data[1].h1 == other.data[1].h1 && children == other.children;
+    return data[1].h1 == other.data[1].h1 && num_children == other.num_children && children == other.children;
   }
 };
 
@@ -68,15 +76,13 @@ public:
   using signal = uint64_t;
 
   klut_network()
-      : _storage( std::make_shared<klut_storage>() ),
-        _events( std::make_shared<decltype( _events )::element_type>() )
+      : _storage( std::make_shared<klut_storage>() )
   {
     _init();
   }
 
   klut_network( std::shared_ptr<klut_storage> storage )
-      : _storage( storage ),
-        _events( std::make_shared<decltype( _events )::element_type>() )
+      : _storage( storage )
   {
     _init();
   }
@@ -155,6 +161,7 @@ public:
 
     const auto index = _storage->nodes.size();
     _storage->nodes.emplace_back();
+    _storage->nodes[index].children[0] = static_cast<uint32_t>( _storage->inputs.size() );
     _storage->inputs.emplace_back( index );
     _storage->nodes[index].data[1].h1 = 2;
     ++_storage->data.num_pis;
@@ -182,6 +189,7 @@ public:
 
     auto const index = static_cast<uint32_t>( _storage->nodes.size() );
     _storage->nodes.emplace_back();
+    _storage->nodes[index].children[0] = static_cast<uint32_t>( _storage->inputs.size() );
     _storage->inputs.emplace_back( index );
     _storage->nodes[index].data[1].h1 = 2;
 
@@ -324,9 +332,30 @@ signal create_maj( signal a, signal b, signal c )
 
 #pragma region Create arbitrary functions
   signal _create_node( std::vector<signal> const& children, uint32_t literal )
+  {
+    return _create_node( children.begin(), children.end(), literal );
+  }
+
+  signal _create_node( std::initializer_list<signal> children, uint32_t literal )
+  {
+    return _create_node( children.begin(), children.end(), literal );
+  }
+
+  template<typename Iterator>
+  signal _create_node( Iterator begin, Iterator end, uint32_t literal )
   {
     storage::element_type::node_type node;
-    std::copy( children.begin(), children.end(), std::back_inserter( node.children ) );
+    node.num_children = static_cast<uint32_t>( std::distance( begin, end ) );
+    if ( node.is_pooled() )
+    {
+      auto& pool = _storage->data.fanins;
+      node.children[0] = static_cast<uint32_t>( pool.size() );
+      std::transform( begin, end, std::back_inserter( pool ), []( auto c ) { return static_cast<uint32_t>( c ); } );
+    }
+    else
+    {
+      std::transform( begin, end, node.children.begin(), []( auto c ) { return static_cast<uint32_t>( c ); } );
+    }
     node.data[1].h1 = literal;
 
     //FIXME, skip hash
@@ -341,17 +370,14 @@ signal create_maj( signal a, signal b, signal c )
     //_storage->hash[node] = index;
 
     /* increase ref-count to children */
-    for ( auto c : children )
+    for ( auto it = begin; it != end; ++it )
     {
-      _storage->nodes[c].data[0].h1++;
+      _storage->nodes[*it].data[0].h1++;
     }
 
     set_value( index, 0 );
 
-    for ( auto const& fn : _events->on_add )
-    {
-      fn( index );
-    }
+    _events.add( *this, index );
 
     return index;
   }
@@ -380,22 +406,22 @@ signal create_maj( signal a, signal b, signal c )
     /* find all parents from old_node */
     for ( auto i = 0u; i < _storage->nodes.size(); ++i )
     {
-      auto& n = _storage->nodes[i];
-      for ( auto& child : n.children )
+      if ( i <= 1 || is_ci( i ) )
+        continue;
+
+      auto const begin = _fanins_begin( i );
+      auto const end = begin + _storage->nodes[i].num_children;
+      for ( auto child = begin; child != end; ++child )
       {
-        if ( child == old_node )
+        if ( *child == old_node )
         {
-          std::vector<signal> old_children( n.children.size() );
-          std::transform( n.children.begin(), n.children.end(), old_children.begin(), []( auto c ) { return c.index; } );
-          child = new_signal;
+          std::vector<signal> old_children( begin, end );
+          *child = static_cast<uint32_t>( new_signal );
 
           // increment fan-out of new node
           _storage->nodes[new_signal].data[0].h1++;
 
-          for ( auto const& fn : _events->on_modified )
-          {
-            fn( i, old_children );
-          }
+          _events.modified( *this, node( i ), old_children );
         }
       }
     }
@@ -461,7 +487,7 @@ signal create_maj( signal a, signal b, signal c )
 
   uint32_t fanin_size( node const& n ) const
   {
-    return static_cast<uint32_t>( _storage->nodes[n].children.size() );
+    return _storage->nodes[n].num_children;
   }
 
   uint32_t fanout_size( node const& n ) const
@@ -480,6 +506,14 @@ signal create_maj( signal a, signal b, signal c )
   {
     return _storage->data.cache[_storage->nodes[n].data[1].h1];
   }
+
+  /**
+   * @brief the function of a node with at most 6 fanins, the low 2^fanin_size bits of the word
+   */
+  uint64_t node_function_word( const node& n ) const
+  {
+    return _storage->data.cache.word( _storage->nodes[n].data[1].h1 );
+  }
 #pragma endregion
 
 #pragma region Nodes and signals
@@ -547,8 +581,8 @@ signal create_maj( signal a, signal b, signal c )
 
   uint32_t ci_index( node const& n ) const
   {
-    assert( _storage->nodes[n].children[0].data == _storage->nodes[n].children[1].data );
-    return static_cast<uint32_t>( _storage->nodes[n].children[0].data );
+    assert( is_ci( n ) );
+    return _storage->nodes[n].children[0];
   }
 
   uint32_t co_index( signal const& s ) const
@@ -567,8 +601,8 @@ signal create_maj( signal a, signal b, signal c )
 
   uint32_t pi_index( node const& n ) const
   {
-    assert( _storage->nodes[n].children[0].data == _storage->nodes[n].children[1].data );
-    return static_cast<uint32_t>( _storage->nodes[n].children[0].data );
+    assert( is_ci( n ) );
+    return _storage->nodes[n].children[0];
   }
 
   uint32_t po_index( signal const& s ) const
@@ -587,8 +621,8 @@ signal create_maj( signal a, signal b, signal c )
 
   uint32_t ro_index( node const& n ) const
   {
-    assert( _storage->nodes[n].children[0].data == _storage->nodes[n].children[1].data );
-    return static_cast<uint32_t>( _storage->nodes[n].children[0].data - _storage->data.num_pis );
+    assert( is_ci( n ) );
+    return _storage->nodes[n].children[0] - _storage->data.num_pis;
   }
 
   uint32_t ri_index( signal const& s ) const
@@ -607,7 +641,7 @@ signal create_maj( signal a, signal b, signal c )
 
   signal ro_to_ri( signal const& s ) const
   {
-    return ( _storage->outputs.begin() + _storage->data.num_pos + _storage->nodes[s].children[0].data - _storage->data.num_pis )->index;
+    return ( _storage->outputs.begin() + _storage->data.num_pos + _storage->nodes[s].children[0] - _storage->data.num_pis )->index;
   }
 
   node ri_to_ro( signal const& s ) const
@@ -723,8 +757,9 @@ signal create_maj( signal a, signal b, signal c )
     if ( n == 0 || is_ci( n ) )
       return;
 
-    using IteratorType = decltype( _storage->outputs.begin() );
-    detail::foreach_element_transform<IteratorType, uint32_t>( _storage->nodes[n].children.begin(), _storage->nodes[n].children.end(), []( auto f ) { return f.index; }, fn );
+    /* by position, fn may add nodes and move the node array or the fanin pool */
+    auto r = range<uint32_t>( _storage->nodes[n].num_children );
+    detail::foreach_element_transform<decltype( r.begin() ), uint32_t>( r.begin(), r.end(), [this, n]( auto i ) { return _fanins_begin( n )[i]; }, fn );
   }
 #pragma endregion
 
@@ -739,14 +774,19 @@ signal create_maj( signal a, signal b, signal c )
       index <<= 1;
       index ^= *begin++ ? 1 : 0;
     }
-    return kitty::get_bit( _storage->data.cache[_storage->nodes[n].data[1].h1], index );
+    auto const literal = _storage->nodes[n].data[1].h1;
+    if ( _storage->data.cache.is_word( literal ) )
+    {
+      return ( _storage->data.cache.word( literal ) >> index ) & 1u;
+    }
+    return kitty::get_bit( _storage->data.cache[literal], index );
   }
 
   template<typename Iterator>
   iterates_over_truth_table_t<Iterator>
   compute( node const& n, Iterator begin, Iterator end ) const
   {
-    const auto nfanin = _storage->nodes[n].children.size();
+    const auto nfanin = _storage->nodes[n].num_children;
     std::vector<typename Iterator::value_type> tts( begin, end );
 
     assert( nfanin != 0 );
@@ -849,9 +889,16 @@ signal create_maj( signal a, signal b, signal c )
     return get_detailed_lut_statics(k);
   }
 
+private:
+  uint32_t* _fanins_begin( node const& n ) const
+  {
+    auto& nobj = _storage->nodes[n];
+    return nobj.is_pooled() ? _storage->data.fanins.data() + nobj.children[0] : nobj.children.data();
+  }
+
 public:
   std::shared_ptr<klut_storage> _storage;
-  std::shared_ptr<network_events<base_type>> _events;
+  network_event_dispatcher<base_type> _events;
 };
 
 iFPGA_NAMESPACE_HEADER_END
@@ -19,10 +19,13 @@
 
 #include <cstdint>
 #include <vector>
+#include <limits>
+#include <algorithm>
 
 #include "utils/traits.hpp"
 #include "utils/cost_functions.hpp"
 #include "utils/node_map.hpp"
+#include "utils/traversal_context.hpp"
 #include "immutable_view.hpp"
 
 iFPGA_NAMESPACE_HEADER_START
@@ -40,11 +43,21 @@ struct depth_view_params
  * `level` and `depth`.  The levels are computed at construction
  * and can be recomputed by calling the `update_levels` method.
  *
- * It also automatically updates levels, and depth when creating nodes or
- * creating a PO on a depth_view, however, it does not update the information,
- * when modifying or deleting nodes, neither will the critical paths be
- * recalculated (due to efficiency reasons).  In order to recalculate levels,
- * depth, and critical paths, one can call `update_levels` instead.
+ * It also keeps the levels up to date through the network events: a new
+ * node gets its level from its fanins, a modified node updates the levels of
+ * its transitive fanout.  The view also keeps the required level of each node,
+ * the latest level it may have without increasing the depth, which a modified
+ * or deleted node updates through its transitive fanin.  Both propagations
+ * only visit the nodes whose value changes; they need the fanouts of the
+ * network, which are taken from its fanout index.  The index must be enabled
+ * before the view is created, so that it is updated before the view handles
+ * an event.  Without an index each modification falls back to `update_levels`.
+ * The critical paths are not maintained.
+ *
+ * Given a `traversal_context`, the levels are computed with the visited flags
+ * of the context, so that several threads can level the same network.  Such a
+ * view does not register event handlers, which the threads would share: its
+ * levels are those of the construction until `update_levels` is called.
  *
  * **Required network functions:**
  * - `size`
@@ -83,6 +96,10 @@ public:
   {
     (void)ps;
   }
+
+  depth_view( Ntk const& ntk, traversal_context<Ntk>&, NodeCostFn const& = {}, depth_view_params const& = {} ) : Ntk( ntk )
+  {
+  }
 };
 
 template<class Ntk, class NodeCostFn>
@@ -93,11 +110,16 @@ public:
   using node = typename Ntk::node;
   using signal = typename Ntk::signal;
 
+  /// the required level of the nodes outside of the CO cones
+  static constexpr uint32_t UNCONSTRAINED = std::numeric_limits<uint32_t>::max();
+
   explicit depth_view( NodeCostFn const& cost_fn = {}, depth_view_params const& ps = {} )
       : Ntk(),
         _ps( ps ),
         _levels( *this ),
         _crit_path( *this ),
+        _rlevels( *this, UNREACHED ),
+        _co_refs( *this ),
         _cost_fn( cost_fn )
   {
     static_assert( is_network_type_v<Ntk>, "Ntk is not a network type" );
@@ -109,7 +131,7 @@ public:
     static_assert( has_foreach_po_v<Ntk>, "Ntk does not implement the foreach_po method" );
     static_assert( has_foreach_fanin_v<Ntk>, "Ntk does not implement the foreach_fanin method" );
 
-    Ntk::events().on_add.push_back( [this]( auto const& n ) { on_add( n ); } );
+    register_events();
   }
 
   /*! \brief Standard constructor.
@@ -122,6 +144,8 @@ public:
         _ps( ps ),
         _levels( ntk ),
         _crit_path( ntk ),
+        _rlevels( ntk, UNREACHED ),
+        _co_refs( ntk ),
         _cost_fn( cost_fn )
   {
     static_assert( is_network_type_v<Ntk>, "Ntk is not a network type" );
@@ -135,15 +159,60 @@ public:
 
     update_levels();
 
-    Ntk::events().on_add.push_back( [this]( auto const& n ) { on_add( n ); } );
+    register_events();
   }
 
-  // We should add these or make sure that members are properly copied
-  //depth_view( depth_view<Ntk> const& ) = delete;
-  //depth_view<Ntk> operator=( depth_view<Ntk> const& ) = delete;
+  /*! \brief Levels the network with the visited flags of a traversal context, without listening to it. */
+  depth_view( Ntk const& ntk, traversal_context<Ntk>& ctx, NodeCostFn const& cost_fn = {}, depth_view_params const& ps = {} )
+      : Ntk( ntk ),
+        _ps( ps ),
+        _levels( ntk ),
+        _crit_path( ntk ),
+        _rlevels( ntk, UNREACHED ),
+        _co_refs( ntk ),
+        _cost_fn( cost_fn ),
+        _ctx( &ctx )
+  {
+    static_assert( is_network_type_v<Ntk>, "Ntk is not a network type" );
+    static_assert( has_size_v<Ntk>, "Ntk does not implement the size method" );
+    static_assert( has_get_node_v<Ntk>, "Ntk does not implement the get_node method" );
+    static_assert( has_is_complemented_v<Ntk>, "Ntk does not implement the is_complemented method" );
+    static_assert( has_foreach_po_v<Ntk>, "Ntk does not implement the foreach_po method" );
+    static_assert( has_foreach_fanin_v<Ntk>, "Ntk does not implement the foreach_fanin method" );
+
+    _ctx->reset( ntk );
+    update_levels();
+  }
+
+  /// a copy recomputes its levels and listens to the network on its own
+  depth_view( depth_view const& other )
+      : Ntk( other ),
+        _ps( other._ps ),
+        _levels( *this ),
+        _crit_path( *this ),
+        _rlevels( *this, UNREACHED ),
+        _co_refs( *this ),
+        _cost_fn( other._cost_fn ),
+        _ctx( other._ctx )
+  {
+    update_levels();
+    register_events();
+  }
+
+  depth_view& operator=( depth_view const& ) = delete;
+
+  ~depth_view()
+  {
+    release_events();
+  }
 
   uint32_t depth() const
   {
+    if ( _depth_dirty )
+    {
+      _depth_dirty = false;
+      compute_depth();
+    }
     return _depth;
   }
 
@@ -152,6 +221,17 @@ public:
     return _levels[n];
   }
 
+  /*! \brief The latest level of n keeping the depth, `UNCONSTRAINED` outside of the CO cones. */
+  uint32_t required( node const& n )
+  {
+    if ( _co_dirty )
+    {
+      update_co_refs();
+    }
+    auto const r = _rlevels[n];
+    return r == UNREACHED ? UNCONSTRAINED : depth() - std::min( r, depth() );
+  }
+
   bool is_on_critical_path( node const& n ) const
   {
     return _crit_path[n];
@@ -165,40 +245,136 @@ public:
   void set_depth( uint32_t level )
   {
     _depth = level;
+    _depth_dirty = false;
   }
 
   void update_levels()
   {
     _levels.reset( 0 );
     _crit_path.reset( false );
+    _rlevels.reset( UNREACHED );
+    _co_refs.reset( 0 );
 
-    this->incr_trav_id();
+    trav_next();
     compute_levels();
+    compute_required();
   }
 
   void resize_levels()
   {
     _levels.resize();
+    _rlevels.resize( UNREACHED );
+    _co_refs.resize( 0 );
   }
 
   uint32_t create_po( signal const& f, std::string const& name = std::string() )
   {
     auto po = Ntk::create_po( f, name );
-    _depth = std::max( _depth, _levels[f] );
+    _depth = std::max( _depth, _levels[f] + co_offset( f ) );
+
+    auto const n = this->get_node( f );
+    _co_refs[n] += co_offset( f ) ? COMPL_REF : 1u;
+    if constexpr ( has_has_fanout_index_v<Ntk> )
+    {
+      if ( this->has_fanout_index() )
+      {
+        propagate_required( n );
+        return po;
+      }
+    }
+    compute_required();
     return po;
   }
 
 private:
+  static constexpr uint32_t UNREACHED = std::numeric_limits<uint32_t>::max();
+  static constexpr uint32_t COMPL_REF = 1u << 16u;  ///< a complemented CO reference in _co_refs
+
+  /* the visited flags of the context or of the network */
+  uint32_t trav_visited( node const& n ) const
+  {
+    return _ctx ? _ctx->visited( n ) : this->visited( n );
+  }
+
+  void trav_set_visited( node const& n, uint32_t v ) const
+  {
+    _ctx ? _ctx->set_visited( n, v ) : this->set_visited( n, v );
+  }
+
+  uint32_t trav_current() const
+  {
+    return _ctx ? _ctx->trav_id() : this->trav_id();
+  }
+
+  void trav_next() const
+  {
+    _ctx ? _ctx->incr_trav_id() : this->incr_trav_id();
+  }
+
+  /* the handlers are functors so that the view finds and releases its own ones */
+  struct add_handler
+  {
+    depth_view* view;
+    void operator()( node const& n ) const { view->on_add( n ); }
+  };
+
+  struct modified_handler
+  {
+    depth_view* view;
+    void operator()( node const& n, std::vector<signal> const& previous ) const { view->on_modified( n, previous ); }
+  };
+
+  struct delete_handler
+  {
+    depth_view* view;
+    void operator()( node const& n ) const { view->on_delete( n ); }
+  };
+
+  void register_events()
+  {
+    if ( _ctx )
+      return;
+    Ntk::events().on_add.push_back( add_handler{this} );
+    Ntk::events().on_modified.push_back( modified_handler{this} );
+    Ntk::events().on_delete.push_back( delete_handler{this} );
+  }
+
+  void release_events()
+  {
+    auto release = [this]( auto& handlers, auto tag ) {
+      using handler = decltype( tag );
+      handlers.erase( std::remove_if( handlers.begin(), handlers.end(), [this]( auto const& fn ) {
+                        auto const* h = fn.template target<handler>();
+                        return h != nullptr && h->view == this;
+                      } ),
+                      handlers.end() );
+    };
+    release( Ntk::events().on_add, add_handler{} );
+    release( Ntk::events().on_modified, modified_handler{} );
+    release( Ntk::events().on_delete, delete_handler{} );
+  }
+
+  uint32_t edge_offset( signal const& f ) const
+  {
+    return ( _ps.count_complements && this->is_complemented( f ) ) ? 1u : 0u;
+  }
+
+  uint32_t co_offset( signal const& f ) const
+  {
+    return edge_offset( f );
+  }
+
   uint32_t compute_levels( node const& n )
   {
-    if ( this->visited( n ) == this->trav_id() )
+    if ( trav_visited( n ) == trav_current() )
     {
       return _levels[n];
     }
-    this->set_visited( n, this->trav_id() );
+    trav_set_visited( n, trav_current() );
 
     if ( this->is_constant( n ) || this->is_pi( n ) )
     {
+      _order.push_back( n );
       return _levels[n] = 0;
     }
 
@@ -212,12 +388,15 @@ private:
       level = std::max( level, clevel );
     } );
 
+    _order.push_back( n );
     return _levels[n] = level + _cost_fn( *this, n );
   }
 
   void compute_levels()
   {
     _depth = 0;
+    _depth_dirty = false;
+    _order.clear();
     this->foreach_po( [&]( auto const& f ) {
       auto clevel = compute_levels( this->get_node( f ) );
       if ( _ps.count_complements && this->is_complemented( f ) )
@@ -236,6 +415,174 @@ private:
     // } );
   }
 
+  void compute_depth() const
+  {
+    _depth = 0;
+    this->foreach_po( [&]( auto const& f ) {
+      _depth = std::max( _depth, _levels[f] + co_offset( f ) );
+    } );
+  }
+
+  /**
+   * @brief the reverse levels (longest path to a CO) in reverse topological order,
+   *  the nodes outside of the CO cones stay unreached
+   */
+  void compute_required()
+  {
+    if ( _order.size() == 0u )
+    {
+      trav_next();
+      compute_levels();
+    }
+    _rlevels.reset( UNREACHED );
+    _co_refs.reset( 0 );
+    _co_dirty = false;
+    this->foreach_po( [&]( auto const& f ) {
+      auto const n = this->get_node( f );
+      _co_refs[n] += co_offset( f ) ? COMPL_REF : 1u;
+      _rlevels[n] = _rlevels[n] == UNREACHED ? co_offset( f ) : std::max( _rlevels[n], co_offset( f ) );
+    } );
+    for ( auto it = _order.rbegin(); it != _order.rend(); ++it )
+    {
+      auto const n = *it;
+      if ( _rlevels[n] == UNREACHED || this->is_constant( n ) || this->is_pi( n ) )
+        continue;
+      auto const r = _rlevels[n] + _cost_fn( *this, n );
+      this->foreach_fanin( n, [&]( auto const& f ) {
+        auto& rf = _rlevels[f];
+        rf = rf == UNREACHED ? r + edge_offset( f ) : std::max( rf, r + edge_offset( f ) );
+      } );
+    }
+    _order.clear();
+  }
+
+  /**
+   * @brief recount the CO references after the drivers changed, updating the affected reverse levels
+   */
+  void update_co_refs()
+  {
+    _co_dirty = false;
+    node_map<uint32_t, Ntk> refs( *this, 0u );
+    this->foreach_po( [&]( auto const& f ) {
+      refs[f] += co_offset( f ) ? COMPL_REF : 1u;
+    } );
+    std::vector<node> changed;
+    this->foreach_node( [&]( auto const& n ) {
+      if ( refs[n] != _co_refs[n] )
+      {
+        _co_refs[n] = refs[n];
+        changed.push_back( n );
+      }
+    } );
+    for ( auto const& n : changed )
+    {
+      propagate_required( n );
+    }
+  }
+
+  /**
+   * @brief the level of n from the current levels of its fanins
+   */
+  uint32_t fanin_level( node const& n ) const
+  {
+    if ( this->is_constant( n ) || this->is_pi( n ) )
+      return 0u;
+
+    uint32_t level{0};
+    this->foreach_fanin( n, [&]( auto const& f ) {
+      level = std::max( level, _levels[f] + edge_offset( f ) );
+    } );
+    return level + _cost_fn( *this, n );
+  }
+
+  /**
+   * @brief the reverse level of n from its CO references and the current reverse levels of its live fanouts
+   * @param extra a fanout of n which the fanout index may not list yet
+   */
+  uint32_t fanout_rlevel( node const& n, node const& extra ) const
+  {
+    uint32_t r = UNREACHED;
+    auto const refs = _co_refs[n];
+    if ( refs != 0u )
+    {
+      r = refs >= COMPL_REF ? 1u : 0u;
+    }
+
+    auto visit = [&]( node const& fo ) {
+      if ( this->is_dead( fo ) || _rlevels[fo] == UNREACHED )
+        return;
+      auto const base = _rlevels[fo] + _cost_fn( *this, fo );
+      this->foreach_fanin( fo, [&]( auto const& f ) {
+        if ( this->get_node( f ) == n )
+        {
+          r = r == UNREACHED ? base + edge_offset( f ) : std::max( r, base + edge_offset( f ) );
+        }
+      } );
+    };
+    bool extra_seen = false;
+    this->foreach_fanout( n, [&]( auto const& fo ) {
+      extra_seen |= fo == extra;
+      visit( fo );
+    } );
+    if ( !extra_seen && extra != n )
+    {
+      visit( extra );
+    }
+    return r;
+  }
+
+  /**
+   * @brief update the levels through the transitive fanout of n
+   */
+  void propagate_levels( node const& n )
+  {
+    std::vector<node> stack{n};
+    while ( !stack.empty() )
+    {
+      auto const m = stack.back();
+      stack.pop_back();
+
+      auto const level = fanin_level( m );
+      if ( level == _levels[m] && m != n )
+        continue;
+      _levels[m] = level;
+      _depth_dirty = true;
+      this->foreach_fanout( m, [&]( auto const& fo ) {
+        if ( !this->is_dead( fo ) )
+          stack.push_back( fo );
+      } );
+    }
+  }
+
+  /**
+   * @brief update the reverse levels through the transitive fanin of n
+   * @param extra a fanout of n which the fanout index may not list yet
+   */
+  void propagate_required( node const& n, node const& extra )
+  {
+    std::vector<std::pair<node, node>> stack{{n, extra}};
+    while ( !stack.empty() )
+    {
+      auto const [m, fo] = stack.back();
+      stack.pop_back();
+
+      auto const r = fanout_rlevel( m, fo );
+      if ( r == _rlevels[m] )
+        continue;
+      _rlevels[m] = r;
+      if ( this->is_constant( m ) || this->is_pi( m ) )
+        continue;
+      this->foreach_fanin( m, [&]( auto const& f ) {
+        stack.emplace_back( this->get_node( f ), m );
+      } );
+    }
+  }
+
+  void propagate_required( node const& n )
+  {
+    propagate_required( n, n );
+  }
+
   void set_critical_path( node const& n )
   {
     _crit_path[n] = true;
@@ -259,7 +606,7 @@ private:
 
   void on_add( node const& n )
   {
-    _levels.resize();
+    resize_levels();
 
     uint32_t level{0};
     this->foreach_fanin( n, [&]( auto const& f ) {
@@ -271,19 +618,73 @@ private:
       level = std::max( level, clevel );
     } );
 
+    /* a new node has no fanout, it does not constrain its fanins yet */
     _levels[n] = level + _cost_fn( *this, n );
+    _rlevels[n] = UNREACHED;
+  }
+
+  void on_modified( node const& n, std::vector<signal> const& previous )
+  {
+    if constexpr ( has_has_fanout_index_v<Ntk> )
+    {
+      if ( this->has_fanout_index() )
+      {
+        propagate_levels( n );
+        for ( auto const& f : previous )
+        {
+          propagate_required( this->get_node( f ) );
+        }
+        this->foreach_fanin( n, [&]( auto const& f ) {
+          propagate_required( this->get_node( f ), n );
+        } );
+        return;
+      }
+    }
+    (void)previous;
+    update_levels();
+  }
+
+  void on_delete( node const& n )
+  {
+    if constexpr ( has_has_fanout_index_v<Ntk> )
+    {
+      if ( this->has_fanout_index() )
+      {
+        /* the COs driven by n have been moved to another node */
+        if ( _co_refs[n] != 0u )
+        {
+          _co_dirty = true;
+          _depth_dirty = true;
+        }
+        _rlevels[n] = UNREACHED;
+        this->foreach_fanin( n, [&]( auto const& f ) {
+          propagate_required( this->get_node( f ) );
+        } );
+        return;
+      }
+    }
+    update_levels();
   }
 
   depth_view_params _ps;
   node_map<uint32_t, Ntk> _levels;
   node_map<uint32_t, Ntk> _crit_path;
-  uint32_t _depth{};
+  node_map<uint32_t, Ntk> _rlevels;   ///< the longest path to a CO, UNREACHED outside of the CO cones
+  node_map<uint32_t, Ntk> _co_refs;   ///< the CO references of each node, COMPL_REF for a complemented one
+  std::vector<node> _order;           ///< the topological order of the last full level computation
+  mutable uint32_t _depth{};
+  mutable bool _depth_dirty{false};
+  bool _co_dirty{false};
   NodeCostFn _cost_fn;
+  traversal_context<Ntk>* _ctx{nullptr}; ///< the visited flags when not the ones of the network
 };
 
 template<class T>
 depth_view( T const& )->depth_view<T>;
 
+template<class T>
+depth_view( T const&, traversal_context<T>& )->depth_view<T>;
+
 template<class T, class NodeCostFn = unit_cost<T>>
 depth_view( T const&, NodeCostFn const&, depth_view_params const& )->depth_view<T, NodeCostFn>;
 
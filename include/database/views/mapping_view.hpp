@@ -22,7 +22,7 @@
 
 #include "network/details/foreach.hpp"
 #include "utils/traits.hpp"
-#include "utils/truth_table_cache.hpp"
+#include "utils/lut_function_cache.hpp"
 #include "immutable_view.hpp"
 
 #include <kitty/dynamic_truth_table.hpp>
@@ -41,7 +41,7 @@ struct mapping_view_storage<true>
   std::vector<uint32_t> mappings;
   uint32_t mapping_size{0};
   std::vector<uint32_t> functions;
-  truth_table_cache<kitty::dynamic_truth_table> cache;
+  lut_function_cache cache;
 };
 
 template<>
@@ -201,6 +201,15 @@ public:
     return _mapping_storage->cache[_mapping_storage->functions[this->node_to_index( n )]];
   }
 
+  /**
+   * @brief the function of a cell with at most 6 leaves, the low 2^leaves bits of the word
+   */
+  template<bool enabled = StoreFunction, typename = std::enable_if_t<std::is_same_v<Ntk, Ntk> && enabled>>
+  uint64_t cell_function_word( node const& n ) const
+  {
+    return _mapping_storage->cache.word( _mapping_storage->functions[this->node_to_index( n )] );
+  }
+
   template<bool enabled = StoreFunction, typename = std::enable_if_t<std::is_same_v<Ntk, Ntk> && enabled>>
   void set_cell_function( node const& n, kitty::dynamic_truth_table const& function )
   {
@@ -23,6 +23,7 @@
 
 #include "network/details/foreach.hpp"
 #include "utils/traits.hpp"
+#include "utils/traversal_context.hpp"
 #include "immutable_view.hpp"
 
 iFPGA_NAMESPACE_HEADER_START
@@ -44,6 +45,10 @@ iFPGA_NAMESPACE_HEADER_START
  * reachable nodes are traversed, not all network nodes may be called in
  * `foreach_node` and `foreach_gate`.
  *
+ * Given a `traversal_context`, the order is computed with the visited flags of
+ * the context instead of the ones of the network, so that several threads can
+ * build views of the same network.
+ *
  * **Required network functions:**
  * - `get_constant`
  * - `foreach_pi`
@@ -103,6 +108,20 @@ public:
     update_topo();
   }
 
+  /*! \brief Constructs the view with the visited flags of a traversal context. */
+  topo_view( Ntk const& ntk, traversal_context<Ntk>& ctx ) : immutable_view<Ntk>( ntk )
+  {
+    static_assert( is_network_type_v<Ntk>, "Ntk is not a network type" );
+    static_assert( has_size_v<Ntk>, "Ntk does not implement the size method" );
+    static_assert( has_get_constant_v<Ntk>, "Ntk does not implement the get_constant method" );
+    static_assert( has_foreach_pi_v<Ntk>, "Ntk does not implement the foreach_pi method" );
+    static_assert( has_foreach_po_v<Ntk>, "Ntk does not implement the foreach_po method" );
+    static_assert( has_foreach_fanin_v<Ntk>, "Ntk does not implement the foreach_fanin method" );
+
+    ctx.reset( ntk );
+    update_topo( ctx );
+  }
+
   /*! \brief Default constructor.
    *
    * Constructs topological view, but only for the transitive fan-in starting
@@ -196,67 +215,75 @@ public:
 
   void update_topo()
   {
-    this->incr_trav_id();
-    this->incr_trav_id();
+    update_topo( *this );
+  }
+
+private:
+  /* the markers are the network itself or a traversal context */
+  template<typename Markers>
+  void update_topo( Markers& m )
+  {
+    m.incr_trav_id();
+    m.incr_trav_id();
     topo_order.reserve( this->size() );
 
     /* constants and PIs */
     const auto c0 = this->get_node( this->get_constant( false ) );
     topo_order.push_back( c0 );
-    this->set_visited( c0, this->trav_id() );
+    m.set_visited( c0, m.trav_id() );
 
-    if ( const auto c1 = this->get_node( this->get_constant( true ) ); this->visited( c1 ) != this->trav_id() )
+    if ( const auto c1 = this->get_node( this->get_constant( true ) ); m.visited( c1 ) != m.trav_id() )
     {
       topo_order.push_back( c1 );
-      this->set_visited( c1, this->trav_id() );
+      m.set_visited( c1, m.trav_id() );
     }
 
-    this->foreach_ci( [this]( auto n ) {
-      if ( this->visited( n ) != this->trav_id() )
+    this->foreach_ci( [&]( auto n ) {
+      if ( m.visited( n ) != m.trav_id() )
       {
         topo_order.push_back( n );
-        this->set_visited( n, this->trav_id() );
+        m.set_visited( n, m.trav_id() );
       }
     } );
 
     if ( start_signal )
     {
-      if ( this->visited( this->get_node( *start_signal ) ) == this->trav_id() )
+      if ( m.visited( this->get_node( *start_signal ) ) == m.trav_id() )
         return;
-      create_topo_rec( this->get_node( *start_signal ) );
+      create_topo_rec( m, this->get_node( *start_signal ) );
     }
     else
     {
-      Ntk::foreach_co( [this]( auto f ) {
+      Ntk::foreach_co( [&]( auto f ) {
         /* node was already visited */
-        if ( this->visited( this->get_node( f ) ) == this->trav_id() )
+        if ( m.visited( this->get_node( f ) ) == m.trav_id() )
           return;
 
-        create_topo_rec( this->get_node( f ) );
+        create_topo_rec( m, this->get_node( f ) );
       } );
     }
   }
 
-private:
-  void create_topo_rec( node const& n )
+  template<typename Markers>
+  void create_topo_rec( Markers& m, node const& n )
   {
     /* is permanently marked? */
-    if ( this->visited( n ) == this->trav_id() )
+    if ( m.visited( n ) == m.trav_id() )
       return;
 
     /* ensure that the node is not temporarily marked */
-    assert( this->visited( n ) != this->trav_id() - 1 );
+    assert( m.visited( n ) != m.trav_id() - 1 );
 
     /* mark node temporarily */
-    this->set_visited( n, this->trav_id() - 1 );
+    m.set_visited( n, m.trav_id() - 1 );
 
     /* mark children */
-    this->foreach_fanin( n, [this]( signal const& f ) {
-      create_topo_rec( this->get_node( f ) );
+    this->foreach_fanin( n, [&]( signal const& f ) {
+      create_topo_rec( m, this->get_node( f ) );
     } );
 
     /* mark node n permanently */
-    this->set_visited( n, this->trav_id() );
+    m.set_visited( n, m.trav_id() );
 
     /* visit node */
     topo_order.push_back( n );
@@ -274,6 +301,10 @@ public:
   topo_view( Ntk const& ntk ) : Ntk( ntk )
   {
   }
+
+  topo_view( Ntk const& ntk, traversal_context<Ntk>& ) : Ntk( ntk )
+  {
+  }
 };
 
 template<class T>
@@ -282,4 +313,7 @@ topo_view(T const&) -> topo_view<T>;
 template<class T>
 topo_view(T const&, typename T::signal const&) -> topo_view<T>;
 
+template<class T>
+topo_view(T const&, traversal_context<T>&) -> topo_view<T>;
+
 iFPGA_NAMESPACE_HEADER_END
\ No newline at end of file
@@ -0,0 +1,76 @@
+// ***************************************************************************************
+// Copyright (c) 2023-2025 Peng Cheng Laboratory
+// Copyright (c) 2023-2025 Shanghai Anlogic Infotech Co.,Ltd.
+// Copyright (c) 2023-2025 Peking University
+//
+// iMAP-FPGA is licensed under Mulan PSL v2.
+// You can use this software according to the terms and conditions of the Mulan PSL v2.
+// You may obtain a copy of Mulan PSL v2 at:
+// http://license.coscl.org.cn/MulanPSL2
+//
+// THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+// EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+// MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+//
+// See the Mulan PSL v2 for more details.
+// ***************************************************************************************
+
+
+#pragma once
+
+#include "utils/traits.hpp"
+#include "utils/traversal_context.hpp"
+
+#include "utils/ifpga_namespaces.hpp"
+
+iFPGA_NAMESPACE_HEADER_START
+
+/*! \brief Redirects the traversal state of a network to a traversal context.
+ *
+ * Overrides the interface methods `visited`, `set_visited`, `clear_visited`,
+ * `trav_id`, `incr_trav_id`, `value`, `set_value`, `incr_value`,
+ * `decr_value` and `clear_values`, which then read and write the context
+ * instead of the nodes of the network.  An algorithm only reading the
+ * structure can then run on a network shared with other threads, each one
+ * with its own context.
+ *
+ * Like the other views it shares the storage of the network, and the context
+ * must outlive it.
+ */
+template<typename Ntk>
+class traversal_view : public Ntk
+{
+public:
+  using storage = typename Ntk::storage;
+  using node = typename Ntk::node;
+  using signal = typename Ntk::signal;
+
+  traversal_view( Ntk const& ntk, traversal_context<Ntk>& ctx )
+      : Ntk( ntk ), _ctx( &ctx )
+  {
+    static_assert( is_network_type_v<Ntk>, "Ntk is not a network type" );
+    _ctx->reset( ntk );
+  }
+
+  traversal_context<Ntk>& context() const { return *_ctx; }
+
+  uint32_t visited( node const& n ) const { return _ctx->visited( n ); }
+  void set_visited( node const& n, uint32_t v ) const { _ctx->set_visited( n, v ); }
+  void clear_visited() const { _ctx->clear_visited(); }
+  uint32_t trav_id() const { return _ctx->trav_id(); }
+  void incr_trav_id() const { _ctx->incr_trav_id(); }
+
+  uint32_t value( node const& n ) const { return _ctx->value( n ); }
+  void set_value( node const& n, uint32_t v ) const { _ctx->set_value( n, v ); }
+  uint32_t incr_value( node const& n ) const { return _ctx->incr_value( n ); }
+  uint32_t decr_value( node const& n ) const { return _ctx->decr_value( n ); }
+  void clear_values() const { _ctx->clear_values(); }
+
+private:
+  traversal_context<Ntk>* _ctx;
+};
+
+template<class T>
+traversal_view( T const&, traversal_context<T>& ) -> traversal_view<T>;
+
+iFPGA_NAMESPACE_HEADER_END
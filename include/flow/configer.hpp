@@ -69,6 +69,20 @@ public:
     }
   }
 
+  /**
+   * @brief whether the param is set
+   */
+  bool has_value( std::vector<std::string> param_level) const {
+    nlohmann::json const* value = &_data;
+    for(uint i = 0; i < param_level.size(); ++i){
+      if( !value->is_object() || !value->contains( param_level[i] ) ){
+        return false;
+      }
+      value = &(*value)[ param_level[i] ];
+    }
+    return !value->is_null();
+  }
+
 private:
   nlohmann::json  _data;
   std::string     _config_file;
@@ -143,8 +143,19 @@ private:
     _ps_mapper.cut_enumeration_ps.cut_limit = _configer.get_value<uint>({"klut_mapping", "cut_limit"});
     _ps_mapper.uFlowIters = _configer.get_value<uint>({"klut_mapping", "uGlobal_round"});
     _ps_mapper.uAreaIters = _configer.get_value<uint>({"klut_mapping", "uLocal_round"});
+    if( _configer.has_value({"klut_mapping", "schedule"}) &&
+        !iFPGA_NAMESPACE::parse_mapping_schedule(_configer.get_value<std::string>({"klut_mapping", "schedule"}), _ps_mapper.schedule) )
+    {
+      std::cerr << "The schedule of klut_mapping is wrong, using the default one!" << std::endl;
+    }
     _ps_mapper.bDebug = _configer.get_value<bool>({"klut_mapping", "debug"});
     _ps_mapper.verbose = _configer.get_value<bool>({"klut_mapping", "verbose"});
+    if( !iFPGA_NAMESPACE::dispatch_cut_config(_ps_mapper.cut_enumeration_ps.cut_size, _ps_mapper.cut_enumeration_ps.cut_limit, [](auto){}) )
+    {
+      std::cerr << "The cut_size and cut_limit of klut_mapping are out of range, using 6 and 10!" << std::endl;
+      _ps_mapper.cut_enumeration_ps.cut_size = 6u;
+      _ps_mapper.cut_enumeration_ps.cut_limit = 10u;
+    }
 
     _ps_rewrite.cut_enumeration_ps.cut_size = _configer.get_value<uint>({"rewrite", "cut_size"});
     _ps_rewrite.cut_enumeration_ps.cut_limit = _configer.get_value<uint>({"rewrite", "cut_limit"});
@@ -152,6 +163,11 @@ private:
     _ps_rewrite.b_use_zero_gain = _configer.get_value<bool>({"rewrite", "use_zero_gain"});
     _ps_rewrite.b_preserve_depth = _configer.get_value<bool>({"rewrite", "preserve_depth"});
 
+    /* the cut databases of the flow intern their functions in one pool */
+    auto truth_tables = std::make_shared<iFPGA_NAMESPACE::truth_table_pool<kitty::dynamic_truth_table>>();
+    _ps_mapper.cut_enumeration_ps.truth_tables = truth_tables;
+    _ps_rewrite.cut_enumeration_ps.truth_tables = truth_tables;
+
     return true;
   }
 
@@ -274,7 +290,10 @@ private:
 
     mapping_view<iFPGA_NAMESPACE::aig_with_choice, true, false> mapped_aig(awc);
 
-    auto qor = iFPGA_NAMESPACE::klut_mapping<decltype(mapped_aig), true>(mapped_aig, _ps_mapper);
+    iFPGA_NAMESPACE::mapping_qor_storage qor{};
+    iFPGA_NAMESPACE::dispatch_cut_config(_ps_mapper.cut_enumeration_ps.cut_size, _ps_mapper.cut_enumeration_ps.cut_limit, [&](auto config) {
+      qor = iFPGA_NAMESPACE::klut_mapping<decltype(mapped_aig), true, iFPGA_NAMESPACE::general_cut_data, decltype(config)>(mapped_aig, _ps_mapper);
+    });
 
     return std::make_tuple(*iFPGA_NAMESPACE::choice_to_klut<iFPGA_NAMESPACE::klut_network>( mapped_aig ), mapped_aig, qor);
   }
@@ -34,29 +34,43 @@ using base_aig_network = aig_network;
   `data[1].h1`: Visited flag
   `data[1].h2`: flags
 */
-class aig_with_choice : public base_aig_network
+template<typename AigStorage = aig_storage>
+class basic_aig_with_choice : public basic_aig_network<AigStorage>
 {
 public:
-    using base_type = aig_with_choice;
-    using storage   = base_aig_network::storage;
-    using node      = base_aig_network::node;
-    using signal    = base_aig_network::signal;
-    static constexpr node AIG_NULL = base_aig_network::AIG_NULL;
+    using base_network = basic_aig_network<AigStorage>;
+    using base_type = basic_aig_with_choice;
+    using storage   = typename base_network::storage;
+    using node      = typename base_network::node;
+    using signal    = typename base_network::signal;
+    static constexpr node AIG_NULL = base_network::AIG_NULL;
     static constexpr uint8_t min_fanin_size{2u};
     static constexpr uint8_t max_fanin_size{2u};
 
+    using base_network::fanout_size;
+    using base_network::is_and;
+    using base_network::is_ci;
+    using base_network::get_child0;
+    using base_network::get_child1;
+    using base_network::value;
+    using base_network::set_value;
+    using base_network::visited;
+    using base_network::set_visited;
+    using base_network::trav_id;
+    using base_network::incr_trav_id;
 
 public:
-    aig_with_choice(uint64_t size)
-        : base_aig_network() 
+    basic_aig_with_choice(uint64_t size)
+        : base_network() 
     {
         init_choices(size);
     }
 
-    aig_with_choice(base_aig_network const& aig) : aig_with_choice(aig.size()) 
+    basic_aig_with_choice(base_network const& aig) : basic_aig_with_choice(aig.size()) 
     {
-        base_aig_network::_storage = aig._storage;
-        base_aig_network::_events = aig._events;
+        base_network::_storage = aig._storage;
+        base_network::_events = aig._events;
+        base_network::_fanout_index = aig._fanout_index;
     }
     /**
      * @brief check the node is a representative
@@ -302,4 +316,7 @@ private:
     std::vector<node> _reprs;    ///< representatives of each nodes
 };
 
+using aig_with_choice         = basic_aig_with_choice<aig_storage>;
+using compact_aig_with_choice = basic_aig_with_choice<compact_aig_storage>;
+
 iFPGA_NAMESPACE_HEADER_END
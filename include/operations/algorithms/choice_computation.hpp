@@ -809,25 +809,13 @@ public:
      * @param aig the original network
      */
     choice_computation(choice_params params, aig_network aig) : 
-    _params(params), _aig(aig), _fraig(aig.size()), _simulator(_aig, params.nwords), _prover(params, _fraig, aig.size())
+    _params(params), _aig(aig), _fraig(aig.size()), _simulator(_aig, params.nwords), _prover(params, _fraig, aig.size()), _fanouts(_aig)
     {
         _repr_proved.assign(_aig.size(), 0);
         for(size_t i = 0; i < _aig.size(); ++i)
         {
             _repr_proved[i] = i;
         }
-
-        _fanouts.assign(_aig.size(), std::vector<node>());
-        // calculate fanout for each node once
-        _aig.foreach_gate( [&]( auto const& n ){
-            _aig.foreach_fanin( n, [&]( auto const& c ){
-                auto& fanout = _fanouts[c.index];
-                if ( std::find( fanout.begin(), fanout.end(), n ) == fanout.end() )
-                {
-                    fanout.push_back( n );
-                }
-          });
-      });
     }
 
     /**
@@ -995,11 +983,9 @@ private:
         _aig.set_visited(n, _aig.trav_id());
 
         // traverse the fanouts
-        auto& fanouts = _fanouts[n];
-        for(auto fo : fanouts)
-        {
+        _aig.foreach_fanout(n, [&](auto const& fo){
             collect_tfo_cands_rec(fo);
-        }
+        });
 
         // check if the given node has a representive
         auto repr = _simulator.get_sim_repr(n);
@@ -1225,13 +1211,14 @@ private:
     std::vector<signal> _old2new;                ///< the array 'final' in the paper, a map from _aig to _fraig
 
     cand_equiv_classes _simulator;               ///< simulator to create candidate equiv classes
-    std::vector<std::vector<node>> _fanouts;     ///< fanouts for each node
     sat_prover _prover;                          ///< sat solver to do sat-prove()
     std::vector<node> _repr_proved;              ///< representatives of each node, proved by SAT
 
     // for resimulation
     std::vector<bool> _cex;
     std::vector<node> _sim_classes;              ///< the roots of cand equiv classes to simulate
+
+    fanout_index_scope<aig_network> _fanouts;    ///< the fanout index of _aig, built after the simulator copied it
 };
 
 iFPGA_NAMESPACE_HEADER_END
@@ -192,7 +192,7 @@ private:
     void create_node(std::shared_ptr<aig_network> aig, uint64_t index)
     {
         // create_node
-        auto node = aig->_storage->nodes[index];
+        auto node = std::as_const( aig->_storage->nodes )[index];
         uint64_t weight0 = node.children[0].weight;
         uint64_t weight1 = node.children[1].weight;
         uint64_t child0_id = get_id_in_miter(aig, node.children[0].index);
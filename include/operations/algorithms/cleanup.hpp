@@ -25,6 +25,7 @@
 
 #include "utils/traits.hpp"
 #include "utils/node_map.hpp"
+#include "utils/traversal_context.hpp"
 #include "views/topo_view.hpp"
 
 #include "utils/ifpga_namespaces.hpp"
@@ -33,7 +34,8 @@ iFPGA_NAMESPACE_HEADER_START
 namespace detail
 {
 template<typename NtkSrc, typename NtkDest, typename LeavesIterator>
-void cleanup_dangling_impl( NtkSrc const& ntk, NtkDest& dest, LeavesIterator begin, LeavesIterator end, node_map<signal<NtkDest>, NtkSrc>& old_to_new )
+void cleanup_dangling_impl( NtkSrc const& ntk, NtkDest& dest, LeavesIterator begin, LeavesIterator end, node_map<signal<NtkDest>, NtkSrc>& old_to_new,
+                            traversal_context<NtkSrc>* ctx = nullptr )
 {
   /* constants */
   old_to_new[ntk.get_constant( false )] = dest.get_constant( false );
@@ -50,8 +52,8 @@ void cleanup_dangling_impl( NtkSrc const& ntk, NtkDest& dest, LeavesIterator beg
   assert( it == end );
   (void)end;
 
-  /* foreach node in topological order */
-  topo_view topo{ ntk };
+  /* foreach node in topological order, marked in the context if any */
+  auto const topo = ctx ? topo_view<NtkSrc>{ ntk, *ctx } : topo_view<NtkSrc>{ ntk };
   topo.foreach_node( [&]( auto node ) {
     if ( ntk.is_constant( node ) || ntk.is_ci( node ) )
       return;
@@ -447,6 +449,36 @@ template<class NtkSrc, class NtkDest = NtkSrc>
   return dest;
 }
 
+/*! \brief Cleans up dangling nodes with the visited flags of a traversal context.
+ *
+ * Same as `cleanup_dangling`, but the source network is only read, so that
+ * several threads can clean up the same network, each one with its own
+ * context.
+ */
+template<class NtkSrc, class NtkDest = NtkSrc>
+[[nodiscard]] NtkDest cleanup_dangling( NtkSrc const& ntk, traversal_context<NtkSrc>& ctx, bool remove_dangling_PIs = false, bool remove_redundant_POs = false )
+{
+  static_assert( is_network_type_v<NtkSrc>, "NtkSrc is not a network type" );
+  static_assert( is_network_type_v<NtkDest>, "NtkDest is not a network type" );
+  static_assert( has_clone_node_v<NtkDest>, "NtkDest does not implement the clone_node method" );
+  static_assert( has_create_pi_v<NtkDest>, "NtkDest does not implement the create_pi method" );
+  static_assert( has_create_po_v<NtkDest>, "NtkDest does not implement the create_po method" );
+  static_assert( has_create_not_v<NtkDest>, "NtkDest does not implement the create_not method" );
+
+  NtkDest dest;
+
+  std::vector<signal<NtkDest>> cis;
+  detail::clone_inputs( ntk, dest, cis, remove_dangling_PIs );
+
+  node_map<signal<NtkDest>, NtkSrc> old_to_new( ntk );
+
+  detail::cleanup_dangling_impl( ntk, dest, cis.begin(), cis.end(), old_to_new, &ctx );
+
+  detail::clone_outputs( ntk, dest, old_to_new, remove_redundant_POs );
+
+  return dest;
+}
+
 /*! \brief Cleans up LUT nodes.
  *
  * This method reconstructs a LUT network and optimizes LUTs when they do not
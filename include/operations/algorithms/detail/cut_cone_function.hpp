@@ -0,0 +1,297 @@
+// ***************************************************************************************
+// Copyright (c) 2023-2025 Peng Cheng Laboratory
+// Copyright (c) 2023-2025 Shanghai Anlogic Infotech Co.,Ltd.
+// Copyright (c) 2023-2025 Peking University
+//
+// iMAP-FPGA is licensed under Mulan PSL v2.
+// You can use this software according to the terms and conditions of the Mulan PSL v2.
+// You may obtain a copy of Mulan PSL v2 at:
+// http://license.coscl.org.cn/MulanPSL2
+//
+// THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+// EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+// MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+//
+// See the Mulan PSL v2 for more details.
+// ***************************************************************************************
+
+#pragma once
+#include "utils/ifpga_namespaces.hpp"
+#include "cut/detail/cut_function.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+#include <kitty/constructors.hpp>
+#include <kitty/dynamic_truth_table.hpp>
+#include <kitty/operators.hpp>
+
+iFPGA_NAMESPACE_HEADER_START
+
+namespace detail
+{
+
+/**
+ * @brief the function of a cut of an AIG with choices, simulated on the cone between its root and its leaves
+ *
+ *  A node of the cone is computed from its fanins when both are in the cone, as the merges of the cut
+ *  enumeration do, else a representative is computed from its first choice node in the cone, complemented
+ *  when their phases differ, as the choice cuts are.  The enumeration keeps the merged cut of a set of
+ *  leaves before a choice cut of the same leaves, so the own fanins come first.
+ *  The nodes before the first leaf in the topological order do not reach a leaf: the cone search stops there,
+ *  and it keeps its own stack, its depth is the one of the cone between the leaves and the root.
+ *
+ *  The function is the one of the cone, not always the one the enumeration carries: where a leaf lies in the
+ *  cone of another leaf, the enumeration may have reached the root through the inner leaf from a fanin cut
+ *  without it.  Both functions agree on the values the leaves take in the network and differ at most on the
+ *  others, so the cut implements the root either way.
+ *  One instance per thread, it keeps marks over the nodes of the network.
+ */
+template<typename Ntk>
+class cut_cone_function
+{
+public:
+  using node = typename Ntk::node;
+
+  /**
+   * @param topo_pos the position of a node in a topological order where a choice node comes before its representative
+   */
+  cut_cone_function( Ntk const& ntk, std::vector<uint32_t> const& topo_pos )
+      : _ntk( ntk ),
+        _topo_pos( topo_pos ),
+        _stamps( ntk.size(), 0u ),
+        _kinds( ntk.size(), fail ),
+        _args( ntk.size(), 0u )
+  {
+  }
+
+  /**
+   * @brief the function of the cut of root with the given leaves, variable i for leaf i
+   */
+  template<typename Leaves>
+  kitty::dynamic_truth_table operator()( node const& root, Leaves const& leaves )
+  {
+    ++_stamp;
+    _order.clear();
+    _min_pos = UINT32_MAX;
+    uint32_t num_leaves = 0u;
+    for ( auto leaf : leaves )
+    {
+      _stamps[leaf] = _stamp;
+      _kinds[leaf] = is_leaf;
+      _args[leaf] = num_leaves++;
+      _min_pos = std::min( _min_pos, _topo_pos[leaf] );
+    }
+
+    [[maybe_unused]] bool const found = resolve( root );
+    assert( found && "the leaves are not a cut of the node" );
+
+    if ( num_leaves <= max_word_cut_size )
+    {
+      return word_to_truth_table( evaluate<uint64_t>( num_leaves ) & word_mask( num_leaves ), num_leaves );
+    }
+    return evaluate<kitty::dynamic_truth_table>( num_leaves );
+  }
+
+private:
+  enum : uint8_t
+  {
+    fail,
+    is_leaf,
+    is_constant,
+    own_fanins,
+    choice_node
+  };
+
+  enum : uint8_t
+  {
+    no,
+    yes,
+    pending
+  };
+
+  /* the steps of a node on the stack, waiting for its fanins or for one of its choice nodes */
+  enum : uint8_t
+  {
+    start,
+    fanin0,
+    fanin1,
+    choice
+  };
+
+  struct frame
+  {
+    node n;
+    uint8_t step;
+    node m;       // the choice node tried
+  };
+
+  /* whether the leaves bound the cone of root, the nodes found are listed in _order after the nodes they read */
+  bool resolve( node const& root )
+  {
+    _stack.clear();
+    auto result = visit( root );
+    while ( !_stack.empty() )
+    {
+      auto& f = _stack.back();
+      auto const n = f.n;
+      node m = n;
+      switch ( f.step )
+      {
+      case start:
+        f.step = fanin0;
+        result = visit( _ntk.get_node( _ntk.get_child0( n ) ) );
+        continue;
+      case fanin0:
+        if ( result == yes )
+        {
+          f.step = fanin1;
+          result = visit( _ntk.get_node( _ntk.get_child1( n ) ) );
+          continue;
+        }
+        break;
+      case fanin1:
+        if ( result == yes )
+        {
+          _kinds[n] = own_fanins;
+          result = finish( yes );
+          continue;
+        }
+        break;
+      default:
+        if ( result == yes )
+        {
+          _kinds[n] = choice_node;
+          _args[n] = f.m;
+          result = finish( yes );
+          continue;
+        }
+        m = f.m;
+        break;
+      }
+
+      /* the cone does not close over the own fanins, the next choice node is tried */
+      auto const next = _ntk.is_repr( n ) ? _ntk.get_equiv_node( m ) : Ntk::AIG_NULL;
+      if ( next == Ntk::AIG_NULL )
+      {
+        result = finish( no );
+        continue;
+      }
+      f.step = choice;
+      f.m = next;
+      result = visit( next );
+    }
+    return result == yes;
+  }
+
+  /* a node seen in this call gives its result, a new gate goes on the stack */
+  uint8_t visit( node const& n )
+  {
+    if ( _stamps[n] == _stamp )
+    {
+      return _kinds[n] != fail ? yes : no;
+    }
+    _stamps[n] = _stamp;
+    _kinds[n] = fail;
+
+    if ( _ntk.is_constant( n ) )
+    {
+      _kinds[n] = is_constant;
+      _order.push_back( n );
+      return yes;
+    }
+    if ( _ntk.is_ci( n ) || _topo_pos[n] < _min_pos )
+    {
+      return no;
+    }
+    _stack.push_back( { n, start, n } );
+    return pending;
+  }
+
+  /* the node on top of the stack is done */
+  uint8_t finish( uint8_t result )
+  {
+    if ( result == yes )
+    {
+      _order.push_back( _stack.back().n );
+    }
+    _stack.pop_back();
+    return result;
+  }
+
+  template<typename TT>
+  TT evaluate( uint32_t num_leaves )
+  {
+    std::vector<TT> values( _order.size() );
+    auto const value = [&]( node const& n ) -> TT {
+      if ( _kinds[n] == is_leaf )
+      {
+        return projection<TT>( _args[n], num_leaves );
+      }
+      return values[_args[n]];
+    };
+    auto const complement = []( TT const& v, bool c ) -> TT { return c ? ~v : v; };
+
+    for ( auto i = 0u; i < _order.size(); ++i )
+    {
+      auto const n = _order[i];
+      if ( _kinds[n] == is_constant )
+      {
+        auto const var = projection<TT>( 0u, num_leaves );
+        values[i] = var & ~var;
+      }
+      else if ( _kinds[n] == own_fanins )
+      {
+        auto const c0 = _ntk.get_child0( n );
+        auto const c1 = _ntk.get_child1( n );
+        values[i] = complement( value( _ntk.get_node( c0 ) ), _ntk.is_complemented( c0 ) ) &
+                    complement( value( _ntk.get_node( c1 ) ), _ntk.is_complemented( c1 ) );
+      }
+      else
+      {
+        values[i] = complement( value( _args[n] ), _ntk.phase( n ) != _ntk.phase( _args[n] ) );
+      }
+      _args[n] = i;
+    }
+    return _order.empty() ? projection<TT>( 0u, num_leaves ) : values.back();
+  }
+
+  template<typename TT>
+  static TT projection( uint32_t var, uint32_t num_leaves )
+  {
+    if constexpr ( std::is_same_v<TT, uint64_t> )
+    {
+      (void)num_leaves;
+      return kitty::detail::projections[var];
+    }
+    else
+    {
+      TT tt( num_leaves );
+      kitty::create_nth_var( tt, var );
+      return tt;
+    }
+  }
+
+  static uint64_t word_mask( uint32_t num_leaves )
+  {
+    return num_leaves >= 6u ? ~uint64_t( 0u ) : ( uint64_t( 1u ) << ( 1u << num_leaves ) ) - 1u;
+  }
+
+private:
+  Ntk const& _ntk;
+  std::vector<uint32_t> const& _topo_pos;
+  std::vector<uint32_t> _stamps;
+  std::vector<uint8_t> _kinds;
+  std::vector<uint32_t> _args;       // the variable of a leaf, the choice node of a representative, then the slot of a node in _order
+  std::vector<node> _order;
+  std::vector<frame> _stack;
+  uint32_t _stamp{0u};
+  uint32_t _min_pos{0u};
+};
+
+} // namespace detail
+
+iFPGA_NAMESPACE_HEADER_END
@@ -20,11 +20,14 @@
 #include "utils/common_properties.hpp"
 #include "cut/cut_enumeration.hpp"
 #include "cut/general_cut_enumeration.hpp"
+#include "cut/detail/cut_lifetime.hpp"
 
 #include "views/mapping_view.hpp"
 #include "techmap-lib/lut_cell_lib.hpp"
 #include "detail/map_qor.hpp"
+#include "detail/cut_cone_function.hpp"
 #include "debugger.hpp"
+#include "utils/tic_toc.hpp"
 
 #include <iostream>
 #include <cstring>
@@ -32,6 +35,7 @@
 #include <tuple>
 #include <numeric>
 #include <algorithm>
+#include <iterator>
 #include <memory>
 #include <cmath>
 #include <queue>
@@ -39,6 +43,11 @@
 #include <set>
 #include <assert.h>
 #include <type_traits>
+#include <atomic>
+#include <mutex>
+#include <array>
+#include <string>
+#include <sstream>
 
 iFPGA_NAMESPACE_HEADER_START
 
@@ -76,6 +85,21 @@ struct klut_mapping_storage
 };
 
 
+/**
+ * @brief a round of the mapping schedule
+ */
+struct klut_mapping_round
+{
+  uint8_t      mode{0u};              // 0 delay without reference updates, 1 area flow, 2 exact area
+  ETypeCmp     sort{ETC_DELAY};       // sort mode of the cuts, ETC_DELAY, ETC_DELAY2 or ETC_AREA
+  bool         preprocess{false};     // a preprocessing round
+
+  bool operator==( klut_mapping_round const& other ) const
+  {
+    return mode == other.mode && sort == other.sort && preprocess == other.preprocess;
+  }
+};
+
 struct klut_mapping_params
 {
   klut_mapping_params()
@@ -101,44 +125,163 @@ struct klut_mapping_params
   float        fAndArea{1.0f};
   float        fEpsilon{0.005f};
   bool         bDebug{false};
+  bool         bReclaimCuts{true};    // return the cut set of a node to a pool once its readers are mapped
+  bool         bBoundedCuts{true};    // skip the pairs of cuts whose cut cannot change the full cut set of a node, off with minimize_truth_table
+  bool         bReuseCuts{false};     // replay the last merge of a node while the cut sets of its fanins stay, off with minimize_truth_table
+  std::vector<klut_mapping_round> schedule;  // the rounds in order, empty for the ones of bPreprocess, bArea, uFlowIters and uAreaIters
   bool         verbose{false};
 };
 
+/**
+ * @brief the rounds of bPreprocess, bArea, uFlowIters and uAreaIters:
+ *  the delay, delay-2 and area sorted preprocessing rounds, or a single delay round,
+ *  then the area flow rounds and the exact area rounds
+ */
+inline std::vector<klut_mapping_round> default_mapping_schedule( klut_mapping_params const& ps )
+{
+  std::vector<klut_mapping_round> schedule;
+  if ( ps.bPreprocess && !ps.bArea )
+  {
+    schedule.push_back( { 0u, ETC_DELAY, true } );
+    schedule.push_back( { 0u, ETC_DELAY2, true } );
+    schedule.push_back( { 0u, ETC_AREA, true } );
+  }
+  else
+  {
+    schedule.push_back( { 0u, ps.bArea ? ETC_AREA : ETC_DELAY, false } );
+  }
+  schedule.insert( schedule.end(), ps.uFlowIters, { 1u, ETC_AREA, false } );
+  schedule.insert( schedule.end(), ps.uAreaIters, { 2u, ETC_AREA, false } );
+  return schedule;
+}
+
+/**
+ * @brief reads a mapping schedule, a preset or rounds "mode:sort[:p]" separated by commas,
+ *  mode in delay, flow, area and sort in delay, delay2, area, p for a preprocessing round
+ *  the presets: "default" is empty, for the rounds of the parameters, "fast" runs the delay,
+ *  area flow and exact area rounds once, "fastest" the delay round only
+ *
+ * @return false for an unknown round, or a schedule not starting with a delay round
+ */
+inline bool parse_mapping_schedule( std::string const& text, std::vector<klut_mapping_round>& schedule )
+{
+  schedule.clear();
+  if ( text == "default" )
+  {
+    return true;
+  }
+  if ( text == "fast" )
+  {
+    schedule = { { 0u, ETC_DELAY, true }, { 1u, ETC_AREA, false }, { 2u, ETC_AREA, false } };
+    return true;
+  }
+  if ( text == "fastest" )
+  {
+    schedule = { { 0u, ETC_DELAY, false } };
+    return true;
+  }
+
+  static std::array<std::string, 3> const modes = { "delay", "flow", "area" };
+  static std::array<std::pair<std::string, ETypeCmp>, 3> const sorts = { { { "delay", ETC_DELAY }, { "delay2", ETC_DELAY2 }, { "area", ETC_AREA } } };
+  std::stringstream rounds( text );
+  std::string round;
+  while ( std::getline( rounds, round, ',' ) )
+  {
+    std::stringstream fields( round );
+    std::string mode, sort, preprocess;
+    std::getline( fields, mode, ':' );
+    std::getline( fields, sort, ':' );
+    std::getline( fields, preprocess, ':' );
+    auto const m = std::find( modes.begin(), modes.end(), mode );
+    auto const o = std::find_if( sorts.begin(), sorts.end(), [&]( auto const& p ) { return p.first == sort; } );
+    if ( m == modes.end() || o == sorts.end() || !( preprocess.empty() || preprocess == "p" ) || !fields.eof() )
+    {
+      schedule.clear();
+      return false;
+    }
+    schedule.push_back( { static_cast<uint8_t>( m - modes.begin() ), o->second, preprocess == "p" } );
+  }
+  if ( schedule.empty() || schedule.front().mode != 0u )
+  {
+    schedule.clear();
+    return false;
+  }
+  return true;
+}
+
+/**
+ * @brief writes a mapping schedule as the rounds parse_mapping_schedule reads
+ */
+inline std::string mapping_schedule_to_string( std::vector<klut_mapping_round> const& schedule )
+{
+  static std::array<char const*, 3> const modes = { "delay", "flow", "area" };
+  std::string text;
+  for ( auto const& round : schedule )
+  {
+    if ( !text.empty() )
+    {
+      text += ',';
+    }
+    text += modes[round.mode];
+    text += round.sort == ETC_AREA ? ":area" : round.sort == ETC_DELAY2 ? ":delay2" : ":delay";
+    if ( round.preprocess )
+    {
+      text += ":p";
+    }
+  }
+  return text;
+}
+
 struct klut_mapping_stats
 {
   float_t delay{0.0f};
   float_t area{0.0f};
   float_t edge{0.0f};
+  uint32_t peak_cut_sets{0u};   // the largest number of cut sets holding cuts at once
+  uint64_t merges{0u};          // the pairs of cuts merged
+  uint64_t reuses{0u};          // the cut sets replayed from the merged cuts of their last merge
+  std::vector<double> round_times;  // the seconds of each mapping round, required times included
 
   void report() const
   {
     printf( "[i] Delay = %0.6f\n", delay );
     printf( "[i] Area  = %0.6f\n", area  );
     printf( "[i] Edge  = %0.6f\n", edge  );
+    printf( "[i] Peak cut sets = %u\n", peak_cut_sets );
+    printf( "[i] Merges = %lu\n", merges );
+    printf( "[i] Reuses = %lu\n", reuses );
+    for ( auto i = 0u; i < round_times.size(); ++i )
+    {
+      printf( "[i] Round %u = %0.3f s\n", i + 1u, round_times[i] );
+    }
   }
 };
 
 namespace detail
 {
-template<class Ntk, bool StoreFunction, typename CutData = iFPGA_NAMESPACE::general_cut_data>
+template<class Ntk, bool StoreFunction, typename CutData = iFPGA_NAMESPACE::general_cut_data, typename Config = iFPGA_NAMESPACE::default_cut_config>
 class klut_mapping_impl
 {
   public:
-    using network_cuts_t         = iFPGA_NAMESPACE::network_cuts<Ntk, StoreFunction, CutData>;
-    using cut_enumeration_impl_t = iFPGA_NAMESPACE::detail::cut_enumeration_impl<Ntk, StoreFunction, CutData>;
+    using network_cuts_t         = iFPGA_NAMESPACE::network_cuts<Ntk, StoreFunction, CutData, Config>;
+    using cut_enumeration_impl_t = iFPGA_NAMESPACE::detail::cut_enumeration_impl<Ntk, StoreFunction, CutData, Config>;
     using cut_t                  = typename network_cuts_t::cut_t;
     using cut_set_t              = typename network_cuts_t::cut_set_t;
     using node_t                 = typename Ntk::node;
     using klut_storage           = klut_mapping_storage<Ntk, CutData>;
     static constexpr node_t AIG_NULL = Ntk::AIG_NULL;
+    static constexpr uint32_t max_cut_num = network_cuts_t::max_cut_num;
 
     klut_mapping_impl(Ntk& ntk, klut_mapping_params const& ps, klut_mapping_stats const& st)
       : _ntk(ntk),
         _storage( std::make_shared<klut_storage>(ntk.size()) ),
         _ps(std::make_shared<klut_mapping_params>(ps)),
         _st(std::make_shared<klut_mapping_stats>(st)),
-        _cut_network(ntk.size())
-    { }
+        _cut_network(ntk.size(), !ps.bReclaimCuts, ps.cut_enumeration_ps.truth_tables)
+    {
+      assert( ps.cut_enumeration_ps.cut_limit < max_cut_num && "cut_limit exceeds the compile-time limit for the maximum number of cuts" );
+      assert( ps.cut_enumeration_ps.cut_size <= Config::max_leaves && "cut_size exceeds the compile-time limit for the maximum number of leaves" );
+    }
 
   public:
     /**
@@ -165,6 +308,10 @@ class klut_mapping_impl
      */
     float get_best_delay() const { return _storage->delay_current; }
     float get_best_area()  const { return _storage->area_current; }
+    uint64_t get_merges() const { return _cut_network.total_merges(); }
+    uint64_t get_reuses() const { return _reuses; }
+    std::vector<double> const& get_round_times() const { return _round_times; }
+    uint32_t get_peak_cut_sets() const { return _ps->bReclaimCuts ? _lifetime.peak() : static_cast<uint32_t>( _cut_network.nodes_size() ); }
 
   private:
     /**
@@ -172,19 +319,12 @@ class klut_mapping_impl
      */
     void init_parameters()
     {
-      _ps->bPreprocess   = true;    
-      _ps->bArea         = false;  
       _ps->bEdge         = true;  
       _ps->bPower        = false;  
       _ps->bFancy        = false;
       _ps->eSortMode     = ETC_DELAY;
       _ps->eCutMode      = ETM_DELAY;
       _ps->bUseLutLib    = false;
-      _ps->uFlowIters    = 1;
-      _ps->uAreaIters    = 2;
-      _ps->iDelayTraget  = -1;
-      _ps->fEpsilon      = 0.005f;
-      _ps->verbose       = false;
     }
 
     /**
@@ -196,6 +336,7 @@ class klut_mapping_impl
       uint32_t i;
 
       // compute trivial cut for constant and PIs
+      _lifetime.acquire( _cut_network, 0 );
       _cut_network.add_unit_cut( 0 );
       _cut_network.set_best_cut(0, _cut_network.cuts(0).best());
       _storage->arrival_times[0] = 0.0f;
@@ -203,6 +344,7 @@ class klut_mapping_impl
       _storage->est_refs[0] = 1.0f;
 
       _ntk.foreach_ci([&](auto const& n){
+        _lifetime.acquire( _cut_network, n );
         _cut_network.add_unit_cut( n );
         _cut_network.set_best_cut(n, _cut_network.cuts(n).best());
         _storage->arrival_times[n] = 0.0f;
@@ -212,40 +354,40 @@ class klut_mapping_impl
 
       // compute the topo-order
       topologize();
-      
-      // combinational mapping
-      if(_ps->bPreprocess && !_ps->bArea)
+
+      if(_ps->bReclaimCuts)
       {
-        // mapping for delay
-        perform_mapping_round(0, 1, 1 );  // delay
-        
-        // mapping for delay second option
-        _ps->bFancy = 1;
-        reset_refs();
-        perform_mapping_round(0, 1, 0 ); // delay-2
-        _ps->bFancy = 0;
-        
-        // mapping for area
-        _ps->bArea  = 1;
-        reset_refs();
-        perform_mapping_round(0, 1, 0 );   // area
-        _ps->bArea  = 0;
+        std::vector<node_t> gates;
+        std::copy_if( _storage->topo_order.begin(), _storage->topo_order.end(), std::back_inserter( gates ), [&]( auto n ){
+          return !_ntk.is_ci(n) && !_ntk.is_constant(n);
+        });
+        _lifetime.init( _ntk.size(), gates, [&]( auto n, auto&& fn ){ foreach_cut_dep( n, fn ); } );
       }
-      else
+
+      /* the replayed merges compute the functions of their cuts as the deferred ones, not the minimized ones */
+      if(_ps->cut_enumeration_ps.minimize_truth_table)
       {
-        perform_mapping_round(0, 0, 1 );  // delay
+        _ps->bReuseCuts = false;
       }
-
-      // area_flow oriented mapping
-      for(i = 0 ; i < _ps->uFlowIters; ++i)
+      if(_ps->bReuseCuts)
       {
-        perform_mapping_round(1, 0 , 0 );  // area flow
+        _cut_pools.resize( _ntk.size() );
+        _merge_versions.assign( _ntk.size(), {0u, 0u} );
+        _versions.assign( _ntk.size(), 0u );
+        _version_rounds.assign( _ntk.size(), 0u );
+        _cut_set_keys.resize( _ntk.size() );
       }
       
-      // area oriented mapping
-      for(i = 0 ; i < _ps->uAreaIters; ++i)
+      // combinational mapping, a delay round after the first one starts from the fanouts of the network
+      auto const schedule = _ps->schedule.empty() ? default_mapping_schedule( *_ps ) : _ps->schedule;
+      assert( !schedule.empty() && schedule.front().mode == 0u && "the schedule starts with a delay round" );
+      for(i = 0 ; i < schedule.size(); ++i)
       {
-        perform_mapping_round(2, 0 , 0 );  // area
+        if( i > 0u && schedule[i].mode == 0u )
+        {
+          reset_refs();
+        }
+        perform_mapping_round( schedule[i], i == 0u );
       }
 
       // get the mapped network from the flow!
@@ -255,68 +397,281 @@ class klut_mapping_impl
     /**
      * @brief the mapping rounds in every step
      * 
-     * @param mode        ETC_DELAY, ETC_FLOW, ETC_AREA   
-     * @param preprocess  toogles for preprocess
+     * @param round       the mode, the sort mode and the preprocess toogle of the round
      * @param first       mark the first mapping round
      */
-    void perform_mapping_round(int mode, bool preprocess, bool first)
+    void perform_mapping_round(klut_mapping_round const& round, bool first)
     {
       uint32_t i{0u};
+      int const mode = round.mode;
+      bool const preprocess = round.preprocess;
       assert(mode >= 0 && mode <= 2);
 
       if(mode == 2)
       {
         _ps->eCutMode = ETM_AREA;
-        gf_set_etm(ETM_AREA);
-
       }
       else
       {
         _ps->eCutMode = ETM_FLOW;
-        gf_set_etm(ETM_FLOW);
       }
       
-      if(mode || _ps->bArea)
+      _ps->eSortMode = round.sort;
+      _less.etc = _ps->eSortMode;
+      ++_round;
+      tic_toc timer;
+
+      // standard mapping steps for each node
+      _ntk.clear_visited();
+      _lifetime.start_round();
+
+      /* the gates take the versions of their cut sets as they are mapped, the sources before the round */
+      if(_ps->bReuseCuts)
       {
-        _ps->eSortMode = ETC_AREA;
-        gf_set_etc(ETC_AREA);
+        for(auto n : _storage->topo_order)
+        {
+          if(_ntk.is_ci(n) || _ntk.is_constant(n))
+          {
+            cut_set_version(n);
+          }
+        }
       }
-      else if( _ps->bFancy)
+
+      /* the area flow and area rounds deref and ref the best cuts around the merges, a node sees the
+         references left by the nodes before it in topo_order and the rounds stay serial */
+      if(mode == 0 && _ps->cut_enumeration_ps.num_threads > 1u)
       {
-        _ps->eSortMode = ETC_DELAY2;
-        gf_set_etc(ETC_DELAY2);
+        perform_mapping_wavefront(mode, preprocess, first);
       }
       else
       {
-        _ps->eSortMode = ETC_DELAY;
-        gf_set_etc(ETC_DELAY);
+        for(i = 0 ; i < _storage->topo_order.size(); ++i)
+        {
+          auto n = _storage->topo_order[i];
+          if(_ntk.is_ci(n) || _ntk.is_constant(n))
+            continue;
+          else{
+            _lifetime.acquire( _cut_network, n );
+            perform_mapping_and(n, mode, preprocess, first, _cut_network.truth_tables(), true);
+            if( _ntk.is_repr(n) )
+            {
+              perform_mapping_and_choice(n, mode, preprocess, _cut_network.cuts(n));
+            }
+            if(_ps->bReclaimCuts)
+            {
+              _lifetime.release( _cut_network, n, [&]( auto m, auto&& fn ){ foreach_cut_dep( m, fn ); } );
+            }
+          }
+        }
       }
 
-      // standard mapping steps for each node
       _ntk.clear_visited();
 
-      for(i = 0 ; i < _storage->topo_order.size(); ++i)
+      // an area sorted delay round leaves the nodes without required times, as area-oriented mapping does
+      compute_required_times( !_ps->bArea && !( mode == 0 && round.sort == ETC_AREA ) ); // some bugs here
+      _round_times.push_back( timer.toc() );
+
+      if(_ps->verbose)
+      {
+        printf("\t[Delay] %f \t", _storage->required_glo);
+        printf("[Area] %f \n", _storage->area_glo);
+      }
+    }
+
+    /**
+     * @brief the mapping round without reference updates (mode 0), by fanin-ready wavefront
+     *  a task maps a gate once the nodes it reads are mapped, and merges its choices if it is a representative;
+     *  the best cut of the gate then joins its cut set, as the first serial merge reading it does, and the
+     *  readers it was the last dependency of become ready.  A task goes on with the first of them and
+     *  spawns the others, so a narrow level does not wait for the whole of the level before.
+     *  The representative sees the cut set of a choice node as the serial round does.
+     *  the result does not depend on the number of threads and is the one of the serial round
+     */
+    void perform_mapping_wavefront(int mode, bool preprocess, bool first)
+    {
+      if(!_pending)
+      {
+        init_wavefront();
+      }
+      for(auto n : _storage->topo_order)
+      {
+        _pending[n].store( _num_deps[n], std::memory_order_relaxed );
+      }
+
+#pragma omp parallel num_threads( _ps->cut_enumeration_ps.num_threads )
+#pragma omp single
+      {
+        for(auto n : _sources)
+        {
+#pragma omp task firstprivate( n )
+          map_wavefront( n, mode, preprocess, first );
+        }
+      }
+    }
+
+    /**
+     * @brief maps a ready gate, then the readers it makes ready
+     */
+    void map_wavefront(node_t n, int mode, bool preprocess, bool first)
+    {
+      while(true)
+      {
+        if(_ps->bReclaimCuts)
+        {
+          std::lock_guard<std::mutex> lock( _lifetime_mutex );
+          _lifetime.acquire( _cut_network, n );
+        }
+        perform_mapping_and(n, mode, preprocess, first, _cut_network.truth_tables(), false);
+        snapshot_choice_cuts(n);
+        if( _ntk.is_repr(n) )
+        {
+          perform_mapping_and_choice(n, mode, preprocess, [&]( node_t m ) -> cut_set_t& { return choice_view(n, m); });
+        }
+        if( _first_fanout_pos[n] != UINT32_MAX )
+        {
+          _cut_network.cuts(n).insert( _cut_network.get_best_cut(n), _less );
+        }
+        if(_ps->bReuseCuts)
+        {
+          cut_set_version(n);
+        }
+        if(_ps->bReclaimCuts)
+        {
+          std::lock_guard<std::mutex> lock( _lifetime_mutex );
+          _lifetime.release( _cut_network, n, [&]( auto m, auto&& fn ){ foreach_cut_dep( m, fn ); } );
+        }
+
+        bool has_next = false;
+        node_t next{};
+        for(auto i = _reader_offsets[n]; i < _reader_offsets[n + 1u]; ++i)
+        {
+          node_t r = _readers[i];
+          if( _pending[r].fetch_sub( 1u, std::memory_order_acq_rel ) != 1u )
+            continue;
+          if(!has_next)
+          {
+            has_next = true;
+            next = r;
+            continue;
+          }
+#pragma omp task firstprivate( r )
+          map_wavefront( r, mode, preprocess, first );
+        }
+        if(!has_next)
+          return;
+        n = next;
+      }
+    }
+
+    /**
+     * @brief keeps the cut set of a choice node as its representative sees it, before its fanouts insert its best cut
+     */
+    void snapshot_choice_cuts(node_t const& n)
+    {
+      if( _choice_slots[n] == UINT32_MAX )
+        return;
+      auto& snapshot = _choice_cuts[_choice_slots[n]];
+      snapshot.clear();
+      for( auto const* c : _cut_network.cuts(n) )
+      {
+        snapshot.push_back( *c );
+      }
+    }
+
+    /**
+     * @brief the cut set of the choice node m as the serial round sees it when it maps its representative n,
+     *  with the best cut of m once a fanout of m was mapped
+     */
+    cut_set_t& choice_view(node_t const& n, node_t const& m)
+    {
+      auto& view = _choice_views[omp_get_thread_num()];
+      view.clear();
+      for( auto const& c : _choice_cuts[_choice_slots[m]] )
+      {
+        auto& copy = view.add_cut( c.begin(), c.end() );
+        copy.data() = c.data();
+      }
+      if( _first_fanout_pos[m] <= _topo_pos[n] )
+      {
+        view.insert( _cut_network.get_best_cut(m), _less );
+      }
+      return view;
+    }
+
+    /**
+     * @brief the readers of the gates and the gates ready at the start of a round
+     */
+    void init_wavefront()
+    {
+      _topo_pos.assign( _ntk.size(), 0u );
+      _first_fanout_pos.assign( _ntk.size(), UINT32_MAX );
+      _choice_slots.assign( _ntk.size(), UINT32_MAX );
+      _num_deps.assign( _ntk.size(), 0u );
+      _reader_offsets.assign( _ntk.size() + 1u, 0u );
+      auto const is_gate = [&]( node_t d ) { return !_ntk.is_ci(d) && !_ntk.is_constant(d); };
+      for(uint32_t i = 0; i < _storage->topo_order.size(); ++i)
       {
         auto n = _storage->topo_order[i];
-        if(_ntk.is_ci(n) || _ntk.is_constant(n))
+        _topo_pos[n] = i;
+        if( !is_gate(n) )
           continue;
-        else{
-          perform_mapping_and(n, mode, preprocess, first);
-          if( _ntk.is_repr(n) )
+        for( auto c : { _ntk.get_node( _ntk.get_child0(n) ), _ntk.get_node( _ntk.get_child1(n) ) } )
+        {
+          _first_fanout_pos[c] = std::min( _first_fanout_pos[c], i );
+        }
+        if( _ntk.is_repr(n) )
+        {
+          for( auto m = _ntk.get_equiv_node(n); m != AIG_NULL; m = _ntk.get_equiv_node(m) )
           {
-            perform_mapping_and_choice(n, mode, preprocess);
+            _choice_slots[m] = static_cast<uint32_t>( _choice_cuts.size() );
+            _choice_cuts.emplace_back();
           }
         }
+        foreach_cut_dep( n, [&]( auto d ) {
+          if( is_gate(d) )
+          {
+            ++_num_deps[n];
+            ++_reader_offsets[d + 1u];
+          }
+        });
+        if( _num_deps[n] == 0u )
+        {
+          _sources.push_back( n );
+        }
       }
 
-      _ntk.clear_visited();
-
-      compute_required_times(); // some bugs here
+      std::partial_sum( _reader_offsets.begin(), _reader_offsets.end(), _reader_offsets.begin() );
+      _readers.resize( _reader_offsets.back() );
+      auto next = _reader_offsets;
+      for(auto n : _storage->topo_order)
+      {
+        if( !is_gate(n) )
+          continue;
+        foreach_cut_dep( n, [&]( auto d ) {
+          if( is_gate(d) )
+          {
+            _readers[next[d]++] = n;
+          }
+        });
+      }
+      _pending = std::make_unique<std::atomic<uint32_t>[]>( _ntk.size() );
+      _choice_views.resize( _ps->cut_enumeration_ps.num_threads );
+    }
 
-      if(_ps->verbose)
+    /**
+     * @brief calls fn on the nodes whose cut sets the mapping of a gate reads, its fanins and its choice nodes
+     */
+    template<typename Fn>
+    void foreach_cut_dep(node_t const& n, Fn&& fn)
+    {
+      fn( _ntk.get_node( _ntk.get_child0(n) ) );
+      fn( _ntk.get_node( _ntk.get_child1(n) ) );
+      if( _ntk.is_repr(n) )
       {
-        printf("\t[Delay] %f \t", _storage->required_glo);
-        printf("[Area] %f \n", _storage->area_glo);
+        for( auto m = _ntk.get_equiv_node(n); m != AIG_NULL; m = _ntk.get_equiv_node(m) )
+        {
+          fn( m );
+        }
       }
     }
 
@@ -327,8 +682,12 @@ class klut_mapping_impl
      * @param mode 
      * @param preprocess 
      * @param first 
+     * @param cache the truth table pool of the new cuts
+     * @param insert_best whether the best cuts of the fanins are inserted in their cut sets here
+     * @return whether the best cut was updated
      */
-    void perform_mapping_and(node_t const& n, int mode, bool preprocess, bool first)
+    template<typename Cache>
+    bool perform_mapping_and(node_t const& n, int mode, bool preprocess, bool first, Cache& cache, bool insert_best)
     {
       // compute the estmate ref
       if(mode == 0)
@@ -347,15 +706,17 @@ class klut_mapping_impl
       }
 
       // generate cuts
-      merge_cuts(n);
+      merge_cuts(n, cache, insert_best);
 
       // update the best cut without increasing the delay, trival cut can not be the best cut of the node itself
+      bool updated = false;
       if( (_cut_network.cuts(n).best().size() < 1u) || 
           (_cut_network.cuts(n).best()->data.delay < _storage->require_times[n] + _ps->fEpsilon) || 
           (_ps->bZeroGain && _cut_network.cuts(n).best()->data.delay == _storage->require_times[n] + _ps->fEpsilon) )
       {
         _cut_network.set_best_cut(n, _cut_network.cuts(n).best());
         _storage->arrival_times[n] = _cut_network.get_best_cut(n)->data.delay;
+        updated = true;
       }
 
       // ref the best cut
@@ -364,7 +725,7 @@ class klut_mapping_impl
         cut_area_ref(_cut_network.get_best_cut(n));
       }
 
-      return;
+      return updated;
     }
 
     /**
@@ -373,8 +734,10 @@ class klut_mapping_impl
      * @param n the representation node of this equivalent class
      * @param mode 
      * @param preprocess 
+     * @param choice_cuts the cut set of a choice node, or a function returning it
      */
-    void perform_mapping_and_choice(node_t const& n, int mode, bool preprocess)
+    template<typename ChoiceCuts>
+    void perform_mapping_and_choice(node_t const& n, int mode, bool preprocess, ChoiceCuts&& choice_cuts)
     {
       // deref the best cut
       if(mode && _storage->refs[n] > 0u)
@@ -387,13 +750,19 @@ class klut_mapping_impl
 
       while(next_choice_node != AIG_NULL)
       {
-        if( _cut_network.cuts(next_choice_node).size() ==0 )
+        decltype(auto) next_cuts = [&]() -> decltype(auto) {
+          if constexpr ( std::is_invocable_v<ChoiceCuts, node_t> )
+            return choice_cuts(next_choice_node);
+          else
+            return _cut_network.cuts(next_choice_node);
+        }();
+        if( next_cuts.size() ==0 )
         {
           next_choice_node = _ntk.get_equiv_node(next_choice_node);
           continue;
         }
         auto cut_phase = _ntk.phase(n) ^ _ntk.phase(next_choice_node);
-        for( auto it = _cut_network.cuts(next_choice_node).begin(); it != _cut_network.cuts(next_choice_node).end(); ++it )
+        for( auto it = next_cuts.begin(); it != next_cuts.end(); ++it )
         {
           if( (**it).size() < 2 ) // skip the trival cut
             continue;
@@ -401,11 +770,14 @@ class klut_mapping_impl
           if( mode != ETC_DELAY && (**it)->data.delay > _storage->require_times[next_choice_node] + _ps->fEpsilon )
             continue;
           cut_t tc = **it;
-          if( cut_phase )
+          if constexpr ( StoreFunction )
           {
-            tc->func_id ^= 1;
+            if( cut_phase )
+            {
+              network_cuts_t::complement_truth_table( tc );
+            }
           }
-          cuts_repr.insert(tc);
+          cuts_repr.insert(tc, _less);
         }
 
         _cut_network.cuts( n ).limit( _ps->cut_enumeration_ps.cut_limit-1);
@@ -472,8 +844,10 @@ class klut_mapping_impl
 
     /**
      * @brief compute require_times of current network
+     *
+     * @param propagate whether the required times of the POs are propagated to the nodes
      */
-    void compute_required_times()
+    void compute_required_times(bool propagate)
     {
       // step1 computes area, references and nodes used in the mapping!
       std::fill(_storage->require_times.begin(), _storage->require_times.end(), std::numeric_limits<float>::max());
@@ -497,7 +871,7 @@ class klut_mapping_impl
         _storage->require_times[  _ntk.get_node(s) ] = _storage->required_glo;
       });
 
-      if( _ps->bArea )
+      if( !propagate )
         return;
       
       // propagate required times from POs to PIs
@@ -590,15 +964,26 @@ class klut_mapping_impl
         mark_ref_rec(n);
       });
 
+      std::vector< node_t > mapped;
       for(auto it = _storage->topo_order.rbegin(); it != _storage->topo_order.rend(); ++it)
       {
         auto n = *it;
-
         if( _storage->refs[n] == 0u || _ntk.is_ci(n) || _ntk.is_constant(n) )
           continue;
-
         assert( _cut_network.get_best_cut(n).size() > 1);
+        mapped.emplace_back( n );
+      }
 
+      /* without functions in the cuts, the functions of the best cuts are simulated on their cones */
+      std::vector< kitty::dynamic_truth_table > functions;
+      if constexpr ( !StoreFunction && has_set_cell_function_v<Ntk> )
+      {
+        functions = compute_cone_functions( mapped );
+      }
+
+      for( uint32_t i = 0; i < mapped.size(); ++i )
+      {
+        auto n = mapped[i];
         std::vector< node_t > nodes;
         for( auto leaf : _cut_network.get_best_cut(n) )
         {
@@ -611,12 +996,41 @@ class klut_mapping_impl
         {
           _ntk.set_cell_function( n, _cut_network.truth_table( _cut_network.get_best_cut(n) ));
         }
+        else if constexpr ( has_set_cell_function_v<Ntk> )
+        {
+          _ntk.set_cell_function( n, functions[i] );
+        }
       }
       _storage->delay_current = tmp_delay;
       _storage->area_current  = tmp_area;
       return;
     }
 
+    /**
+     * @brief the functions of the best cuts of the mapped nodes, one cone simulation per cut,
+     *  the nodes shared among the threads
+     */
+    std::vector< kitty::dynamic_truth_table > compute_cone_functions( std::vector< node_t > const& mapped )
+    {
+      _topo_pos.assign( _ntk.size(), 0u );
+      for(uint32_t i = 0; i < _storage->topo_order.size(); ++i)
+      {
+        _topo_pos[_storage->topo_order[i]] = i;
+      }
+
+      std::vector< kitty::dynamic_truth_table > functions( mapped.size() );
+#pragma omp parallel num_threads( _ps->cut_enumeration_ps.num_threads )
+      {
+        detail::cut_cone_function<Ntk> cone( _ntk, _topo_pos );
+#pragma omp for schedule( dynamic, 256 )
+        for( int64_t i = 0; i < static_cast<int64_t>( mapped.size() ); ++i )
+        {
+          functions[i] = cone( mapped[i], _cut_network.get_best_cut( mapped[i] ) );
+        }
+      }
+      return functions;
+    }
+
 #pragma region cut data
 
   float lut_area(cut_t const& cut)  
@@ -795,16 +1209,36 @@ class klut_mapping_impl
     return edge_flow;
   }
 
+  /**
+   * @brief the cost the cuts are sorted by
+   */
+  float sort_cost(cut_t const& cut) const
+  {
+    return _ps->eSortMode == ETC_AREA ? cut->data.area : cut->data.delay;
+  }
+
+  /**
+   * @brief the sort cost of the leaves of a fanin cut, a lower bound of the cost of its merges
+   */
+  float leaves_cost(cut_t const& cut)
+  {
+    if(_ps->eSortMode != ETC_AREA)
+      return cut_delay(cut);
+    return _ps->eCutMode == ETM_AREA ? cut_area_derefed(cut) : cut_area_flow(cut);
+  }
+
 #pragma endregion cut data
 
 #pragma region Cut Enumeration
 
-    void merge_cuts(uint32_t index)
+    template<typename Cache>
+    void merge_cuts(uint32_t index, Cache& cache, bool insert_best)
     {
       auto n = _ntk.index_to_node( index );
       const auto fanin = 2;
       uint32_t pairs{1};
       std::array<uint32_t, 2> children_id;      // store the children's index
+      std::array<cut_set_t*, 3> _lcuts;         // tmp cuts for merge
 
       auto child0_index = _ntk.get_node( _ntk.get_child0(n) );
       auto child1_index = _ntk.get_node( _ntk.get_child1(n) );
@@ -828,53 +1262,165 @@ class klut_mapping_impl
 
       std::vector<cut_t const*> vcuts( fanin );
 
-      _cut_network.incre_total_tuples(pairs);
-
       // insert best cut for cut generation
-      _lcuts[0]->insert( _cut_network.get_best_cut(child0_index) );
-      _lcuts[1]->insert( _cut_network.get_best_cut(child1_index) );
+      if(insert_best)
+      {
+        _lcuts[0]->insert( _cut_network.get_best_cut(child0_index), _less );
+        _lcuts[1]->insert( _cut_network.get_best_cut(child1_index), _less );
+      }
 
-      for ( auto const& c1 : *_lcuts[0] )
+      /* the merges of a node depend on the cut sets of its fanins only, their cuts are replayed while both stay */
+      std::array<uint32_t, 2> versions{0u, 0u};
+      bool reuse = false;
+      if(_ps->bReuseCuts)
       {
-        for ( auto const& c2 : *_lcuts[1] )
+        versions = { cut_set_version(child0_index), cut_set_version(child1_index) };
+        reuse = _merge_versions[index] == versions;
+      }
+
+      if(!reuse)
+      {
+        _cut_network.incre_total_tuples(pairs);
+      }
+
+      /**
+       * once rcuts is full, a pair is skipped when its cut can neither enter rcuts nor remove a cut of it:
+       * the sort cost of a merged cut is at least the one of each fanin cut, and it dominates no cut of
+       * rcuts whose signature misses one of its leaves.  The skipped pairs leave rcuts as it would be.
+       * Minimized functions drop the leaves they do not depend on, so neither holds and no pair is skipped.
+       * A merge recorded for bReuseCuts keeps the skipped pairs too, the rounds replaying it may need them.
+       */
+      bool const bounded = _ps->bBoundedCuts && !_ps->cut_enumeration_ps.minimize_truth_table;
+      float bound{0.0f};
+      std::array<std::array<float, max_cut_num>, 2> costs;  // the leaves costs of the fanin cuts, negative until needed
+      costs[0].fill( -1.0f );
+      costs[1].fill( -1.0f );
+      auto const cost = [&]( uint32_t fanin, uint32_t i ) {
+        auto& c = costs[fanin][i];
+        if ( c < 0.0f )
+        {
+          c = leaves_cost( ( *_lcuts[fanin] )[i] );
+        }
+        return c;
+      };
+
+      /* without minimization the functions do not change the cuts, only the kept ones get theirs */
+      bool const defer_truth = StoreFunction && !_ps->cut_enumeration_ps.minimize_truth_table;
+      std::array<std::array<cut_t const*, 2>, max_cut_num> origins;
+      uint32_t merges{0u};
+
+      auto const skip = [&]( uint32_t i, uint32_t j, uint64_t sign ) {
+        return bounded && rcuts.size() == max_cut_num &&
+               ( bound < cost( 0u, i ) - gv_eps || bound < cost( 1u, j ) - gv_eps ) && !rcuts.may_dominate( sign );
+      };
+      auto const add = [&]( cut_t& cut, cut_t const* c1, cut_t const* c2 ) {
+        if ( rcuts.is_dominated( cut ) )
         {
-          if ( !c1->merge( *c2, new_cut, _ps->cut_enumeration_ps.cut_size ) )
+          return;
+        }
+
+        if constexpr ( StoreFunction )
+        {
+          if ( !defer_truth )
           {
-            continue;
+            vcuts[0] = c1;
+            vcuts[1] = c2;
+            compute_truth_table( index, vcuts, cut, cache );
           }
+        }
+        compute_cut_data(cut);
 
-          if ( rcuts.is_dominated( new_cut ) )
+        auto const* icut = rcuts.insert( cut, _less );
+        if ( icut == nullptr )
+        {
+          return;
+        }
+        if ( defer_truth )
+        {
+          origins[rcuts.slot( *icut )] = { c1, c2 };
+        }
+        if ( bounded && rcuts.size() == max_cut_num )
+        {
+          bound = sort_cost( rcuts[0] );
+          for ( auto const* c : rcuts )
           {
-            continue;
+            bound = std::max( bound, sort_cost( *c ) );
           }
+        }
+      };
 
-          if constexpr ( StoreFunction )
+      if ( reuse )
+      {
+        for ( auto& m : _cut_pools[index] )
+        {
+          if ( !skip( m.i, m.j, m.cut.signature() ) )
           {
-            vcuts[0] = c1;
-            vcuts[1] = c2;
-            new_cut->func_id = compute_truth_table( index, vcuts, new_cut );
+            add( m.cut, &( *_lcuts[0] )[m.i], &( *_lcuts[1] )[m.j] );
           }
-          // compute cut data for new_cut
-          if(gf_get_etm() ==  ETM_AREA)
+        }
+#pragma omp atomic
+        ++_reuses;
+      }
+      else
+      {
+        auto* pool = _ps->bReuseCuts ? &_cut_pools[index] : nullptr;
+        if ( pool != nullptr )
+        {
+          pool->clear();
+        }
+        for ( auto i = 0u; i < _lcuts[0]->size(); ++i )
+        {
+          auto const* c1 = &( *_lcuts[0] )[i];
+          /* the pairs whose signatures have too many leaves are skipped at once */
+          for ( auto mask = _lcuts[1]->mergeable( *c1, _ps->cut_enumeration_ps.cut_size ); mask; mask &= mask - 1u )
           {
-            new_cut->data.area  = cut_area_derefed(new_cut);
-            new_cut->data.edge  = cut_edge_derefed(new_cut);
-            new_cut->data.delay = cut_delay(new_cut);
+            auto const j = static_cast<uint32_t>( __builtin_ctz( mask ) );
+            auto const* c2 = &( *_lcuts[1] )[j];
+            if ( pool == nullptr && skip( i, j, c1->signature() | c2->signature() ) )
+            {
+              continue;
+            }
+
+            ++merges;
+            if ( !c1->merge( *c2, new_cut, _ps->cut_enumeration_ps.cut_size ) )
+            {
+              continue;
+            }
+            if ( pool != nullptr )
+            {
+              pool->push_back( { new_cut, static_cast<uint8_t>( i ), static_cast<uint8_t>( j ) } );
+            }
+            add( new_cut, c1, c2 );
           }
-          else
+        }
+        if ( pool != nullptr )
+        {
+          _merge_versions[index] = versions;
+        }
+      }
+      _cut_network.incre_total_merges( merges );
+
+      auto const compute_deferred = [&]() {
+        if constexpr ( StoreFunction )
+        {
+          for ( auto* c : rcuts )
           {
-            new_cut->data.area  = cut_area_flow(new_cut);
-            new_cut->data.edge  = cut_edge_flow(new_cut);
-            new_cut->data.delay = cut_delay(new_cut);
+            auto const& origin = origins[rcuts.slot( *c )];
+            vcuts[0] = origin[0];
+            vcuts[1] = origin[1];
+            compute_truth_table( index, vcuts, *c, cache );
           }
-
-          rcuts.insert( new_cut );
         }
-      }
-      
+      };
+
       /* limit the maximum number of _cut_network, and reserve one position for trival cut */
       rcuts.limit( _ps->cut_enumeration_ps.cut_limit - 1 );
 
+      if ( defer_truth )
+      {
+        compute_deferred();
+      }
+
       _cut_network.incre_total_cuts(rcuts.size());
       /* add trival cut ,and it directlt add at the end of _cut_network */ 
       if ( rcuts.size() > 1 || ( *rcuts.begin() )->size() > 1 )
@@ -883,15 +1429,89 @@ class klut_mapping_impl
       }
     }
 
-    uint32_t compute_truth_table( uint32_t index, std::vector<cut_t const*> const& vcuts, cut_t& res )
+    /**
+     * @brief the cost of a cut under the cut mode of the round
+     */
+    void compute_cut_data(cut_t& cut)
+    {
+      if(_ps->eCutMode ==  ETM_AREA)
+      {
+        cut->data.area  = cut_area_derefed(cut);
+        cut->data.edge  = cut_edge_derefed(cut);
+        cut->data.delay = cut_delay(cut);
+      }
+      else
+      {
+        cut->data.area  = cut_area_flow(cut);
+        cut->data.edge  = cut_edge_flow(cut);
+        cut->data.delay = cut_delay(cut);
+      }
+    }
+
+    /**
+     * @brief the version of the cut set of a node as its readers merge it, once its cuts are final in the round
+     *  the version changes when the leaves or the functions of the cuts, or their order, differ from the ones
+     *  of the last round.  The costs of the cuts are not part of it
+     */
+    uint32_t cut_set_version(uint32_t index)
+    {
+      if ( _version_rounds[index] == _round )
+      {
+        return _versions[index];
+      }
+      _version_rounds[index] = _round;
+
+      auto& key = _cut_set_keys[index];
+      auto const size = key.size();
+      auto pos = 0u;
+      bool same = true;
+      auto const push = [&]( uint64_t word ) {
+        same = same && pos < size && key[pos] == word;
+        if ( pos < size )
+        {
+          key[pos] = word;
+        }
+        else
+        {
+          key.push_back( word );
+        }
+        ++pos;
+      };
+      for ( auto const* c : _cut_network.cuts( index ) )
+      {
+        push( c->size() );
+        for ( auto leaf : *c )
+        {
+          push( leaf );
+        }
+        if constexpr ( StoreFunction )
+        {
+          push( c->size() <= max_word_cut_size ? ( *c )->func_word : ( *c )->func_id );
+        }
+      }
+      if ( !same || pos != size )
+      {
+        key.resize( pos );
+        ++_versions[index];
+      }
+      return _versions[index];
+    }
+
+    template<typename Cache>
+    void compute_truth_table( uint32_t index, std::vector<cut_t const*> const& vcuts, cut_t& res, Cache& cache )
     {
+      if ( res.size() <= max_word_cut_size )
+      {
+        _cut_network.compute_word_function( _ntk, _ntk.index_to_node( index ), vcuts, res, _ps->cut_enumeration_ps.minimize_truth_table );
+        return;
+      }
+
       std::vector<kitty::dynamic_truth_table> tt( vcuts.size() );
       auto i = 0;
 
       for ( auto const& cut : vcuts )
       {
-        assert( ( ( *cut )->func_id >> 1 ) <= _cut_network.truth_cache_size() );
-        tt[i] = kitty::extend_to( _cut_network.at(( *cut )->func_id), res.size() );
+        tt[i] = kitty::extend_to( _cut_network.truth_table( *cut ), res.size() );
         const auto supp = _cut_network.compute_truth_table_support( *cut, res );
         kitty::expand_inplace( tt[i], supp );
         ++i;
@@ -915,11 +1535,17 @@ class klut_mapping_impl
             *it_leaves++ = leaves_before[*it_support++];
           }
           res.set_leaves( leaves_after.begin(), leaves_after.end() );
-          return _cut_network.insert_truth_table( tt_res_shrink );
+          if ( res.size() <= max_word_cut_size )
+          {
+            res->func_word = detail::truth_table_to_word( tt_res_shrink );
+            return;
+          }
+          res->func_id = cache.insert( tt_res_shrink );
+          return;
         }
       }
 
-      return _cut_network.insert_truth_table( tt_res );
+      res->func_id = cache.insert( tt_res );
     }
 
 
@@ -1023,15 +1649,17 @@ class klut_mapping_impl
     void print_params()
     {
       printf("\033[0;32;40m KLUT-Mapper-Params: \033[0m \n");
-      printf("cut-size   : %d, default 4\n", _ps->cut_enumeration_ps.cut_size);
-      printf("cut-limit  : %d, default 8\n", _ps->cut_enumeration_ps.cut_limit);
-      printf("preprocess : %d, default 1\n", _ps->bPreprocess);
-      printf("area       : %d, default 0\n", _ps->bArea);
-      printf("edge       : %d, default 1\n", _ps->bEdge);
-      printf("power      : %d, default 0\n", _ps->bPower);
-      printf("fancy      : %d, default 0\n", _ps->bFancy);
-      printf("flow-iters : %d, default 1\n", _ps->uFlowIters);
-      printf("area-iters : %d, default 2\n", _ps->uAreaIters);
+      auto const schedule = _ps->schedule.empty() ? default_mapping_schedule( *_ps ) : _ps->schedule;
+      printf("cut-size   : %d\n", _ps->cut_enumeration_ps.cut_size);
+      printf("cut-limit  : %d\n", _ps->cut_enumeration_ps.cut_limit);
+      printf("edge       : %d\n", _ps->bEdge);
+      printf("power      : %d\n", _ps->bPower);
+      printf("fancy      : %d\n", _ps->bFancy);
+      printf("threads    : %u\n", _ps->cut_enumeration_ps.num_threads);
+      printf("reclaim    : %d\n", _ps->bReclaimCuts);
+      printf("bounded    : %d\n", _ps->bBoundedCuts && !_ps->cut_enumeration_ps.minimize_truth_table);
+      printf("reuse      : %d\n", _ps->bReuseCuts);
+      printf("schedule   : %s\n", mapping_schedule_to_string( schedule ).c_str());
     }
 
     void print_storage()
@@ -1073,17 +1701,59 @@ class klut_mapping_impl
     std::shared_ptr<klut_mapping_stats>   _st;
 
     network_cuts_t                        _cut_network;
-    std::array<cut_set_t*, Ntk::max_fanin_size + 1> _lcuts; // tmp cuts for merge
+    detail::cut_lifetime<network_cuts_t>  _lifetime;          // the cut sets of the frontier, with bReclaimCuts
+
+    // the wavefront rounds
+    std::vector<uint32_t>                 _num_deps;          // the gates a gate reads the cut sets of
+    std::vector<uint32_t>                 _reader_offsets;    // the readers of a gate in _readers
+    std::vector<node_t>                   _readers;
+    std::vector<node_t>                   _sources;           // the gates reading no gate
+    std::unique_ptr<std::atomic<uint32_t>[]> _pending;        // the dependencies of a gate not yet mapped in the round
+    std::mutex                            _lifetime_mutex;
+    std::vector<uint32_t>                 _topo_pos;          // the position of a node in topo_order
+    std::vector<uint32_t>                 _first_fanout_pos;  // the first position of a fanout of a node in topo_order
+    std::vector<uint32_t>                 _choice_slots;      // the slot of a choice node in _choice_cuts
+    std::vector<std::vector<cut_t>>       _choice_cuts;       // the cut sets of the choice nodes after their mapping
+    std::vector<cut_set_t>                _choice_views;      // the cut set of a choice node seen by its representative, per thread
+    general_cut_less                      _less;              // sorts the cuts by the mode of the round
+    uint32_t                              _round{0u};         // the number of the current mapping round, from 1
+
+    // the merges replayed, with bReuseCuts
+    struct merged_cut
+    {
+      cut_t   cut;
+      uint8_t i;                                              // the positions of its cuts in the cut sets of the fanins
+      uint8_t j;
+    };
+    std::vector<std::vector<merged_cut>>  _cut_pools;         // the merged cuts of the last merge of a node, in order
+    std::vector<std::array<uint32_t, 2>>  _merge_versions;    // the versions of the cut sets of the fanins in that merge, 0 before
+    std::vector<uint32_t>                 _versions;          // the version of the cut set of a node, from 1
+    std::vector<uint32_t>                 _version_rounds;    // the round the version of a node was taken in
+    std::vector<std::vector<uint64_t>>    _cut_set_keys;      // the leaves and functions of the cut set of a node at that version
+    uint64_t                              _reuses{0u};
+    std::vector<double>                   _round_times;
 };  // end class klut_mapping_impl
 
 };  // end namespace detail
 
-template<class Ntk, bool StoreFunction = false, typename CutData = iFPGA_NAMESPACE::general_cut_data>
+/**
+ * @brief k-LUT mapping of Ntk, a mapping view
+ *
+ *  With StoreFunction every cut carries its function.  Without it, the cuts carry their leaves and costs
+ *  only, and a view storing the functions gets the ones of the selected cuts from their cones at the end.
+ *  The cells and their leaves are the ones of StoreFunction, a function may differ from the carried one
+ *  on the values its leaves never take in the network.
+ */
+template<class Ntk, bool StoreFunction = false, typename CutData = iFPGA_NAMESPACE::general_cut_data, typename Config = iFPGA_NAMESPACE::default_cut_config>
 mapping_qor_storage klut_mapping(Ntk& ntk, klut_mapping_params const& ps = {}, klut_mapping_stats* pst = nullptr )
 {
   klut_mapping_stats st;
-  iFPGA_NAMESPACE::detail::klut_mapping_impl<Ntk, StoreFunction, CutData> p(ntk, ps, st);
+  iFPGA_NAMESPACE::detail::klut_mapping_impl<Ntk, StoreFunction, CutData, Config> p(ntk, ps, st);
   p.run();
+  st.peak_cut_sets = p.get_peak_cut_sets();
+  st.merges = p.get_merges();
+  st.reuses = p.get_reuses();
+  st.round_times = p.get_round_times();
   if ( pst )
     *pst = st;
   return {p.get_best_delay(), p.get_best_area()};
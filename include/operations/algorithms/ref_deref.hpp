@@ -18,43 +18,60 @@
 #pragma once
 #include "utils/common_properties.hpp"
 #include "utils/cost_functions.hpp"
+#include "utils/traversal_context.hpp"
 
 #include <stdint.h>
 #include <tuple>
 
 iFPGA_NAMESPACE_HEADER_START
 
-template<typename Ntk, typename NodeCostFn, typename TermConditionFn>
-uint32_t deref_node_recursive_cond(Ntk const& ntk, node<Ntk> const& n, TermConditionFn const& term_fn)
+namespace detail
+{
+/* the reference counts are the values of the network or of a traversal context */
+template<typename Ntk, typename NodeCostFn, typename Refs, typename TermConditionFn>
+uint32_t deref_node_recursive_cond(Ntk const& ntk, Refs& refs, node<Ntk> const& n, TermConditionFn const& term_fn)
 {
   if ( term_fn( n ) )
     return 0u;
 
   uint32_t value = NodeCostFn{}( ntk, n );
   ntk.foreach_fanin( n, [&]( auto const& s ) {
-    if ( ntk.decr_value( ntk.get_node( s ) ) == 0 )
+    if ( refs.decr_value( ntk.get_node( s ) ) == 0 )
     {
-      value += deref_node_recursive_cond<Ntk, NodeCostFn, TermConditionFn>( ntk, ntk.get_node( s ), term_fn );
+      value += deref_node_recursive_cond<Ntk, NodeCostFn, Refs, TermConditionFn>( ntk, refs, ntk.get_node( s ), term_fn );
     }
   } );
   return value;
 }
 
-template<typename Ntk, typename NodeCostFn, typename TermConditionFn>
-uint32_t ref_node_recursive_cond(Ntk const& ntk, node<Ntk> const& n, TermConditionFn const& term_fn)
+template<typename Ntk, typename NodeCostFn, typename Refs, typename TermConditionFn>
+uint32_t ref_node_recursive_cond(Ntk const& ntk, Refs& refs, node<Ntk> const& n, TermConditionFn const& term_fn)
 {
   if ( term_fn( n ) )
     return 0u;
 
   uint32_t value = NodeCostFn{}( ntk, n );
   ntk.foreach_fanin( n, [&]( auto const& s ) {
-    if ( ntk.incr_value( ntk.get_node( s ) ) == 0 )
+    if ( refs.incr_value( ntk.get_node( s ) ) == 0 )
     {
-      value += ref_node_recursive_cond<Ntk, NodeCostFn, TermConditionFn>( ntk, ntk.get_node( s ), term_fn );
+      value += ref_node_recursive_cond<Ntk, NodeCostFn, Refs, TermConditionFn>( ntk, refs, ntk.get_node( s ), term_fn );
     }
   } );
   return value;
 }
+} // namespace detail
+
+template<typename Ntk, typename NodeCostFn, typename TermConditionFn>
+uint32_t deref_node_recursive_cond(Ntk const& ntk, node<Ntk> const& n, TermConditionFn const& term_fn)
+{
+  return detail::deref_node_recursive_cond<Ntk, NodeCostFn, Ntk const, TermConditionFn>( ntk, ntk, n, term_fn );
+}
+
+template<typename Ntk, typename NodeCostFn, typename TermConditionFn>
+uint32_t ref_node_recursive_cond(Ntk const& ntk, node<Ntk> const& n, TermConditionFn const& term_fn)
+{
+  return detail::ref_node_recursive_cond<Ntk, NodeCostFn, Ntk const, TermConditionFn>( ntk, ntk, n, term_fn );
+}
 
 template<typename Ntk, typename NodeCostFn = unit_cost<Ntk>>
 uint32_t deref_node_recursive(Ntk const& ntk, node<Ntk> const& n)
@@ -111,4 +128,40 @@ uint32_t refed_size(Ntk const& ntk, node<Ntk> const& n)
   return s1;
 }
 
+/**
+ * @brief the versions counting the references in a traversal context, leaving the network untouched,
+ *  see traversal_context::init_references
+ */
+template<typename Ntk, typename NodeCostFn = unit_cost<Ntk>>
+uint32_t deref_node_recursive(Ntk const& ntk, traversal_context<Ntk>& ctx, node<Ntk> const& n)
+{
+  const auto term_fn = [&](const auto& n){ return ntk.is_constant(n) || ntk.is_pi(n); };
+  return detail::deref_node_recursive_cond<Ntk, NodeCostFn>(ntk, ctx, n, term_fn);
+}
+
+template<typename Ntk, typename NodeCostFn = unit_cost<Ntk>>
+uint32_t ref_node_recursive(Ntk const& ntk, traversal_context<Ntk>& ctx, node<Ntk> const& n)
+{
+  const auto term_fn = [&](const auto& n){ return ntk.is_constant(n) || ntk.is_pi(n); };
+  return detail::ref_node_recursive_cond<Ntk, NodeCostFn>(ntk, ctx, n, term_fn);
+}
+
+template<typename Ntk, typename NodeCostFn = unit_cost<Ntk>>
+uint32_t derefed_size(Ntk const& ntk, traversal_context<Ntk>& ctx, node<Ntk> const& n)
+{
+  uint32_t s1 = deref_node_recursive<Ntk, NodeCostFn>(ntk, ctx, n);
+  [[maybe_unused]] uint32_t s2 = ref_node_recursive<Ntk, NodeCostFn>(ntk, ctx, n);
+  assert(s1 == s2);
+  return s1;
+}
+
+template<typename Ntk, typename NodeCostFn = unit_cost<Ntk>>
+uint32_t refed_size(Ntk const& ntk, traversal_context<Ntk>& ctx, node<Ntk> const& n)
+{
+  uint32_t s1 = ref_node_recursive<Ntk, NodeCostFn>(ntk, ctx, n);
+  [[maybe_unused]] uint32_t s2 = deref_node_recursive<Ntk, NodeCostFn>(ntk, ctx, n);
+  assert(s1 == s2);
+  return s1;
+}
+
 iFPGA_NAMESPACE_HEADER_END
\ No newline at end of file
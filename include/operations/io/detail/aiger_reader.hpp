@@ -165,7 +165,7 @@ public:
     }
   }
 
-  void on_header( uint64_t, uint64_t num_inputs, uint64_t num_latches, uint64_t, uint64_t ) const override
+  void on_header( uint64_t max_var, uint64_t num_inputs, uint64_t num_latches, uint64_t, uint64_t ) const override
   {
     (void)num_latches;
     if constexpr ( !has_create_ri_v<Ntk> || !has_create_ro_v<Ntk> )
@@ -174,6 +174,7 @@ public:
     }
 
     _num_inputs = static_cast<uint32_t>( num_inputs );
+    signals.reserve( max_var + 1u );
 
     /* constant */
     signals.push_back( _ntk.get_constant( false ) );
@@ -30,6 +30,8 @@
 #include <kitty/print.hpp>
 
 #include "utils/util.hpp"
+#include "utils/traits.hpp"
+#include "utils/lut_function_cache.hpp"
 
 iFPGA_NAMESPACE_HEADER_START
 
@@ -52,6 +54,7 @@ struct LUT
 {
   std::string name;
   kitty::dynamic_truth_table lut_function;
+  std::string lut_hex;                    // the INIT value
   std::string fanout;
   std::vector< std::string > fanins;
 };
@@ -121,11 +124,32 @@ void write_lut( Ntk const& ntk, std::ostream& os, write_verilog_params const& ps
       return; /* continue */
     uset_wires.insert( ntk.node_to_index( n ) );
     LUT tmp_lut{};  
-    tmp_lut.lut_function = ntk.node_function( n );
+    /* the functions of at most 6 inputs are flipped and printed as one word */
+    bool is_word = false;
+    uint64_t word = 0u;
+    if constexpr ( has_node_function_word_v<Ntk> )
+    {
+      if ( ntk.fanin_size( n ) <= 6u )
+      {
+        is_word = true;
+        word = ntk.node_function_word( n );
+      }
+    }
+    if ( !is_word )
+    {
+      tmp_lut.lut_function = ntk.node_function( n );
+    }
     ntk.foreach_fanin( n, [&]( auto const& c, auto i ) {
       if ( ntk.is_complemented( c ) )
       {
-        kitty::flip_inplace( tmp_lut.lut_function, i );
+        if ( is_word )
+        {
+          word = flip_word( word, i );
+        }
+        else
+        {
+          kitty::flip_inplace( tmp_lut.lut_function, i );
+        }
       }
       std::string tmp_fanin;
       if( uset_wires.count(  ntk.node_to_index( ntk.get_node( c ) )  ) )
@@ -138,6 +162,15 @@ void write_lut( Ntk const& ntk, std::ostream& os, write_verilog_params const& ps
     } );
     tmp_lut.name = fmt::format( "name{}", vec_LUTs.size() );
     tmp_lut.fanout = fmt::format( "_w{}_", ntk.node_to_index( n ) );  // should be node , not output
+    if ( is_word )
+    {
+      auto const num_vars = static_cast<uint32_t>( tmp_lut.fanins.size() );
+      tmp_lut.lut_hex = fmt::format( "{:0{}x}", word, num_vars <= 1u ? 1u : ( 1u << num_vars ) >> 2 );
+    }
+    else
+    {
+      tmp_lut.lut_hex = kitty::to_hex( tmp_lut.lut_function );
+    }
     vec_LUTs.emplace_back( tmp_lut );
   } );
 
@@ -184,7 +217,7 @@ void write_lut( Ntk const& ntk, std::ostream& os, write_verilog_params const& ps
     os << fmt::format( "\t\t{}\n", lut.fanout );
     os << "\t);\n" ;
     os << fmt::format( "\tdefparam {}.INIT = {}'h{};\n\n", 
-                      lut.name, 1 << lut.fanins.size(), kitty::to_hex(lut.lut_function));
+                      lut.name, 1 << lut.fanins.size(), lut.lut_hex);
     
   }
 
@@ -58,7 +58,16 @@ public:
             _new_aig.create_po(new_signal ^ o.complement);
         });
 
-        return cleanup_dangling(_new_aig);
+        if constexpr ( has_compact_v<Ntk> )
+        {
+            /* a fresh network on the compacted storage, leaving the events of the depth view behind */
+            _new_aig.compact();
+            return Ntk( _new_aig._storage );
+        }
+        else
+        {
+            return cleanup_dangling(_new_aig);
+        }
     }
 
 private:
@@ -103,24 +103,33 @@ public:
     {
       depth_ntk = std::make_shared<depth_view<Ntk, CostFn>>( _ntk );
     }
-    topo_view<Ntk>(_ntk).foreach_node([&](auto n){
+    topo_view<Ntk> topo( _ntk );
+    const bool parallel = _cut_ps.num_threads > 1u;
+    if ( parallel )
+    {
+      enumerate_cuts_parallel( topo );
+    }
+    topo.foreach_node([&](auto n){
       
       const auto index_node = _ntk.node_to_index(n);
       /// refer to k-feasible-cut
       _fanouts[index_node] = _ntk.fanout_size( n );
       if(_ntk.is_constant(n))
       {
-        _cut_network.add_zero_cut(index_node);
+        if ( !parallel )
+          _cut_network.add_zero_cut(index_node);
         return;
       }
       else if(_ntk.is_pi(n))
       {
-        _cut_network.add_unit_cut(index_node);
+        if ( !parallel )
+          _cut_network.add_unit_cut(index_node);
         return;
       }
       else
       {
-        merge_cuts2(index_node);
+        if ( !parallel )
+          merge_cuts2(index_node, _cut_network.truth_tables());
 
         if ( _ps.only_on_critical_path && !depth_ntk->is_on_critical_path( n ) )
         {
@@ -135,7 +144,7 @@ public:
 
         arrival_time_pair<Ntk> best{{}, std::numeric_limits<uint32_t>::max()};
         uint32_t best_size{};
-        for ( auto& cut : _cut_network.cuts( index_node ) )
+        for ( auto* cut : _cut_network.cuts( index_node ) )
         {
           if ( cut->size() == 1u || kitty::is_const0( _cut_network.truth_table( *cut ) ) )
           {
@@ -203,18 +212,68 @@ public:
       dest.create_po( _ntk.is_complemented( f ) ? dest.create_not( s ) : s );
     } );
 
-    return cleanup_dangling( dest );
+    if constexpr ( has_compact_v<Ntk> )
+    {
+      dest.compact();
+      return dest;
+    }
+    else
+    {
+      return cleanup_dangling( dest );
+    }
   }
 
 private:
 
-  uint32_t compute_truth_table( uint32_t index, std::vector<cut_t const*> const& vcuts, cut_t& res )
+  /**
+   * @brief computes all the cuts ahead of the rebalancing, the nodes of a level in parallel
+   */
+  void enumerate_cuts_parallel( topo_view<Ntk> const& topo )
+  {
+    std::vector<uint32_t> gates;
+    topo.foreach_node( [&]( auto n ) {
+      const auto index = _ntk.node_to_index( n );
+      if ( _ntk.is_constant( n ) )
+      {
+        _cut_network.add_zero_cut( index );
+      }
+      else if ( _ntk.is_pi( n ) )
+      {
+        _cut_network.add_unit_cut( index );
+      }
+      else
+      {
+        gates.push_back( index );
+      }
+    } );
+
+    const auto levels = group_by_level<uint32_t>( _ntk.size(), gates, [&]( auto index, auto&& fn ) {
+      _ntk.foreach_fanin( _ntk.index_to_node( index ), [&]( auto const& f ) {
+        fn( _ntk.node_to_index( _ntk.get_node( f ) ) );
+      } );
+    } );
+    for ( auto const& group : levels )
+    {
+      enumerate_level_parallel( _cut_network, group, _cut_ps.num_threads, [this]( auto index, auto& cache ) {
+        merge_cuts2( index, cache );
+      } );
+    }
+  }
+
+  template<typename Cache>
+  void compute_truth_table( uint32_t index, std::vector<cut_t const*> const& vcuts, cut_t& res, Cache& cache )
   {
+    if ( res.size() <= max_word_cut_size )
+    {
+      _cut_network.compute_word_function( _ntk, _ntk.index_to_node( index ), vcuts, res, _cut_ps.minimize_truth_table );
+      return;
+    }
+
     std::vector<kitty::dynamic_truth_table> tt( vcuts.size() );
     auto i = 0;
     for ( auto const& cut : vcuts )
     {
-      tt[i] = kitty::extend_to( _cut_network.at((*cut)->func_id), res.size() );
+      tt[i] = kitty::extend_to( _cut_network.truth_table( *cut ), res.size() );
       const auto supp = _cut_network.compute_truth_table_support( *cut, res );
       kitty::expand_inplace( tt[i], supp );
       ++i;
@@ -238,14 +297,21 @@ private:
           *it_leaves++ = leaves_before[*it_support++];
         }
         res.set_leaves( leaves_after.begin(), leaves_after.end() );
-        return _cut_network.insert_truth_table( tt_res_shrink );
+        if ( res.size() <= max_word_cut_size )
+        {
+          res->func_word = detail::truth_table_to_word( tt_res_shrink );
+          return;
+        }
+        res->func_id = cache.insert( tt_res_shrink );
+        return;
       }
     }
 
-    return _cut_network.insert_truth_table( tt_res );
+    res->func_id = cache.insert( tt_res );
   }
 
-  void merge_cuts2( uint32_t index )
+  template<typename Cache>
+  void merge_cuts2( uint32_t index, Cache& cache )
   {
     array<cut_set_t*, Ntk::max_fanin_size + 1> lcuts; // child's cut
     const auto fanin = 2;
@@ -280,7 +346,7 @@ private:
         // compute boolean function
         vcuts[0] = c1;
         vcuts[1] = c2;
-        new_cut->func_id = compute_truth_table( index, vcuts, new_cut );
+        compute_truth_table( index, vcuts, new_cut, cache );
 
         if(new_cut.size() == 0)
           continue;
@@ -313,7 +379,7 @@ template<class Ntk, class CostFn = unit_cost<Ntk>>
 Ntk balance_online( Ntk const& ntk, rebalance_function_t<Ntk> const& rebalancing_fn = {}, balance_params const& ps = {}, balance_stats* pst = nullptr )
 {
   balance_stats st;
-  iFPGA_NAMESPACE::network_cuts<Ntk, true, iFPGA_NAMESPACE::empty_cut_data> cut_network(ntk.size());
+  iFPGA_NAMESPACE::network_cuts<Ntk, true, iFPGA_NAMESPACE::empty_cut_data> cut_network(ntk.size(), true, ps.cut_enumeration_ps.truth_tables);
   detail::balance_online_impl<Ntk, CostFn> p(ntk, cut_network, rebalancing_fn, ps, st, ps.cut_enumeration_ps);
   const auto dest = p.run();
   if ( pst )
@@ -161,7 +161,7 @@ struct balancing_impl
 
       arrival_time_pair<Ntk> best{{}, std::numeric_limits<uint32_t>::max()};
       uint32_t best_size{};
-      for ( auto& cut : cuts.cuts( ntk_.node_to_index( n ) ) )
+      for ( auto* cut : cuts.cuts( ntk_.node_to_index( n ) ) )
       {
         if ( cut->size() == 1u || kitty::is_const0( cuts.truth_table( *cut ) ) )
         {
@@ -188,7 +188,15 @@ struct balancing_impl
       dest.create_po( ntk_.is_complemented( f ) ? dest.create_not( s ) : s );
     } );
 
-    return cleanup_dangling( dest );
+    if constexpr ( has_compact_v<Ntk> )
+    {
+      dest.compact();
+      return dest;
+    }
+    else
+    {
+      return cleanup_dangling( dest );
+    }
   }
 
 private:
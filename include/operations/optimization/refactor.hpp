@@ -20,6 +20,7 @@
 #include <limits.h>
 
 #include <algorithm>
+#include <memory>
 #include <queue>
 #include <set>
 #include <unordered_set>
@@ -32,7 +33,7 @@
 #include "kitty/isop.hpp"
 #include "network/aig_network.hpp"
 #include "utils/ifpga_namespaces.hpp"
-#include "views/topo_view.hpp"
+#include "views/depth_view.hpp"
 
 #include "detail/sop_refactoring.hpp"
 
@@ -65,7 +66,8 @@ namespace detail
         : _ntk(ntk),
           _refactoring_fn(refactoring_fn),
           _params(params),
-          _node_cost_fn(node_cost_fn)
+          _node_cost_fn(node_cost_fn),
+          _fanouts(ntk)
     {
       init();
     }
@@ -101,17 +103,27 @@ namespace detail
           replace_sub_ntk(n, tt);
         } });
 
-      // clean up the dangling nodes
-      return cleanup_dangling<Ntk>(_ntk);
+      // clean up the dangling nodes in a copy, the caller keeps its node indices
+      _depth.reset();
+      if constexpr ( has_compact_v<Ntk> )
+      {
+        /* the compacted copy shares the pages the renumbering leaves unchanged */
+        Ntk dest( _ntk.snapshot()._storage );
+        dest.compact();
+        return dest;
+      }
+      else
+      {
+        return cleanup_dangling<Ntk>(_ntk);
+      }
     }
 
   private:
     void init()
     {
       init_nodes_defered_size();
-      compute_depth_info();
-      compute_reverse_depth_info();
-      compute_fanouts_info();
+      // the view keeps the levels up to date through the substitutions
+      _depth = std::make_shared<depth_view<Ntk>>(_ntk);
     }
 
     /**
@@ -124,81 +136,6 @@ namespace detail
                         { _ntk.set_value(n, _ntk.fanout_size(n)); });
     }
 
-    /**
-     * @brief compute depth for each node and _ntk
-     */
-    void compute_depth_info()
-    {
-      topo_view<Ntk>(_ntk).foreach_node([&](auto n)
-                                        {
-      if ( _ntk.is_pi( n ) ) {
-        _depth_map.insert( std::make_pair( n, 0 ) );
-      }
-      // root node's depth is deeper child's depth + 1
-      uint32_t max_depth = 0;
-      _ntk.foreach_fanin( n, [&]( auto const& f ) {
-        auto child       = _ntk.get_node( f );
-        auto child_depth = _depth_map.find( child )->second;
-        if ( child_depth + 1 > max_depth ) {
-          max_depth = child_depth + 1;
-        }
-      } );
-      _depth_map.insert( std::make_pair( n, max_depth ) );
-      // save max depth of _ntk as _ntk's depth
-      if ( max_depth > _depth_max ) {
-        _depth_max = max_depth;
-      } });
-    }
-
-    /**
-     * @brief Computes reverse levels for each node(length of the farthest path from n to POs)
-     */
-    void compute_reverse_depth_info()
-    {
-      // get reverse topo index and init
-      std::vector<node<Ntk>> r_topo_order;
-      topo_view<Ntk>(_ntk).foreach_node([&](auto n)
-                                        {
-      r_topo_order.insert( r_topo_order.begin(), n );
-      if ( !_ntk.is_pi( n ) ) {
-        _r_depth_map.insert( std::make_pair( _ntk.index_to_node( n ), 1 ) );
-      } });
-
-      // compute reverse level
-      for (auto cur_node : r_topo_order)
-      {
-        if (_ntk.is_pi(cur_node))
-        {
-          continue;
-        }
-        uint32_t cur_depth = _r_depth_map.find(cur_node)->second;
-        _ntk.foreach_fanin(cur_node, [&](auto const &f)
-                           {
-        auto child_iter = _r_depth_map.find( _ntk.get_node( f ) );
-        if ( !_ntk.is_pi( _ntk.get_node( f ) ) && child_iter->second < cur_depth + 1 ) {
-          child_iter->second = cur_depth + 1;
-        } });
-      }
-    }
-
-    /**
-     * @brief Computes fanouts nodes of each node in _ntk
-     */
-    void compute_fanouts_info()
-    {
-      _ntk.foreach_node([&](auto n)
-                        { _ntk.foreach_fanin(n, [&](auto const &f)
-                                             {
-        auto iter = _fanouts_map.find( _ntk.get_node( f ) );
-        if ( iter != _fanouts_map.end() ) {
-          iter->second.insert( n );
-        } else {
-          std::unordered_set<node<Ntk>> new_set;
-          new_set.insert( n );
-          _fanouts_map.insert( std::make_pair( _ntk.get_node( f ), new_set ) );
-        } }); });
-    }
-
     /**
      * @brief Finds a fanin-limited, reconvergence-driven cut for the node
      */
@@ -236,7 +173,7 @@ namespace detail
       for (auto leaf : _leaves_nodes)
       {
         cur_cost = compute_leaf_cost(leaf);
-        int cur_level = _depth_map.find(leaf)->second;
+        int cur_level = _depth->level(leaf);
 
         if (cur_cost < best_cost || (cur_cost == best_cost && cur_level > best_fanin_level))
         {
@@ -437,15 +374,13 @@ namespace detail
         int gain = num_nodes_save - num_nodes_added;
 
         // compute depth
-        auto reuqire_depth = _depth_max + 1 - _r_depth_map.find(root)->second;
-        auto cur_depth = update_depth(_ntk.get_node(f_new));
+        auto reuqire_depth = _depth->required(root);
+        auto cur_depth = _depth->level(_ntk.get_node(f_new));
 
         if ((gain > 0 || (_params.allow_zero_gain && gain == 0)) // area
             && ((cur_depth <= reuqire_depth) || _params.allow_depth_up) && root != _ntk.get_node(f_new))
         { // depth
           sub_ntk_replace(root, f_new);
-          update_fanouts_info(root, f_new);
-          recursive_update_fanouts_depth(_ntk.get_node(f_new));
         }
         else
         {
@@ -479,116 +414,24 @@ namespace detail
       }
     }
 
-    /**
-     * @brief update depth for nodes in new cone
-     */
-    uint32_t update_depth(node<Ntk> root)
-    {
-      std::unordered_set<node<Ntk>> leaves_set(_leaves_nodes.begin(), _leaves_nodes.end());
-      return recursive_update_depth(root, leaves_set);
-    }
-
-    /**
-     * @brief recursive compute depth for nodes in new cone
-     */
-    uint32_t recursive_update_depth(node<Ntk> root, std::unordered_set<node<Ntk>> &leaves_set)
-    {
-      uint32_t cur_depth = 0;
-
-      // compute current max depth
-      _ntk.foreach_fanin(root, [&](auto const &s, auto i)
-                         {
-      auto child = _ntk.get_node( s );
-      if ( leaves_set.find( child ) != leaves_set.end() ) {  // leaves node
-        cur_depth = std::max( cur_depth, 1 + _depth_map.find( child )->second );
-      } else {  // internal node
-        cur_depth = std::max( cur_depth, 1 + recursive_update_depth( child, leaves_set ) );
-      } });
-
-      // update depth info
-      auto iter = _depth_map.find(root);
-      if (iter == _depth_map.end())
-      { // newly node
-        _depth_map.insert(std::make_pair(root, cur_depth));
-      }
-      else
-      {
-        iter->second = cur_depth;
-      }
-
-      return cur_depth;
-    }
-
-    /**
-     * @brief update fanouts info for nodes in cone
-     */
-    void update_fanouts_info(node<Ntk> old_n, signal<Ntk> new_s)
-    {
-      // copy fanouts info of old node to new node
-      auto old_iter = _fanouts_map.find(old_n);
-      if (old_iter != _fanouts_map.end())
-      {
-        std::unordered_set<node<Ntk>> new_set(old_iter->second);
-        _fanouts_map.insert(std::make_pair(_ntk.get_node(new_s), new_set));
-        _fanouts_map.erase(old_iter);
-      }
-
-      for (auto n : _visited_nodes)
-      {
-        _ntk.foreach_fanin(n, [&](auto const &s, auto i)
-                           {
-        auto iter = _fanouts_map.find( _ntk.get_node( s ) );
-        if ( iter != _fanouts_map.end() ) {
-          iter->second.insert( n );
-        } else {
-          std::unordered_set<node<Ntk>> new_set;
-          new_set.insert( n );
-          _fanouts_map.insert( std::make_pair( _ntk.get_node( s ), new_set ) );
-        } });
-      }
-    }
-
-    /**
-     * @brief recursive update fanouts depth
-     */
-    void recursive_update_fanouts_depth(node<Ntk> root)
-    {
-      auto fanouts_iter = _fanouts_map.find(root);
-      if (fanouts_iter == _fanouts_map.end())
-      {
-        return;
-      }
-
-      auto fanouts_set = fanouts_iter->second;
-      auto root_dp = _depth_map.find(root)->second;
-      for (auto fanout : fanouts_set)
-      {
-        auto depth_iter = _depth_map.find(fanout);
-        if (depth_iter->second < root_dp + 1)
-        {
-          depth_iter->second = root_dp + 1;
-          recursive_update_fanouts_depth(fanout);
-        }
-      }
-    }
-
   private:
     Ntk &_ntk;
     RefactoringFn const &_refactoring_fn;
     refactor_params const &_params;
     NodeCostFn const &_node_cost_fn;
+    fanout_index_scope<Ntk> _fanouts;    // the fanouts of the substituted nodes, while the pass runs
 
     std::vector<node<Ntk>> _visited_nodes;
     std::vector<node<Ntk>> _leaves_nodes;
 
-    uint32_t _depth_max = 0;
-    std::unordered_map<node<Ntk>, uint32_t> _depth_map;
-    std::unordered_map<node<Ntk>, uint32_t> _r_depth_map;
-
-    std::unordered_map<node<Ntk>, std::unordered_set<node<Ntk>>> _fanouts_map;
+    std::shared_ptr<depth_view<Ntk>> _depth;
   }; // end class refactor_impl
 };   // end namespace detail
 
+/**
+ * @brief refactors the reconvergence-driven cones of the nodes
+ *  ntk is refactored in place and keeps its dead nodes, the returned network is a compacted copy
+ */
 template <typename Ntk = aig_network,
           class RefactoringFn = sop_factoring<Ntk>,
           typename NodeCostFn = unit_cost<Ntk>>
@@ -18,6 +18,7 @@
 #pragma once
 
 #include "network/aig_network.hpp"
+#include "views/depth_view.hpp"
 #include "algorithms/cleanup.hpp"
 #include "algorithms/ref_deref.hpp"
 #include "cut/cut_enumeration.hpp"
@@ -29,6 +30,7 @@
 #include <unordered_set>
 #include <unordered_map>
 #include <tuple>
+#include <memory>
 
 iFPGA_NAMESPACE_HEADER_START
 
@@ -50,13 +52,13 @@ namespace detail {
 /**
  * @brief DAG-aware rewriting based on priority cut. 
 */
-template <typename Ntk, typename RewritingFn>
+template <typename Ntk, typename RewritingFn, typename Config>
 class rewrite_impl
 {
  public:
   using node_t         = typename Ntk::node;
   using signal_t       = typename Ntk::signal;
-  using network_cuts_t = iFPGA_NAMESPACE::network_cuts<Ntk, true, iFPGA_NAMESPACE::cut_enumeration_rewrite_cut>;
+  using network_cuts_t = iFPGA_NAMESPACE::network_cuts<Ntk, true, iFPGA_NAMESPACE::cut_enumeration_rewrite_cut, Config>;
   using cut_t          = typename network_cuts_t::cut_t;
   using cut_set_t      = typename network_cuts_t::cut_set_t;
 
@@ -65,7 +67,8 @@ class rewrite_impl
                 rewrite_params const&  ps)
       : _ntk( ntk ),
         _rewriting_fn( rewriting_fn ),
-        _ps( ps )
+        _ps( ps ),
+        _fanouts( ntk )
   {  }
 
   /**
@@ -75,7 +78,7 @@ class rewrite_impl
   Ntk run() {
     
     initialize();
-    const auto cuts_list = cut_enumeration<Ntk, true, cut_enumeration_rewrite_cut>(_ntk, _ps.cut_enumeration_ps);
+    const auto cuts_list = cut_enumeration<Ntk, true, cut_enumeration_rewrite_cut, Config>(_ntk, _ps.cut_enumeration_ps);
 
     std::map<node_t, signal_t> best_replacement;
 
@@ -94,7 +97,7 @@ class rewrite_impl
       int best_gain = -1;
       signal_t best_signal;
 
-      for(auto& cut : cuts_list.cuts(_ntk.node_to_index(n))) {
+      for(auto* cut : cuts_list.cuts(_ntk.node_to_index(n))) {
         if(cut->size() != 4u)
           continue;
         const auto tt = cuts_list.truth_table(*cut);
@@ -113,9 +116,7 @@ class rewrite_impl
           int cost_tmp = ref_cut(ns, children_nodes);
           deref_cut(ns, children_nodes);
 
-          update_arrive_depth(ns, children_nodes);
-          
-          int slack = _depth_require[n] - _depth_arrive[ns];
+          int64_t slack = int64_t( _depth->required(n) ) - int64_t( _depth->level(ns) );
           if( !_ps.b_preserve_depth || (_ps.b_preserve_depth && slack >= 0) ) {
             if( best_gain < cost_before - cost_tmp) {
               best_gain = cost_before - cost_tmp;
@@ -134,6 +135,9 @@ class rewrite_impl
       }
     });
 
+    // the slacks were all checked on the network before any replacement, drop the view before changing it
+    _depth.reset();
+
     // local replacement for the candidate best signal
     if(_ps.verbose) {
       printf("perform local replacement ing\n");
@@ -147,30 +151,25 @@ class rewrite_impl
       local_replacement(cand.first, cand.second);
     }
 
-    return cleanup_dangling(_ntk);
+    if constexpr ( has_compact_v<Ntk> )
+    {
+      /* the caller keeps its node indices, the compacted copy shares the pages the renumbering leaves unchanged */
+      Ntk dest( _ntk.snapshot()._storage );
+      dest.compact();
+      return dest;
+    }
+    else
+    {
+      return cleanup_dangling(_ntk);
+    }
   }
 
  private:
   void initialize() {
-    initialize_fanouts();
     initialize_reference();
     initialize_depth();
   }
 
-  void initialize_fanouts() {
-    _ntk.foreach_gate([&](auto const& n){
-      _ntk.foreach_fanin(n, [&](auto const& sc){
-        auto nc = _ntk.get_node(sc);
-        _fanouts[nc].emplace_back( signal_t(n, _ntk.is_complemented(sc)) );
-      });
-    });
-
-    _ntk.foreach_po([&](auto const& po){
-      auto npo = _ntk.get_node(po);
-      _fanouts[npo].emplace_back( po );
-    });
-  }
-
   /**
    * @brief initialize the reference count of each node
   */
@@ -182,71 +181,11 @@ class rewrite_impl
   }
 
   /**
-   * @brief initialize the arrive depth and require depth for each node
+   * @brief level the network and compute the required levels for the slack check,
+   *  a candidate node gets its level when the rewriting creates it
   */
   void initialize_depth() {
-    int depth_max = 0;
-    // set arrive depth first
-    _ntk.foreach_node([&](auto const& n){
-      _depth_arrive[n] = -1;     // init each arrive depth be -1
-      if(_ntk.is_pi(n) || _ntk.is_pi(n)) {
-        _depth_arrive[n] = 0u;
-      } else {
-        _ntk.foreach_fanin(n, [&](auto const& sc){
-          _depth_arrive[n] = std::max(_depth_arrive[n], _depth_arrive[_ntk.get_node(sc)]+1);
-        });
-      }
-      _depth_require[n] = 100000; // init each require depth be +∞
-    });
-
-    // set the require depth
-    _ntk.foreach_po([&](auto const& po){
-      depth_max = std::max(depth_max, _depth_arrive[_ntk.get_node(po)]);
-    });
-
-    _ntk.foreach_po([&](auto const& po){
-      _depth_require[_ntk.get_node(po)] = depth_max;
-      compute_require_depth_rec( _ntk.get_node(po) );
-    });
-  }
-
-  /**
-   * @brief recursively compute the require depth
-   * @param n root node for the cone
-  */
-  void compute_require_depth_rec(node_t n) {
-    if(_ntk.is_pi(n) || _ntk.is_constant(n)) {
-      return;
-    }
-    _ntk.foreach_fanin(n, [&](auto const& sc) {
-      auto nc = _ntk.get_node(sc);
-      if(_depth_require[nc] > _depth_require[n] - 1) {
-        _depth_require[nc] = _depth_require[n] - 1;
-        compute_require_depth_rec(nc);
-      }
-    });
-  }
-
-  /**
-   * @brief update the arrive for the padding subgraph
-   * @param n
-   * @param leaves
-   * @return depth for n
-  */
-  int update_arrive_depth(node_t const& n, std::vector<node_t> const& leaves) {
-    int res = 0;
-    _ntk.foreach_fanin(n, [&](auto const& sc){
-      auto nc = _ntk.get_node(sc);
-      if(std::find(leaves.begin(), leaves.end(), nc) != leaves.end()) {
-        res = std::max(res, _depth_arrive[nc] + 1);
-        _depth_arrive[n] = std::max(_depth_arrive[n], _depth_arrive[nc] + 1);
-      }
-      else {
-        res = std::max(res, update_arrive_depth(nc, leaves) + 1);
-        _depth_arrive[n] = std::max(_depth_arrive[n], update_arrive_depth(nc, leaves) + 1);
-      }
-    });
-    return res;
+    _depth = std::make_shared<depth_view<Ntk>>( _ntk );
   }
 
   /**
@@ -318,8 +257,12 @@ class rewrite_impl
     });
 
     if( !is_po ) {
-      for(auto sfo : _fanouts[old_n]) {
-        auto nfo = _ntk.get_node(sfo);
+      // the fanouts of old_n change while being redirected
+      std::vector<node_t> fanouts;
+      _ntk.foreach_fanout(old_n, [&](auto const& nfo){
+        fanouts.emplace_back(nfo);
+      });
+      for(auto nfo : fanouts) {
         auto sc0 = _ntk.get_child0(nfo);
         auto sc1 = _ntk.get_child1(nfo);
         if(_ntk.get_node(sc0) == old_n) {
@@ -336,22 +279,27 @@ class rewrite_impl
   Ntk&                  _ntk;
   RewritingFn const&    _rewriting_fn;
   rewrite_params const& _ps;
+  fanout_index_scope<Ntk> _fanouts;    // the fanouts of the replaced nodes, while the pass runs
 
-  std::unordered_map<node_t, std::vector<signal_t>> _fanouts;
-  std::unordered_map<node_t, int> _depth_arrive;
-  std::unordered_map<node_t, int> _depth_require;
+  std::shared_ptr<depth_view<Ntk>> _depth;
 };  // end class rewrite_impl
 
 };  // end namespace detail
 
+/**
+ * @brief rewrites the 4-leaf cuts of the nodes
+ *  ntk is rewritten in place and keeps its dead nodes, the returned network is a compacted copy
+ * @tparam Config the capacity of the cuts, 4 leaves are enough unless cut_size is larger
+ */
 template <typename Ntk         = iFPGA_NAMESPACE::aig_network,
-          typename RewritingFn = node_rewriting<Ntk> >
+          typename RewritingFn = node_rewriting<Ntk>,
+          typename Config      = iFPGA_NAMESPACE::cut_config<4u, 12u> >
 Ntk rewrite( Ntk& ntk, rewrite_params const& params )
 {
   RewritingFn resynthesis_fn;
-  const auto dest = detail::rewrite_impl<Ntk, RewritingFn>{ ntk,
-                                                            resynthesis_fn,
-                                                            params}.run();
+  const auto dest = detail::rewrite_impl<Ntk, RewritingFn, Config>{ ntk,
+                                                                    resynthesis_fn,
+                                                                    params}.run();
   return dest;
 }
 
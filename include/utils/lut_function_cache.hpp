@@ -0,0 +1,218 @@
+// ***************************************************************************************
+// Copyright (c) 2023-2025 Peng Cheng Laboratory
+// Copyright (c) 2023-2025 Shanghai Anlogic Infotech Co.,Ltd.
+// Copyright (c) 2023-2025 Peking University
+//
+// iMAP-FPGA is licensed under Mulan PSL v2.
+// You can use this software according to the terms and conditions of the Mulan PSL v2.
+// You may obtain a copy of Mulan PSL v2 at:
+// http://license.coscl.org.cn/MulanPSL2
+//
+// THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+// EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+// MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+//
+// See the Mulan PSL v2 for more details.
+// ***************************************************************************************
+
+#pragma once
+#include "utils/ifpga_namespaces.hpp"
+
+#include <cassert>
+#include <unordered_map>
+#include <vector>
+
+#include <kitty/dynamic_truth_table.hpp>
+#include <kitty/hash.hpp>
+#include <kitty/operations.hpp>
+#include <kitty/operators.hpp>
+#include <kitty/detail/constants.hpp>
+
+iFPGA_NAMESPACE_HEADER_START
+
+/**
+ * @brief the truth table of a function of at most 6 variables, flipped on one variable
+ */
+inline uint64_t flip_word( uint64_t word, uint32_t var )
+{
+  assert( var < 6u );
+  auto const shift = uint64_t( 1 ) << var;
+  return ( ( word & kitty::detail::projections[var] ) >> shift ) | ( ( word & kitty::detail::projections_neg[var] ) << shift );
+}
+
+/**
+ * @brief the truth table cache of the LUT functions
+ *
+ *  Same literals as truth_table_cache: the normal functions (0 on the input pattern 0...0) are
+ *  stored once, literal 2i is the function at index i and 2i + 1 its complement.
+ *  The functions of at most 6 variables are stored as one word each and found by an open
+ *  addressing table on (word, number of variables); the wider functions fall back to a
+ *  dynamic_truth_table cache.
+ */
+class lut_function_cache
+{
+public:
+  static constexpr uint32_t max_word_vars = 6u;
+
+  explicit lut_function_cache( uint32_t capacity = 1000u )
+  {
+    _words.reserve( capacity );
+    _num_vars.reserve( capacity );
+    _slots.resize( 1024u, 0u );
+  }
+
+  /**
+   * @brief inserts a function and returns its literal
+   */
+  uint32_t insert( kitty::dynamic_truth_table const& tt )
+  {
+    if ( tt.num_vars() <= max_word_vars )
+    {
+      return insert_word( *tt.cbegin(), tt.num_vars() );
+    }
+
+    uint32_t is_compl{0};
+    auto normal = tt;
+    if ( kitty::get_bit( normal, 0 ) )
+    {
+      is_compl = 1;
+      normal = ~normal;
+    }
+
+    const auto it = _wide_indexes.find( normal );
+    if ( it != _wide_indexes.end() )
+    {
+      return 2 * it->second + is_compl;
+    }
+
+    const auto index = static_cast<uint32_t>( _words.size() );
+    _words.push_back( _wide.size() );
+    _num_vars.push_back( static_cast<uint8_t>( tt.num_vars() ) );
+    _wide_indexes.emplace( normal, index );
+    _wide.push_back( std::move( normal ) );
+    return 2 * index + is_compl;
+  }
+
+  /**
+   * @brief inserts the function of at most 6 variables given by the low 2^num_vars bits of word
+   */
+  uint32_t insert_word( uint64_t word, uint32_t num_vars )
+  {
+    assert( num_vars <= max_word_vars );
+    word &= mask( num_vars );
+    uint32_t is_compl{0};
+    if ( word & 1u )
+    {
+      is_compl = 1;
+      word = ~word & mask( num_vars );
+    }
+
+    auto slot = hash( word, num_vars ) & ( _slots.size() - 1u );
+    while ( _slots[slot] != 0u )
+    {
+      auto const index = _slots[slot] - 1u;
+      if ( _words[index] == word && _num_vars[index] == num_vars )
+      {
+        return 2 * index + is_compl;
+      }
+      slot = ( slot + 1u ) & ( _slots.size() - 1u );
+    }
+
+    const auto index = static_cast<uint32_t>( _words.size() );
+    _words.push_back( word );
+    _num_vars.push_back( static_cast<uint8_t>( num_vars ) );
+    _slots[slot] = index + 1u;
+    if ( 2u * ++_num_small > _slots.size() )
+    {
+      rehash();
+    }
+    return 2 * index + is_compl;
+  }
+
+  /**
+   * @brief the function of a literal
+   */
+  kitty::dynamic_truth_table operator[]( uint32_t lit ) const
+  {
+    auto const index = lit >> 1;
+    if ( _num_vars[index] > max_word_vars )
+    {
+      auto const& entry = _wide[_words[index]];
+      return ( lit & 1 ) ? ~entry : entry;
+    }
+    kitty::dynamic_truth_table tt( _num_vars[index] );
+    *tt.begin() = word( lit );
+    return tt;
+  }
+
+  /**
+   * @brief the function of a literal of at most 6 variables, as a word
+   */
+  uint64_t word( uint32_t lit ) const
+  {
+    assert( is_word( lit ) );
+    auto const index = lit >> 1;
+    return ( lit & 1 ) ? ~_words[index] & mask( _num_vars[index] ) : _words[index];
+  }
+
+  /**
+   * @brief whether the function of a literal is stored as a word
+   */
+  bool is_word( uint32_t lit ) const
+  {
+    return _num_vars[lit >> 1] <= max_word_vars;
+  }
+
+  uint32_t num_vars( uint32_t lit ) const
+  {
+    return _num_vars[lit >> 1];
+  }
+
+  /**
+   * @brief the number of normal functions in the cache
+   */
+  auto size() const { return _words.size(); }
+
+private:
+  static uint64_t mask( uint32_t num_vars )
+  {
+    return num_vars == 6u ? ~uint64_t( 0 ) : ( uint64_t( 1 ) << ( 1u << num_vars ) ) - 1u;
+  }
+
+  static uint64_t hash( uint64_t word, uint32_t num_vars )
+  {
+    word ^= uint64_t( num_vars ) << 61;
+    word ^= word >> 33;
+    word *= 0xff51afd7ed558ccdull;
+    word ^= word >> 33;
+    return word;
+  }
+
+  void rehash()
+  {
+    std::vector<uint32_t> slots( 2u * _slots.size(), 0u );
+    for ( auto index = 0u; index < _words.size(); ++index )
+    {
+      if ( _num_vars[index] > max_word_vars )
+        continue;
+      auto slot = hash( _words[index], _num_vars[index] ) & ( slots.size() - 1u );
+      while ( slots[slot] != 0u )
+      {
+        slot = ( slot + 1u ) & ( slots.size() - 1u );
+      }
+      slots[slot] = index + 1u;
+    }
+    _slots.swap( slots );
+  }
+
+private:
+  std::vector<uint64_t> _words;     ///< the normal function of each entry, or its index in _wide
+  std::vector<uint8_t>  _num_vars;  ///< the number of variables of each entry
+  std::vector<uint32_t> _slots;     ///< the open addressing table, entry index + 1, 0 for an empty slot
+  uint32_t              _num_small{0};
+
+  std::vector<kitty::dynamic_truth_table> _wide;
+  std::unordered_map<kitty::dynamic_truth_table, uint32_t, kitty::hash<kitty::dynamic_truth_table>> _wide_indexes;
+};
+
+iFPGA_NAMESPACE_HEADER_END
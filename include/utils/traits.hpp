@@ -564,6 +564,21 @@ template<class Ntk>
 inline constexpr bool has_substitute_nodes_v = has_substitute_nodes<Ntk>::value;
 #pragma endregion
 
+#pragma region has_compact
+template<class Ntk, class = void>
+struct has_compact : std::false_type
+{
+};
+
+template<class Ntk>
+struct has_compact<Ntk, std::void_t<decltype( std::declval<Ntk>().compact() )>> : std::true_type
+{
+};
+
+template<class Ntk>
+inline constexpr bool has_compact_v = has_compact<Ntk>::value;
+#pragma endregion
+
 #pragma region has_replace_in_node
 template<class Ntk, class = void>
 struct has_replace_in_node : std::false_type
@@ -1150,6 +1165,21 @@ template<class Ntk>
 inline constexpr bool has_node_function_v = has_node_function<Ntk>::value;
 #pragma endregion
 
+#pragma region has_node_function_word
+template<class Ntk, class = void>
+struct has_node_function_word : std::false_type
+{
+};
+
+template<class Ntk>
+struct has_node_function_word<Ntk, std::void_t<decltype( std::declval<Ntk>().node_function_word( std::declval<node<Ntk>>() ) )>> : std::true_type
+{
+};
+
+template<class Ntk>
+inline constexpr bool has_node_function_word_v = has_node_function_word<Ntk>::value;
+#pragma endregion
+
 #pragma region has_get_node
 template<class Ntk, class = void>
 struct has_get_node : std::false_type
@@ -1600,6 +1630,36 @@ template<class Ntk>
 inline constexpr bool has_foreach_fanout_v = has_foreach_fanout<Ntk>::value;
 #pragma endregion
 
+#pragma region has_has_fanout_index
+template<class Ntk, class = void>
+struct has_has_fanout_index : std::false_type
+{
+};
+
+template<class Ntk>
+struct has_has_fanout_index<Ntk, std::void_t<decltype( std::declval<Ntk>().has_fanout_index() )>> : std::true_type
+{
+};
+
+template<class Ntk>
+inline constexpr bool has_has_fanout_index_v = has_has_fanout_index<Ntk>::value;
+#pragma endregion
+
+#pragma region has_get_equiv_node
+template<class Ntk, class = void>
+struct has_get_equiv_node : std::false_type
+{
+};
+
+template<class Ntk>
+struct has_get_equiv_node<Ntk, std::void_t<decltype( std::declval<Ntk>().get_equiv_node( std::declval<node<Ntk>>() ) )>> : std::true_type
+{
+};
+
+template<class Ntk>
+inline constexpr bool has_get_equiv_node_v = has_get_equiv_node<Ntk>::value;
+#pragma endregion
+
 #pragma region has_compute
 template<class Ntk, typename T, class = void>
 struct has_compute : std::false_type
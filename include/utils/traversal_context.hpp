@@ -0,0 +1,158 @@
+// ***************************************************************************************
+// Copyright (c) 2023-2025 Peng Cheng Laboratory
+// Copyright (c) 2023-2025 Shanghai Anlogic Infotech Co.,Ltd.
+// Copyright (c) 2023-2025 Peking University
+//
+// iMAP-FPGA is licensed under Mulan PSL v2.
+// You can use this software according to the terms and conditions of the Mulan PSL v2.
+// You may obtain a copy of Mulan PSL v2 at:
+// http://license.coscl.org.cn/MulanPSL2
+//
+// THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+// EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+// MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+//
+// See the Mulan PSL v2 for more details.
+// ***************************************************************************************
+
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "ifpga_namespaces.hpp"
+#include "traits.hpp"
+
+iFPGA_NAMESPACE_HEADER_START
+
+/*! \brief The traversal state of one thread over a shared network
+ *
+ * The visited flags, the traversal id and the custom values of the networks
+ * are stored in their nodes, so two threads cannot traverse the same network.
+ * A context keeps its own copy of this state with the same interface
+ * (`visited`, `set_visited`, `trav_id`, `incr_trav_id`, `value`, ...), and the
+ * traversal utilities (`topo_view`, `depth_view`, `ref_deref`, `cleanup`)
+ * accept one instead of writing into the network.
+ *
+ * A context is meant to be allocated once per thread and reused: `reset` only
+ * grows the arrays to the size of the network, and the visited flags do not
+ * need to be cleared between traversals since the traversal id increases.
+ *
+ * Example
+ *
+   \verbatim embed:rst
+
+   .. code-block:: c++
+
+      aig_network const aig = ...;
+      #pragma omp parallel
+      {
+        traversal_context<aig_network> ctx( aig );
+        ctx.init_references( aig );
+        #pragma omp for
+        for ( auto i = 0; i < num_roots; ++i )
+        {
+          auto const mffc = derefed_size( aig, ctx, roots[i] );
+        }
+      }
+   \endverbatim
+ */
+template<class Ntk>
+class traversal_context
+{
+public:
+  using node = typename Ntk::node;
+
+  traversal_context() = default;
+
+  explicit traversal_context( Ntk const& ntk )
+  {
+    reset( ntk );
+  }
+
+  /*! \brief Sizes the context for ntk, the values of the new nodes are 0 */
+  void reset( Ntk const& ntk )
+  {
+    if ( _visited.size() < ntk.size() )
+    {
+      _visited.resize( ntk.size(), 0u );
+      _values.resize( ntk.size(), 0u );
+    }
+  }
+
+  uint32_t visited( node const& n ) const
+  {
+    return _visited[index( n )];
+  }
+
+  void set_visited( node const& n, uint32_t v )
+  {
+    _visited[index( n )] = v;
+  }
+
+  void clear_visited()
+  {
+    std::fill( _visited.begin(), _visited.end(), 0u );
+    _trav_id = 0u;
+  }
+
+  uint32_t trav_id() const
+  {
+    return _trav_id;
+  }
+
+  void incr_trav_id()
+  {
+    ++_trav_id;
+  }
+
+  uint32_t value( node const& n ) const
+  {
+    return _values[index( n )];
+  }
+
+  void set_value( node const& n, uint32_t v )
+  {
+    _values[index( n )] = v;
+  }
+
+  /*! \brief Increments the value of n and returns the previous one, as the networks do */
+  uint32_t incr_value( node const& n )
+  {
+    return _values[index( n )]++;
+  }
+
+  /*! \brief Decrements the value of n and returns the new one, as the networks do */
+  uint32_t decr_value( node const& n )
+  {
+    return --_values[index( n )];
+  }
+
+  void clear_values()
+  {
+    std::fill( _values.begin(), _values.end(), 0u );
+  }
+
+  /*! \brief Sets the value of each node to its fanout size, the reference counts of `ref_deref` */
+  void init_references( Ntk const& ntk )
+  {
+    reset( ntk );
+    ntk.foreach_node( [&]( auto const& n ) {
+      _values[index( n )] = ntk.fanout_size( n );
+    } );
+  }
+
+private:
+  static std::size_t index( node const& n )
+  {
+    return static_cast<std::size_t>( n );
+  }
+
+  std::vector<uint32_t> _visited;
+  std::vector<uint32_t> _values;
+  uint32_t _trav_id{0};
+};
+
+iFPGA_NAMESPACE_HEADER_END
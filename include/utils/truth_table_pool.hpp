@@ -0,0 +1,160 @@
+// ***************************************************************************************
+// Copyright (c) 2023-2025 Peng Cheng Laboratory
+// Copyright (c) 2023-2025 Shanghai Anlogic Infotech Co.,Ltd.
+// Copyright (c) 2023-2025 Peking University
+//
+// iMAP-FPGA is licensed under Mulan PSL v2.
+// You can use this software according to the terms and conditions of the Mulan PSL v2.
+// You may obtain a copy of Mulan PSL v2 at:
+// http://license.coscl.org.cn/MulanPSL2
+//
+// THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+// EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+// MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+//
+// See the Mulan PSL v2 for more details.
+// ***************************************************************************************
+
+#pragma once
+#include "utils/ifpga_namespaces.hpp"
+
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <utility>
+
+#include <kitty/hash.hpp>
+#include <kitty/operations.hpp>
+#include <kitty/operators.hpp>
+#include <parallel_hashmap/phmap.h>
+
+iFPGA_NAMESPACE_HEADER_START
+
+/**
+ * @brief the truth table pool, a truth table cache safe for concurrent inserts
+ *
+ *  Same literals as truth_table_cache: the normal functions (0 on the input pattern 0...0) are
+ *  stored once, literal 2i is the function at index i and 2i + 1 its complement.
+ *  The index of a function is found in a hash map split into 2^ShardBits shards, each behind its
+ *  own mutex, so the threads inserting into different shards do not wait for each other.
+ *  The functions are stored in an arena of segments, the first one of first_segment functions
+ *  and each next one twice as large; a segment never moves, so a literal stays valid and can be
+ *  read while other threads insert.  A literal is only read by the threads that got it from
+ *  insert or after a synchronization with them, e.g. the end of a parallel loop.
+ *  The pool is shared by the cut databases of a flow through a std::shared_ptr, see
+ *  cut_enumeration_params::truth_tables.
+ */
+template<typename TT, uint32_t ShardBits = 4u>
+class truth_table_pool
+{
+public:
+  static constexpr uint32_t first_segment_bits = 10u;
+  static constexpr uint32_t first_segment = 1u << first_segment_bits;
+  static constexpr uint32_t max_segments = 32u - first_segment_bits;
+
+  explicit truth_table_pool( uint32_t capacity = 1000u )
+  {
+    _indexes.reserve( capacity );
+  }
+
+  truth_table_pool( truth_table_pool const& ) = delete;
+  truth_table_pool& operator=( truth_table_pool const& ) = delete;
+
+  ~truth_table_pool()
+  {
+    for ( auto& segment : _segments )
+    {
+      delete[] segment.load( std::memory_order_relaxed );
+    }
+  }
+
+  /**
+   * @brief inserts a truth table and returns its literal, the complemented literal of its
+   *  complement when it is not normal
+   */
+  uint32_t insert( TT tt )
+  {
+    uint32_t is_compl{0};
+    if ( kitty::get_bit( tt, 0 ) )
+    {
+      is_compl = 1;
+      tt = ~tt;
+    }
+
+    uint32_t index{0};
+    _indexes.lazy_emplace_l(
+        tt,
+        [&]( uint32_t const& value ) { index = value; },
+        [&]( auto const& ctor ) {
+          /* under the lock of the shard, no other thread inserts the same function */
+          index = _size.fetch_add( 1u, std::memory_order_relaxed );
+          store( index, tt );
+          ctor( tt, index );
+        } );
+    return 2 * index + is_compl;
+  }
+
+  /**
+   * @brief the truth table of a literal
+   */
+  TT operator[]( uint32_t lit ) const
+  {
+    auto const& entry = normal( lit );
+    return ( lit & 1 ) ? ~entry : entry;
+  }
+
+  /**
+   * @brief the normal truth table of a literal, stored at index lit >> 1
+   */
+  TT const& normal( uint32_t lit ) const
+  {
+    auto const [segment, offset] = locate( lit >> 1 );
+    auto const* data = _segments[segment].load( std::memory_order_acquire );
+    assert( data != nullptr );
+    return data[offset];
+  }
+
+  /**
+   * @brief the number of normal truth tables in the pool
+   */
+  uint32_t size() const { return _size.load( std::memory_order_relaxed ); }
+
+private:
+  /* segment k holds the indexes [ ( 2^k - 1 ) * first_segment, ( 2^( k + 1 ) - 1 ) * first_segment ) */
+  static std::pair<uint32_t, uint32_t> locate( uint32_t index )
+  {
+    auto const segment = 31u - static_cast<uint32_t>( __builtin_clz( ( index >> first_segment_bits ) + 1u ) );
+    return { segment, index - ( ( ( 1u << segment ) - 1u ) << first_segment_bits ) };
+  }
+
+  void store( uint32_t index, TT const& tt )
+  {
+    auto const [segment, offset] = locate( index );
+    assert( segment < max_segments );
+    auto* data = _segments[segment].load( std::memory_order_acquire );
+    if ( data == nullptr )
+    {
+      std::lock_guard<std::mutex> lock( _grow );
+      data = _segments[segment].load( std::memory_order_relaxed );
+      if ( data == nullptr )
+      {
+        data = new TT[std::size_t( first_segment ) << segment];
+        _segments[segment].store( data, std::memory_order_release );
+      }
+    }
+    data[offset] = tt;
+  }
+
+private:
+  phmap::parallel_flat_hash_map<TT, uint32_t, kitty::hash<TT>, std::equal_to<TT>,
+                                std::allocator<std::pair<const TT, uint32_t>>, ShardBits, std::mutex> _indexes;
+  std::array<std::atomic<TT*>, max_segments> _segments{};
+  std::atomic<uint32_t> _size{0u};
+  std::mutex _grow;
+};
+
+iFPGA_NAMESPACE_HEADER_END
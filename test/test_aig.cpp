@@ -254,7 +254,7 @@ TEST_CASE( "substitude nodes with propagation in AIGs (test case 1)", "[aig]" )
 
   CHECK( aig.size() == 10u );
   CHECK( aig.num_gates() == 5u );
-  CHECK( aig._storage->hash.size() == 5u );
+  CHECK( aig._storage->hash_size() == 5u );
   CHECK( aig._storage->nodes[f1.index].children[0u].index == x1.index );
   CHECK( aig._storage->nodes[f1.index].children[1u].index == x2.index );
 
@@ -270,7 +270,7 @@ TEST_CASE( "substitude nodes with propagation in AIGs (test case 1)", "[aig]" )
   // Node of signal f1 is now relabelled
   CHECK( aig.size() == 10u );
   CHECK( aig.num_gates() == 4u );
-  CHECK( aig._storage->hash.size() == 4u );
+  CHECK( aig._storage->hash_size() == 4u );
   CHECK( aig._storage->nodes[f1.index].children[0u].index == x1.index );
   CHECK( aig._storage->nodes[f1.index].children[1u].index == x2.index );
 
@@ -0,0 +1,169 @@
+#define CATCH_CONFIG_MAIN
+#include "catch213/catch.hpp"
+#include "network/aig_network.hpp"
+#include "optimization/rewrite.hpp"
+#include "algorithms/cleanup.hpp"
+#include "algorithms/miter.hpp"
+#include "algorithms/equivalence_checking.hpp"
+
+#include <random>
+
+iFPGA_NAMESPACE_USING_NAMESPACE
+
+aig_network build_random( uint32_t num_pis, uint32_t num_gates, uint32_t seed )
+{
+    aig_network aig;
+    std::mt19937 rnd( seed );
+    std::vector<aig_network::signal> signals;
+    for ( auto i = 0u; i < num_pis; ++i )
+    {
+        signals.push_back( aig.create_pi() );
+    }
+    for ( auto i = 0u; i < num_gates; ++i )
+    {
+        auto pick = [&]() {
+            auto const window = std::min<uint32_t>( signals.size(), 24u );
+            return signals[signals.size() - 1u - rnd() % window] ^ ( rnd() & 1u );
+        };
+        signals.push_back( aig.create_and( pick(), pick() ) );
+    }
+    for ( auto i = 0u; i < 8u; ++i )
+    {
+        aig.create_po( signals[signals.size() - 1u - i] );
+    }
+    return aig;
+}
+
+/// the nodes are numbered constant, CIs, then gates after their fanins, without dead nodes
+void check_compacted( aig_network const& aig )
+{
+    aig.foreach_ci( [&]( auto const& n, auto i ) { REQUIRE( n == i + 1u ); } );
+    for ( aig_network::node n = aig.num_cis() + 1u; n < aig.size(); ++n )
+    {
+        REQUIRE( !aig.is_dead( n ) );
+        REQUIRE( aig.fanout_size( n ) > 0u );
+        aig.foreach_fanin( n, [&]( auto const& f ) { REQUIRE( aig.get_node( f ) < n ); } );
+    }
+    REQUIRE( aig.num_gates() == aig.size() - aig.num_cis() - 1u );
+}
+
+TEST_CASE( "paged vector truncation releases the trailing pages", "[aig-compaction]" )
+{
+    paged_vector<uint64_t, 8u> a;
+    for ( uint64_t i = 0u; i < 1000u; ++i )
+    {
+        a.push_back( i );
+    }
+    paged_vector<uint64_t, 8u> b( a );
+
+    a.truncate( 100u );
+    REQUIRE( a.size() == 100u );
+    REQUIRE( a.capacity() == 128u );
+    REQUIRE( b.size() == 1000u );
+    REQUIRE( b.back() == 999u );
+
+    a.push_back( 7u );
+    REQUIRE( a[100u] == 7u );
+    REQUIRE( std::as_const( b )[100u] == 100u );
+}
+
+TEST_CASE( "compaction drops the dead nodes in place", "[aig-compaction]" )
+{
+    auto aig = build_random( 16u, 800u, 3u );
+    auto const reference = cleanup_dangling( aig );
+
+    std::mt19937 rnd( 4 );
+    for ( auto i = 0u; i < 40u; ++i )
+    {
+        aig_network::node n = aig.num_cis() + 1u + rnd() % ( aig.size() - aig.num_cis() - 1u );
+        if ( aig.is_dead( n ) )
+            continue;
+        /* a new node equivalent to n, numbered after its fanouts */
+        auto const a = aig.get_child0( n );
+        auto const b = aig.get_child1( n );
+        auto const t = aig.create_and( a, aig.create_and( b, aig.create_or( a, b ) ) );
+        if ( aig.get_node( t ) != n )
+        {
+            aig.substitute_node( n, t );
+        }
+    }
+
+    auto const num_gates = aig.num_gates();
+    auto const old_size  = aig.size();
+    std::vector<aig_network::signal> pos;
+    aig.foreach_po( [&]( auto const& f ) { pos.push_back( f ); } );
+
+    auto const old_to_new = aig.compact();
+    REQUIRE( old_to_new.size() == old_size );
+    REQUIRE( aig.size() < old_size );
+    REQUIRE( aig.num_gates() <= num_gates );
+    check_compacted( aig );
+
+    aig.foreach_po( [&]( auto const& f, auto i ) {
+        REQUIRE( aig.get_node( f ) == old_to_new[pos[i].index] );
+        REQUIRE( aig.is_complemented( f ) == aig.is_complemented( pos[i] ) );
+    } );
+
+    /* the strash table is rebuilt on the new indices */
+    aig.foreach_gate( [&]( auto const& n ) {
+        auto const size = aig.size();
+        REQUIRE( aig.create_and( aig.get_child0( n ), aig.get_child1( n ) ) == aig.make_signal( n ) );
+        REQUIRE( aig.size() == size );
+    } );
+
+    auto mit = *miter<aig_network>( reference, aig );
+    auto result = equivalence_checking( mit );
+    REQUIRE( result );
+    REQUIRE( *result );
+
+    /* compacting again changes nothing */
+    auto const again = aig.compact();
+    for ( auto n = 0u; n < again.size(); ++n )
+    {
+        REQUIRE( again[n] == n );
+    }
+}
+
+TEST_CASE( "compaction keeps the fanout index and the snapshots", "[aig-compaction]" )
+{
+    auto aig = build_random( 16u, 600u, 3u );
+    auto const reference = cleanup_dangling( aig );
+    auto const saved = aig.snapshot();
+    auto const saved_gates = saved.num_gates();
+
+    /* the pass returns a compacted copy, aig keeps its indices and its dead nodes */
+    rewrite_params ps;
+    auto const size = aig.size();
+    auto const rewritten = rewrite( aig, ps );
+    check_compacted( rewritten );
+    REQUIRE( aig.size() >= size );
+
+    aig.enable_fanout_index();
+    aig.compact();
+    check_compacted( aig );
+    REQUIRE( aig.num_gates() == rewritten.num_gates() );
+    REQUIRE( aig.has_fanout_index() );
+    aig.foreach_gate( [&]( auto const& n ) {
+        aig.foreach_fanin( n, [&]( auto const& f ) {
+            bool found = false;
+            aig.foreach_fanout( aig.get_node( f ), [&]( auto const& fo ) { found |= fo == n; } );
+            REQUIRE( found );
+        } );
+    } );
+
+    REQUIRE( saved.num_gates() == saved_gates );
+    auto mit = *miter<aig_network>( reference, saved );
+    auto result = equivalence_checking( mit );
+    REQUIRE( result );
+    REQUIRE( *result );
+
+    mit = *miter<aig_network>( reference, aig );
+    result = equivalence_checking( mit );
+    REQUIRE( result );
+    REQUIRE( *result );
+
+    mit = *miter<aig_network>( reference, rewritten );
+    result = equivalence_checking( mit );
+    REQUIRE( result );
+    REQUIRE( *result );
+}
@@ -0,0 +1,201 @@
+#define CATCH_CONFIG_MAIN
+#include "catch213/catch.hpp"
+#include "network/aig_network.hpp"
+#include "network/details/paged_vector.hpp"
+#include "optimization/refactor.hpp"
+#include "algorithms/miter.hpp"
+#include "algorithms/equivalence_checking.hpp"
+#include "algorithms/cleanup.hpp"
+
+#include <omp.h>
+
+iFPGA_NAMESPACE_USING_NAMESPACE
+
+/// independent small array multipliers, large enough to span several node pages
+aig_network build_multipliers( uint32_t num_blocks, uint32_t width )
+{
+    aig_network aig;
+    for ( auto k = 0u; k < num_blocks; ++k )
+    {
+        std::vector<aig_network::signal> a, b;
+        for ( auto i = 0u; i < width; ++i )
+        {
+            a.push_back( aig.create_pi() );
+            b.push_back( aig.create_pi() );
+        }
+
+        std::vector<aig_network::signal> acc( 2u * width, aig.get_constant( false ) );
+        for ( auto i = 0u; i < width; ++i )
+        {
+            auto carry = aig.get_constant( false );
+            for ( auto j = 0u; j < width; ++j )
+            {
+                auto const pp = aig.create_and( a[i], b[j] );
+                auto const sum = aig.create_xor3( acc[i + j], pp, carry );
+                carry = aig.create_maj( acc[i + j], pp, carry );
+                acc[i + j] = sum;
+            }
+            acc[i + width] = carry;
+        }
+        for ( auto const& f : acc )
+        {
+            aig.create_po( f );
+        }
+    }
+    return aig;
+}
+
+TEST_CASE( "paged vector shares pages copy-on-write", "[aig-snapshot]" )
+{
+    paged_vector<uint64_t, 4u> a;
+    for ( uint64_t i = 0u; i < 100u; ++i )
+    {
+        a.push_back( i );
+    }
+
+    auto b = a;
+    REQUIRE( b.size() == 100u );
+    REQUIRE( a.num_shared_pages() == 7u );
+    REQUIRE( b.num_shared_pages() == 7u );
+
+    /* reading does not unshare, writing duplicates one page */
+    REQUIRE( std::as_const( b )[42u] == 42u );
+    REQUIRE( b.num_shared_pages() == 7u );
+    b[42u] = 0u;
+    REQUIRE( b.num_shared_pages() == 6u );
+    REQUIRE( a[42u] == 42u );
+
+    /* the last owner takes the page back without copying */
+    a[42u] = 1u;
+    REQUIRE( a.num_shared_pages() == 6u );
+    REQUIRE( b[42u] == 0u );
+
+    b.push_back( 100u );
+    REQUIRE( a.size() == 100u );
+    REQUIRE( b.back() == 100u );
+}
+
+TEST_CASE( "paged vector grows without relocation", "[aig-snapshot]" )
+{
+    paged_vector<uint64_t, 9u> a;
+    a.push_back( 0u );
+    REQUIRE( a.capacity() == 64u );
+
+    uint64_t const* first = &std::as_const( a )[0u];
+    for ( uint64_t i = 1u; i < 5000u; ++i )
+    {
+        a.push_back( i );
+        /* the first pages double up to 512 elements, then stay at 512 */
+        REQUIRE( a.capacity() >= a.size() );
+        REQUIRE( a.capacity() - a.size() < std::max<uint64_t>( 512u, a.size() ) );
+    }
+    REQUIRE( a.num_pages() == 4u + 9u );
+    REQUIRE( &std::as_const( a )[0u] == first );
+
+    uint64_t sum = 0u;
+    a.foreach_item( [&]( auto& v ) { sum += v; } );
+    REQUIRE( sum == 4999u * 5000u / 2u );
+    for ( uint64_t i = 0u; i < 5000u; ++i )
+    {
+        REQUIRE( a[i] == i );
+    }
+}
+
+TEST_CASE( "concurrent writes unshare each page once", "[aig-snapshot]" )
+{
+    paged_vector<uint64_t, 6u> a;
+    for ( uint64_t i = 0u; i < 4096u; ++i )
+    {
+        a.push_back( i );
+    }
+    auto const b = a;
+
+#pragma omp parallel for num_threads( 4 )
+    for ( int64_t i = 0; i < 4096; ++i )
+    {
+        a[i] += 1u;
+    }
+
+    REQUIRE( a.num_shared_pages() == 0u );
+    for ( uint64_t i = 0u; i < 4096u; ++i )
+    {
+        REQUIRE( a[i] == i + 1u );
+        REQUIRE( b[i] == i );
+    }
+}
+
+TEST_CASE( "aig snapshot keeps the saved version", "[aig-snapshot]" )
+{
+    /* refactor expects every gate to be reachable from the outputs */
+    auto aig = cleanup_dangling( build_multipliers( 48u, 5u ) );
+    auto const num_gates = aig.num_gates();
+    auto saved = aig.snapshot();
+
+    REQUIRE( saved.size() == aig.size() );
+    REQUIRE( saved.num_gates() == num_gates );
+    REQUIRE( saved._storage->nodes.num_shared_pages() == saved._storage->nodes.num_pages() );
+
+    /* optimizing the network in place leaves the snapshot untouched */
+    refactor_params ps;
+    auto opt = refactor( aig, ps );
+    REQUIRE( saved.num_gates() == num_gates );
+
+    auto mit = *miter<aig_network>( saved, opt );
+    auto result = equivalence_checking( mit );
+    REQUIRE( result );
+    REQUIRE( *result );
+
+    /* the snapshot rebuilds its strash table on the first structural change */
+    auto const size = saved.size();
+    auto const a = saved.get_child0( size - 1u );
+    auto const b = saved.get_child1( size - 1u );
+    REQUIRE( saved.create_and( a, b ) == saved.make_signal( size - 1u ) );
+    REQUIRE( saved.size() == size );
+    REQUIRE( saved.num_gates() == num_gates );
+}
+
+TEST_CASE( "aig passes keep the untouched pages shared", "[aig-snapshot]" )
+{
+    /* pairs of inputs and their ands before the multipliers, refactor has no cone to try there */
+    aig_network aig;
+    std::vector<aig_network::signal> pairs;
+    for ( auto i = 0u; i < 32768u; ++i )
+    {
+        pairs.push_back( aig.create_pi() );
+    }
+    auto const multipliers = build_multipliers( 48u, 5u );
+    std::vector<aig_network::signal> inputs;
+    multipliers.foreach_pi( [&]( auto const& ) { inputs.push_back( aig.create_pi() ); } );
+    for ( auto i = 0u; i < pairs.size(); i += 2u )
+    {
+        aig.create_po( aig.create_and( pairs[i], pairs[i + 1u] ) );
+    }
+    for ( auto const& f : cleanup_dangling( multipliers, aig, inputs.begin(), inputs.end() ) )
+    {
+        aig.create_po( f );
+    }
+
+    auto const saved = aig.snapshot();
+    auto const num_pages = aig._storage->nodes.num_pages();
+    REQUIRE( aig._storage->nodes.num_shared_pages() == num_pages );
+
+    /* the traversal state is kept beside the pages */
+    aig.clear_values();
+    aig.clear_visited();
+    aig.incr_trav_id();
+    aig.foreach_node( [&]( auto const& n ) {
+        aig.set_visited( n, aig.trav_id() );
+        aig.set_value( n, aig.fanout_size( n ) );
+        aig.incr_value( n );
+    } );
+    REQUIRE( aig._storage->nodes.num_shared_pages() == num_pages );
+    REQUIRE( saved.visited( saved.size() - 1u ) == 0u );
+    REQUIRE( saved.value( saved.size() - 1u ) == 0u );
+
+    /* a pass only unshares the pages of the multipliers, their inputs and the page shared with the ands */
+    refactor_params ps;
+    auto const num_gates = aig.num_gates();
+    auto const opt = refactor( aig, ps );
+    REQUIRE( opt.num_gates() < num_gates );
+    REQUIRE( aig._storage->nodes.num_shared_pages() >= num_pages - 4u );
+}
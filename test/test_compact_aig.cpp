@@ -0,0 +1,81 @@
+#define CATCH_CONFIG_MAIN
+#include "catch213/catch.hpp"
+#include "network/aig_network.hpp"
+#include "algorithms/aig_with_choice.hpp"
+#include "optimization/refactor.hpp"
+#include "algorithms/miter.hpp"
+#include "algorithms/equivalence_checking.hpp"
+
+iFPGA_NAMESPACE_USING_NAMESPACE
+
+template<typename Ntk>
+Ntk build_sample()
+{
+    Ntk aig;
+    auto a = aig.create_pi();
+    auto b = aig.create_pi();
+    auto c = aig.create_pi();
+    auto d = aig.create_pi();
+
+    auto or1 = aig.create_or(aig.create_and(a, b), aig.create_and(a, c));
+    auto or2 = aig.create_or(aig.create_and(b, d), aig.create_and(c, d));
+    aig.create_po(aig.create_or(or1, or2));
+    aig.create_po(!aig.create_xor(a, d));
+    return aig;
+}
+
+TEST_CASE( "compact AIG storage layout", "[compact-aig]" )
+{
+    REQUIRE( sizeof(compact_aig_storage::node_type) < sizeof(aig_storage::node_type) );
+    /* two 32-bit literals and the 32-bit state */
+    REQUIRE( sizeof(compact_aig_storage::node_type) == 12u );
+
+    auto aig = build_sample<aig_network>();
+    auto caig = build_sample<compact_aig_network>();
+
+    SECTION("same structure as the default layout")
+    {
+        REQUIRE( caig.size() == aig.size() );
+        REQUIRE( caig.num_gates() == aig.num_gates() );
+        aig.foreach_gate( [&]( auto const& n ) {
+            REQUIRE( caig.get_child0(n).data == aig.get_child0(n).data );
+            REQUIRE( caig.get_child1(n).data == aig.get_child1(n).data );
+            REQUIRE( caig.phase(n) == aig.phase(n) );
+            REQUIRE( caig.fanout_size(n) == aig.fanout_size(n) );
+        } );
+        aig.foreach_po( [&]( auto const&, auto i ) {
+            REQUIRE( caig.po_at(i).data == aig.po_at(i).data );
+        } );
+    }
+
+    SECTION("structural hashing")
+    {
+        auto a = caig.make_signal( caig.pi_at(0) );
+        auto b = caig.make_signal( caig.pi_at(1) );
+        auto const size = caig.size();
+        REQUIRE( caig.find_and( b, a ) );
+        REQUIRE( caig.create_and( b, a ) == caig.create_and( a, b ) );
+        REQUIRE( caig.size() == size );
+    }
+
+    SECTION("optimization on the compact layout")
+    {
+        refactor_params param;
+        auto opt = iFPGA_NAMESPACE::refactor(caig, param);
+        REQUIRE( opt.num_gates() <= caig.num_gates() );
+
+        auto mit = *miter<aig_network, compact_aig_network, compact_aig_network>(build_sample<compact_aig_network>(), opt);
+        auto result = equivalence_checking(mit);
+        REQUIRE(result);
+        REQUIRE(*result);
+    }
+
+    SECTION("choice nodes on the compact layout")
+    {
+        compact_aig_with_choice choice(caig);
+        caig.foreach_gate( [&]( auto const& n ) {
+            REQUIRE( choice.get_equiv_node(n) == compact_aig_with_choice::AIG_NULL );
+            REQUIRE( choice.get_repr(n) == n );
+        } );
+    }
+}
@@ -1,33 +1,78 @@
-#include "cut/cut_set.hpp"
-#include <vector>
-#include <algorithm>
-#include <assert.h>
-
-iFPGA_NAMESPACE_USING_NAMESPACE
-
-int main()
-{
-    using cut_type = cut<10>;
-
-    cut_type c1, c2, c3, c4, c5;
-    c1.set_leaves( std::vector<uint32_t>{3, 6} );
-    c2.set_leaves( std::vector<uint32_t>{1, 2, 3} );
-    c3.set_leaves( std::vector<uint32_t>{1, 2, 3, 8} );
-    c4.set_leaves( std::vector<uint32_t>{3, 4, 5} );
-    c5.set_leaves( std::vector<uint32_t>{7, 8} );
-
-    cut_set<cut_type, 25> set;
-
-    assert( !set.is_dominated( c1 ) );
-    set.insert( c1 );
-    assert( set.size() == 1 );
-
-    assert( !set.is_dominated( c2 ) );
-    set.insert( c2 );
-    assert( set.size() == 2 );
-
-    assert( set.is_dominated( c3 ) );
-    assert( set.size() == 2 );
-
-    return 0;
+#include "cut/cut_set.hpp"
+#include <vector>
+#include <algorithm>
+#include <assert.h>
+
+iFPGA_NAMESPACE_USING_NAMESPACE
+
+int main()
+{
+    using cut_type = cut<10>;
+
+    cut_type c1, c2, c3, c4, c5;
+    c1.set_leaves( std::vector<uint32_t>{3, 6} );
+    c2.set_leaves( std::vector<uint32_t>{1, 2, 3} );
+    c3.set_leaves( std::vector<uint32_t>{1, 2, 3, 8} );
+    c4.set_leaves( std::vector<uint32_t>{3, 4, 5} );
+    c5.set_leaves( std::vector<uint32_t>{7, 8} );
+
+    cut_set<cut_type, 25> set;
+
+    assert( !set.is_dominated( c1 ) );
+    set.insert( c1 );
+    assert( set.size() == 1 );
+
+    assert( !set.is_dominated( c2 ) );
+    set.insert( c2 );
+    assert( set.size() == 2 );
+
+    assert( set.is_dominated( c3 ) );
+    assert( set.size() == 2 );
+
+    // the cuts stay sorted by size, a dominating cut removes the dominated ones
+    set.insert( c4 );
+    set.insert( c5 );
+    assert( set.size() == 4 );
+    assert( set[0].size() == 2 && set[1].size() == 2 && set[2].size() == 3 && set[3].size() == 3 );
+
+    cut_type c6;
+    c6.set_leaves( std::vector<uint32_t>{3} );
+    set.insert( c6 );
+    assert( set.size() == 2 );
+    assert( set.best().size() == 1 && set[1].size() == 2 && *set[1].begin() == 7 );
+
+    // the removed slots are reused by the next insertions
+    set.remove( 0 );
+    assert( set.size() == 1 && set.best().size() == 2 );
+    set.insert( c1 );
+    set.insert( c2 );
+    assert( set.size() == 3 );
+    set.update_best( 2 );
+    assert( set.best().size() == 3 && set[1].size() == 2 && set[2].size() == 2 );
+
+    // a full set only keeps the better cuts
+    cut_set<cut_type, 3> small;
+    small.insert( c2 );
+    small.insert( c4 );
+    small.insert( c5 );
+    small.insert( c3 );
+    assert( small.size() == 3 && small[2].size() == 3 );
+    small.insert( c1 );
+    assert( small.size() == 3 && small[0].size() == 2 && small[1].size() == 2 && small[2].size() == 3 );
+
+    uint32_t num_cuts = 0u;
+    for ( auto const* c : small )
+    {
+      num_cuts += c->size() > 0u;
+    }
+    assert( num_cuts == 3u );
+
+    // the cuts whose union with a cut may fit, { 7, 8 } would give 7 leaves
+    cut_type c7;
+    c7.set_leaves( std::vector<uint32_t>{1, 2, 3, 4, 5} );
+    assert( *small[1].begin() == 7 );
+    assert( small.mergeable( c7, 6u ) == 5u );
+    assert( small.mergeable( c7, 7u ) == 7u );
+
+    return 0;
 }
\ No newline at end of file
@@ -0,0 +1,126 @@
+#define CATCH_CONFIG_MAIN
+#include "catch213/catch.hpp"
+#include "network/aig_network.hpp"
+#include "views/depth_view.hpp"
+
+#include <random>
+
+iFPGA_NAMESPACE_USING_NAMESPACE
+
+aig_network build_random( uint32_t num_pis, uint32_t num_gates, uint32_t seed )
+{
+    aig_network aig;
+    std::mt19937 rnd( seed );
+    std::vector<aig_network::signal> signals;
+    for ( auto i = 0u; i < num_pis; ++i )
+    {
+        signals.push_back( aig.create_pi() );
+    }
+    for ( auto i = 0u; i < num_gates; ++i )
+    {
+        auto pick = [&]() {
+            auto const window = std::min<uint32_t>( signals.size(), 24u );
+            return signals[signals.size() - 1u - rnd() % window] ^ ( rnd() & 1u );
+        };
+        signals.push_back( aig.create_and( pick(), pick() ) );
+    }
+    for ( auto i = 0u; i < 8u; ++i )
+    {
+        aig.create_po( signals[signals.size() - 1u - 3u * i] ^ ( i & 1u ) );
+    }
+    return aig;
+}
+
+/// the incrementally maintained levels match the ones of a fresh view, which only levels the CO cones
+template<class View>
+void check_levels( View& view, aig_network const& aig, depth_view_params const& ps )
+{
+    View fresh( aig, {}, ps );
+    REQUIRE( view.depth() == fresh.depth() );
+    aig.foreach_node( [&]( auto const& n ) {
+        if ( aig.is_dead( n ) )
+            return;
+        REQUIRE( view.required( n ) == fresh.required( n ) );
+        if ( fresh.required( n ) != View::UNCONSTRAINED )
+        {
+            REQUIRE( view.level( n ) == fresh.level( n ) );
+        }
+    } );
+}
+
+TEST_CASE( "depth view required levels", "[depth-view]" )
+{
+    aig_network aig;
+    auto const a = aig.create_pi();
+    auto const b = aig.create_pi();
+    auto const c = aig.create_pi();
+    auto const f1 = aig.create_and( a, b );
+    auto const f2 = aig.create_and( f1, c );
+    auto const f3 = aig.create_and( a, c );
+    aig.create_po( f2 );
+    aig.create_po( f3 );
+
+    depth_view view( aig );
+    REQUIRE( view.depth() == 2u );
+    REQUIRE( view.required( aig.get_node( f2 ) ) == 2u );
+    REQUIRE( view.required( aig.get_node( f1 ) ) == 1u );
+    REQUIRE( view.required( aig.get_node( f3 ) ) == 2u );
+    REQUIRE( view.required( aig.get_node( a ) ) == 0u );
+    REQUIRE( view.required( aig.get_node( c ) ) == 1u );
+
+    /* a node outside of the CO cones is not constrained */
+    auto const f4 = view.create_and( b, c );
+    REQUIRE( view.level( aig.get_node( f4 ) ) == 1u );
+    REQUIRE( view.required( aig.get_node( f4 ) ) == depth_view<aig_network>::UNCONSTRAINED );
+
+    view.create_po( f4 );
+    REQUIRE( view.required( aig.get_node( f4 ) ) == 2u );
+    REQUIRE( view.required( aig.get_node( b ) ) == 0u );
+}
+
+TEST_CASE( "depth view follows the substitutions", "[depth-view]" )
+{
+    for ( auto const count_complements : {false, true} )
+    {
+        auto aig = build_random( 16u, 600u, 7u );
+        depth_view_params ps;
+        ps.count_complements = count_complements;
+        aig.enable_fanout_index();
+        depth_view view( aig, {}, ps );
+
+        std::mt19937 rnd( 11 );
+        for ( auto i = 0u; i < 60u; ++i )
+        {
+            aig_network::node n = aig.num_cis() + 1u + rnd() % ( aig.size() - aig.num_cis() - 1u );
+            if ( aig.is_dead( n ) )
+                continue;
+            /* an equivalent but deeper node, or one of its fanins: only the structure matters here */
+            auto const x = aig.get_child0( n );
+            auto const y = aig.get_child1( n );
+            auto const t = ( i & 1u ) ? aig.create_and( x, aig.create_and( y, aig.create_or( x, y ) ) ) : y;
+            if ( aig.get_node( t ) != n )
+            {
+                aig.substitute_node( n, t );
+            }
+            if ( i % 10u == 9u )
+            {
+                check_levels( view, aig, ps );
+            }
+        }
+        check_levels( view, aig, ps );
+    }
+}
+
+TEST_CASE( "depth view releases its handlers", "[depth-view]" )
+{
+    auto aig = build_random( 8u, 100u, 5u );
+    aig.enable_fanout_index();
+    auto const num_handlers = aig.events().on_modified.size();
+    {
+        depth_view view( aig );
+        depth_view copy( view );
+        REQUIRE( aig.events().on_modified.size() > num_handlers );
+    }
+    REQUIRE( aig.events().on_modified.size() == num_handlers );
+    aig.substitute_node( aig.get_node( aig.po_at( 0 ) ), aig.get_constant( false ) );
+}
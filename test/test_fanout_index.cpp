@@ -0,0 +1,131 @@
+#define CATCH_CONFIG_MAIN
+#include "catch213/catch.hpp"
+#include "network/aig_network.hpp"
+#include "optimization/rewrite.hpp"
+#include "optimization/refactor.hpp"
+#include "algorithms/miter.hpp"
+#include "algorithms/equivalence_checking.hpp"
+
+#include <random>
+#include <set>
+
+iFPGA_NAMESPACE_USING_NAMESPACE
+
+aig_network build_random( uint32_t num_pis, uint32_t num_gates, uint32_t seed )
+{
+    aig_network aig;
+    std::mt19937 rnd( seed );
+    std::vector<aig_network::signal> signals;
+    for ( auto i = 0u; i < num_pis; ++i )
+    {
+        signals.push_back( aig.create_pi() );
+    }
+    for ( auto i = 0u; i < num_gates; ++i )
+    {
+        /* prefer recent signals to get deep and reconvergent logic */
+        auto pick = [&]() {
+            auto const window = std::min<uint32_t>( signals.size(), 24u );
+            return signals[signals.size() - 1u - rnd() % window] ^ ( rnd() & 1u );
+        };
+        signals.push_back( aig.create_and( pick(), pick() ) );
+    }
+    for ( auto i = 0u; i < 8u; ++i )
+    {
+        aig.create_po( signals[signals.size() - 1u - i] );
+    }
+    return aig;
+}
+
+/// the fanout index must list exactly the live gates using each node
+void check_fanouts( aig_network const& aig )
+{
+    std::vector<std::multiset<aig_network::node>> expected( aig.size() );
+    aig.foreach_gate( [&]( auto const& n ) {
+        aig.foreach_fanin( n, [&]( auto const& f ) { expected[aig.get_node( f )].insert( n ); } );
+    } );
+    for ( auto n = 0u; n < aig.size(); ++n )
+    {
+        std::multiset<aig_network::node> indexed;
+        aig.foreach_fanout( n, [&]( auto const& fo ) { indexed.insert( fo ); } );
+        REQUIRE( indexed == expected[n] );
+    }
+}
+
+TEST_CASE( "fanout index follows the network edits", "[fanout-index]" )
+{
+    auto aig = build_random( 16u, 600u, 1u );
+    aig.enable_fanout_index();
+    check_fanouts( aig );
+
+    std::mt19937 rnd( 2 );
+    for ( auto round = 0u; round < 200u; ++round )
+    {
+        aig_network::node n = 17u + rnd() % ( aig.size() - 17u );
+        if ( aig.is_dead( n ) )
+            continue;
+
+        switch ( rnd() % 3u )
+        {
+        case 0u: /* new logic on top of n */
+            aig.create_and( aig.make_signal( n ), aig.make_signal( 1u + rnd() % 16u ) );
+            break;
+        case 1u: /* substitute n by one of its fanins */
+            aig.substitute_node( n, aig.get_child0( n ) );
+            break;
+        default: /* rewire a fanin without structural hashing */
+            aig.set_child1( n, aig.make_signal( 1u + rnd() % 16u ) );
+            break;
+        }
+        check_fanouts( aig );
+    }
+}
+
+TEST_CASE( "fanout index compaction", "[fanout-index]" )
+{
+    fanout_index<uint32_t> index;
+    index.build( 4u, []( auto&& fn ) { fn( 1u, 3u ); fn( 2u, 3u ); } );
+
+    for ( uint32_t fo = 10u; fo < 5000u; ++fo )
+    {
+        index.insert( fo % 3u, fo );
+    }
+    REQUIRE( index.overflow_size() < 5000u );
+    REQUIRE( index.fanout_count( 0u ) + index.fanout_count( 1u ) + index.fanout_count( 2u ) == 4992u );
+
+    REQUIRE( index.erase( 1u, 3u ) );
+    REQUIRE( !index.erase( 1u, 3u ) );
+    index.compact();
+    REQUIRE( index.overflow_size() == 0u );
+
+    uint32_t count = 0u;
+    index.foreach_fanout( 1u, [&]( auto fo ) { REQUIRE( fo % 3u == 1u ); ++count; } );
+    REQUIRE( count == index.fanout_count( 1u ) );
+}
+
+TEST_CASE( "rewrite and refactor with the fanout index", "[fanout-index]" )
+{
+    auto aig = build_random( 16u, 600u, 3u );
+
+    /* the passes leave the fanout index as they found it */
+    rewrite_params rw_ps;
+    auto rw = rewrite( aig, rw_ps );
+    REQUIRE( !aig.has_fanout_index() );
+
+    rw.enable_fanout_index();
+    refactor_params rf_ps;
+    auto rf = refactor( rw, rf_ps );
+    REQUIRE( rf.num_gates() <= aig.num_gates() );
+    REQUIRE( rw.has_fanout_index() );
+    rw.foreach_gate( [&]( auto const& n ) {
+        rw.foreach_fanin( n, [&]( auto const& f ) {
+            bool found = false;
+            rw.foreach_fanout( rw.get_node( f ), [&]( auto const& fo ) { found |= fo == n; } );
+            REQUIRE( found );
+        } );
+    } );
+
+    auto mit = *miter<aig_network>( build_random( 16u, 600u, 3u ), rf );
+    auto result = equivalence_checking( mit );
+    REQUIRE( result );
+    REQUIRE( *result );
+}
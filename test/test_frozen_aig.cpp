@@ -0,0 +1,129 @@
+#define CATCH_CONFIG_MAIN
+#include "catch213/catch.hpp"
+#include "network/aig_network.hpp"
+#include "network/frozen_aig.hpp"
+#include "algorithms/aig_with_choice.hpp"
+#include "views/depth_view.hpp"
+
+#include <random>
+
+iFPGA_NAMESPACE_USING_NAMESPACE
+
+aig_network build_random( uint32_t num_pis, uint32_t num_gates, uint32_t seed )
+{
+    aig_network aig;
+    std::mt19937 rnd( seed );
+    std::vector<aig_network::signal> signals;
+    for ( auto i = 0u; i < num_pis; ++i )
+    {
+        signals.push_back( aig.create_pi() );
+    }
+    for ( auto i = 0u; i < num_gates; ++i )
+    {
+        auto pick = [&]() {
+            auto const window = std::min<uint32_t>( signals.size(), 24u );
+            return signals[signals.size() - 1u - rnd() % window] ^ ( rnd() & 1u );
+        };
+        signals.push_back( aig.create_and( pick(), pick() ) );
+    }
+    for ( auto i = 0u; i < 8u; ++i )
+    {
+        aig.create_po( signals[signals.size() - 1u - 7u * i] ^ ( i & 1u ) );
+    }
+    return aig;
+}
+
+/// one 64-bit simulation word per node, the same code for both networks
+template<typename Ntk>
+std::vector<uint64_t> simulate( Ntk const& ntk, std::vector<uint64_t> const& pis )
+{
+    std::vector<uint64_t> words( ntk.size(), 0u );
+    ntk.foreach_ci( [&]( auto const& n, auto i ) { words[n] = pis[i]; } );
+    ntk.foreach_gate( [&]( auto const& n ) {
+        uint64_t w = ~uint64_t( 0 );
+        ntk.foreach_fanin( n, [&]( auto const& f ) {
+            w &= ntk.is_complemented( f ) ? ~words[ntk.get_node( f )] : words[ntk.get_node( f )];
+        } );
+        words[n] = w;
+    } );
+    std::vector<uint64_t> pos;
+    ntk.foreach_po( [&]( auto const& f ) {
+        pos.push_back( ntk.is_complemented( f ) ? ~words[ntk.get_node( f )] : words[ntk.get_node( f )] );
+    } );
+    return pos;
+}
+
+TEST_CASE( "frozen aig keeps the structure", "[frozen-aig]" )
+{
+    auto aig = build_random( 16u, 1000u, 5u );
+
+    /* a dead node and a gate created after its fanout, out of topological order */
+    auto const a = aig.make_signal( 20u );
+    auto const b = aig.make_signal( 21u );
+    auto const late = aig.create_and( a, !b );
+    aig.substitute_node( aig.get_node( aig.po_at( 0u ) ), late );
+    aig.enable_fanout_index();
+
+    frozen_aig const frozen( aig );
+    REQUIRE( frozen.num_cis() == aig.num_cis() );
+    REQUIRE( frozen.num_pos() == aig.num_pos() );
+    REQUIRE( frozen.num_gates() == aig.num_gates() );
+
+    depth_view const depth( aig );
+    REQUIRE( frozen.depth() == depth.depth() );
+
+    frozen.foreach_gate( [&]( auto const& n ) {
+        auto const src = frozen.source_node( n );
+        REQUIRE( !aig.is_dead( src ) );
+        frozen.foreach_fanin( n, [&]( auto const& f, auto i ) {
+            auto const g = i == 0 ? aig.get_child0( src ) : aig.get_child1( src );
+            REQUIRE( frozen.get_node( f ) < n );
+            REQUIRE( frozen.source_node( frozen.get_node( f ) ) == aig.get_node( g ) );
+            REQUIRE( frozen.is_complemented( f ) == aig.is_complemented( g ) );
+        } );
+        REQUIRE( frozen.fanout_size( n ) == aig.fanout_size( src ) );
+
+        std::vector<uint64_t> fos, src_fos;
+        frozen.foreach_fanout( n, [&]( auto const& fo ) { fos.push_back( frozen.source_node( fo ) ); } );
+        aig.foreach_fanout( src, [&]( auto const& fo ) { src_fos.push_back( fo ); } );
+        std::sort( fos.begin(), fos.end() );
+        std::sort( src_fos.begin(), src_fos.end() );
+        REQUIRE( fos == src_fos );
+    } );
+
+    std::mt19937_64 rnd( 1 );
+    std::vector<uint64_t> pis( aig.num_pis() );
+    for ( auto& w : pis )
+    {
+        w = rnd();
+    }
+    REQUIRE( simulate( frozen, pis ) == simulate( aig, pis ) );
+}
+
+TEST_CASE( "frozen aig keeps the choices", "[frozen-aig]" )
+{
+    auto const aig = build_random( 8u, 200u, 6u );
+    aig_with_choice choices( aig );
+    uint32_t num_choices = 0u;
+    for ( aig_network::node n = aig.num_cis() + 40u; n < aig.size(); n += 13u )
+    {
+        num_choices += choices.set_choice( n, n - 30u );
+    }
+    REQUIRE( num_choices > 0u );
+
+    frozen_aig<aig_with_choice> const frozen( choices );
+    REQUIRE( frozen.has_choices() );
+    uint32_t count = 0u;
+    frozen.foreach_node( [&]( auto const& n ) {
+        auto const e = frozen.get_equiv_node( n );
+        auto const src_e = choices.get_equiv_node( frozen.source_node( n ) );
+        if ( e == frozen.AIG_NULL )
+        {
+            REQUIRE( src_e == choices.AIG_NULL );
+            return;
+        }
+        ++count;
+        REQUIRE( frozen.source_node( e ) == src_e );
+    } );
+    REQUIRE( count == num_choices );
+}
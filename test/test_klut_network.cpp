@@ -1,6 +1,13 @@
 #define CATCH_CONFIG_MAIN
 #include "catch213/catch.hpp"
 #include "network/klut_network.hpp"
+#include "io/detail/write_verilog.hpp"
+#include "io/detail/writer_lut.hpp"
+
+#include <kitty/constructors.hpp>
+#include <kitty/print.hpp>
+#include <random>
+#include <sstream>
 
 #include <iostream>
 #include <assert.h>
@@ -59,3 +66,122 @@ TEST_CASE( "klut_network basic function test", "[klut_network]" )
   } );
 
 }
+
+TEST_CASE( "klut_network inline and pooled fanins", "[klut_network]" )
+{
+  klut_network klut;
+  std::vector<klut_network::signal> pis;
+  for ( auto i = 0u; i < 8u; ++i )
+  {
+    pis.push_back( klut.create_pi() );
+    CHECK( klut.ci_index( klut.get_node( pis.back() ) ) == i );
+    CHECK( klut.fanin_size( klut.get_node( pis.back() ) ) == 0u );
+  }
+
+  kitty::dynamic_truth_table and6( 6u ), and8( 8u );
+  kitty::create_from_hex_string( and6, "8000000000000000" );
+  kitty::create_from_hex_string( and8, "8000000000000000000000000000000000000000000000000000000000000000" );
+
+  auto const inline6 = klut.create_node( std::vector<klut_network::signal>( pis.begin(), pis.begin() + 6 ), and6 );
+  auto const pooled8 = klut.create_node( pis, and8 );
+  auto const pooled8b = klut.create_node( std::vector<klut_network::signal>( pis.rbegin(), pis.rend() ), and8 );
+  klut.create_po( pooled8 );
+  klut.create_po( pooled8b );
+
+  CHECK( klut.fanin_size( inline6 ) == 6u );
+  CHECK( klut.fanin_size( pooled8 ) == 8u );
+  std::vector<klut_network::signal> fanins;
+  klut.foreach_fanin( pooled8b, [&]( auto const& f, auto i ) {
+    CHECK( i == fanins.size() );
+    fanins.push_back( f );
+  } );
+  CHECK( fanins == std::vector<klut_network::signal>( pis.rbegin(), pis.rend() ) );
+  CHECK( klut.fanout_size( pis[0] ) == 3u );
+  CHECK( klut.fanout_size( pis[7] ) == 2u );
+
+  /* the substitution reaches the pooled fanins */
+  klut.substitute_node( pis[7], inline6 );
+  fanins.clear();
+  klut.foreach_fanin( pooled8, [&]( auto const& f ) { fanins.push_back( f ); } );
+  CHECK( fanins.back() == inline6 );
+  fanins.clear();
+  klut.foreach_fanin( pooled8b, [&]( auto const& f ) { fanins.push_back( f ); } );
+  CHECK( fanins.front() == inline6 );
+  CHECK( klut.fanout_size( inline6 ) == 2u );
+
+  /* a node created while iterating does not invalidate the iteration */
+  std::vector<klut_network::signal> copies;
+  klut.foreach_fanin( pooled8, [&]( auto const& f ) { copies.push_back( klut.create_not( f ) ); } );
+  CHECK( copies.size() == 8u );
+  std::vector<bool> const ones( 8u, true );
+  CHECK( klut.compute( pooled8, ones.begin(), ones.end() ) );
+}
+
+TEST_CASE( "lut function cache", "[klut_network]" )
+{
+  lut_function_cache cache;
+  std::mt19937_64 rnd( 3 );
+  std::vector<kitty::dynamic_truth_table> functions;
+  std::vector<uint32_t> literals;
+  for ( auto i = 0u; i < 4000u; ++i )
+  {
+    kitty::dynamic_truth_table tt( i % 9u );
+    kitty::create_random( tt, rnd() );
+    if ( i % 3u == 1u )
+    {
+      tt = ~functions[rnd() % functions.size()];
+    }
+    functions.push_back( tt );
+    literals.push_back( cache.insert( tt ) );
+  }
+  for ( auto i = 0u; i < functions.size(); ++i )
+  {
+    CHECK( cache[literals[i]] == functions[i] );
+    CHECK( cache[literals[i] ^ 1u] == ~functions[i] );
+    CHECK( cache.insert( functions[i] ) == literals[i] );
+    CHECK( cache.insert( ~functions[i] ) == ( literals[i] ^ 1u ) );
+    CHECK( cache.is_word( literals[i] ) == ( functions[i].num_vars() <= 6u ) );
+    if ( functions[i].num_vars() <= 6u )
+    {
+      CHECK( cache.word( literals[i] ) == *functions[i].cbegin() );
+      CHECK( cache.insert_word( *functions[i].cbegin(), functions[i].num_vars() ) == literals[i] );
+    }
+  }
+
+  /* the reserved literals of klut_network */
+  klut_network klut;
+  auto const a = klut.create_pi();
+  auto const b = klut.create_pi();
+  CHECK( klut.node_function( klut.create_and( a, b ) )._bits[0] == 0x8u );
+  CHECK( klut.node_function( klut.create_le( a, b ) )._bits[0] == 0xdu );
+  CHECK( klut.node_function( klut.create_not( a ) )._bits[0] == 0x1u );
+  CHECK( klut.node_function_word( klut.create_xor( a, b ) ) == 0x6u );
+}
+
+TEST_CASE( "lut writer on word functions", "[klut_network]" )
+{
+  klut_network klut;
+  std::vector<klut_network::signal> signals;
+  for ( auto i = 0u; i < 8u; ++i )
+  {
+    signals.push_back( klut.create_pi() );
+  }
+  std::mt19937_64 rnd( 4 );
+  for ( auto num_vars = 1u; num_vars <= 8u; ++num_vars )
+  {
+    kitty::dynamic_truth_table tt( num_vars );
+    kitty::create_random( tt, rnd() );
+    std::vector<klut_network::signal> children( signals.end() - num_vars, signals.end() );
+    signals.push_back( klut.create_node( children, tt ) );
+    klut.create_po( signals.back() );
+  }
+
+  std::stringstream ss;
+  write_lut( klut, ss, write_verilog_params{} );
+  auto const verilog = ss.str();
+  klut.foreach_gate( [&]( auto const& n ) {
+    auto const tt = klut.node_function( n );
+    auto const init = fmt::format( "{}'h{};", 1 << tt.num_vars(), kitty::to_hex( tt ) );
+    CHECK( verilog.find( init ) != std::string::npos );
+  } );
+}
@@ -0,0 +1,95 @@
+#define CATCH_CONFIG_MAIN
+#include "catch213/catch.hpp"
+#include "network/aig_network.hpp"
+#include "network/klut_network.hpp"
+
+iFPGA_NAMESPACE_USING_NAMESPACE
+
+/// records the events it receives
+struct recorder
+{
+    std::vector<uint64_t> added, modified, deleted;
+    uint64_t num_previous{0};
+
+    template<typename Ntk>
+    void listen( Ntk const& ntk )
+    {
+        ntk.events().on_add.push_back( [this]( auto const& n ) { added.push_back( n ); } );
+        ntk.events().on_modified.push_back( [this]( auto const& n, auto const& previous ) {
+            modified.push_back( n );
+            num_previous += previous.size();
+        } );
+        ntk.events().on_delete.push_back( [this]( auto const& n ) { deleted.push_back( n ); } );
+    }
+};
+
+TEST_CASE( "the handlers receive the aig events", "[network-events]" )
+{
+    aig_network aig;
+    recorder rec;
+    rec.listen( aig );
+    auto const a = aig.create_pi();
+    auto const b = aig.create_pi();
+    auto const c = aig.create_pi();
+    auto const f1 = aig.create_and( a, b );
+    auto const f2 = aig.create_and( f1, c );
+    aig.create_po( f2 );
+    REQUIRE( rec.added == std::vector<uint64_t>{ aig.get_node( f1 ), aig.get_node( f2 ) } );
+
+    /* the copies share the handlers */
+    auto copy = aig;
+    auto const f3 = copy.create_and( a, c );
+    REQUIRE( rec.added.size() == 3u );
+
+    aig.substitute_node( aig.get_node( f1 ), f3 );
+    REQUIRE( rec.modified == std::vector<uint64_t>{ aig.get_node( f2 ) } );
+    REQUIRE( rec.num_previous == 2u );
+    REQUIRE( rec.deleted == std::vector<uint64_t>{ aig.get_node( f1 ) } );
+}
+
+TEST_CASE( "the fanout index does not go through the events", "[network-events]" )
+{
+    aig_network aig;
+    auto const a = aig.create_pi();
+    auto const b = aig.create_pi();
+    auto const c = aig.create_pi();
+    auto const f1 = aig.create_and( a, b );
+    aig.enable_fanout_index();
+    REQUIRE( aig.events().on_add.empty() );
+    REQUIRE( aig.events().on_modified.empty() );
+    REQUIRE( aig.events().on_delete.empty() );
+    auto const f2 = aig.create_and( f1, c );
+    auto const f3 = aig.create_and( !f1, b );
+    aig.create_po( f2 );
+    aig.create_po( f3 );
+
+    std::vector<uint64_t> fanouts;
+    aig.foreach_fanout( aig.get_node( f1 ), [&]( auto const& fo ) { fanouts.push_back( fo ); } );
+    std::sort( fanouts.begin(), fanouts.end() );
+    REQUIRE( fanouts == std::vector<uint64_t>{ aig.get_node( f2 ), aig.get_node( f3 ) } );
+
+    /* substitute_nodes drops the substitutions of deleted nodes without a delete handler */
+    aig.substitute_nodes( { { aig.get_node( f1 ), a } } );
+    REQUIRE( aig.events().on_delete.empty() );
+    fanouts.clear();
+    aig.foreach_fanout( aig.get_node( a ), [&]( auto const& fo ) { fanouts.push_back( fo ); } );
+    REQUIRE( fanouts.size() == 2u );
+    REQUIRE( aig.is_dead( aig.get_node( f1 ) ) );
+}
+
+TEST_CASE( "the handlers receive the klut events", "[network-events]" )
+{
+    klut_network klut;
+    recorder rec;
+    rec.listen( klut );
+    auto const a = klut.create_pi();
+    auto const b = klut.create_pi();
+    auto const f = klut.create_and( a, b );
+    auto const g = klut.create_or( f, b );
+    klut.create_po( g );
+    REQUIRE( rec.added == std::vector<uint64_t>{ f, g } );
+
+    klut.substitute_node( f, a );
+    REQUIRE( rec.modified == std::vector<uint64_t>{ g } );
+    REQUIRE( rec.num_previous == 2u );
+}
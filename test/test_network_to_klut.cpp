@@ -5,12 +5,21 @@
 #include "algorithms/klut_mapping.hpp"
 #include "algorithms/network_to_klut.hpp"
 #include "algorithms/choice_computation.hpp"
+#include "algorithms/choice_miter.hpp"
 
 #include "views/mapping_view.hpp"
 #include "kitty/constructors.hpp"
 #include "kitty/dynamic_truth_table.hpp"
 
+#include <algorithm>
 #include <assert.h>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
 
 iFPGA_NAMESPACE_USING_NAMESPACE
 
@@ -49,3 +58,603 @@ TEST_CASE( "klut_network basic function test", "[klut_network]" )
     assert( klut.node_function( n ) == tt_xor );
   } );
 }
+
+/// a random network, alt builds the xors from two ands and an or
+aig_network build_random( uint32_t num_pis, uint32_t num_gates, uint32_t seed, bool alt = false )
+{
+  aig_network aig;
+  std::mt19937 rnd( seed );
+  std::vector<aig_network::signal> signals;
+  for ( auto i = 0u; i < num_pis; ++i )
+  {
+    signals.push_back( aig.create_pi() );
+  }
+  for ( auto i = 0u; i < num_gates; ++i )
+  {
+    auto const a = signals[rnd() % signals.size()] ^ ( rnd() & 1u );
+    auto const b = signals[rnd() % signals.size()] ^ ( rnd() & 1u );
+    switch ( rnd() % 3u )
+    {
+    case 0u: signals.push_back( aig.create_and( a, b ) ); break;
+    case 1u: signals.push_back( aig.create_or( a, b ) ); break;
+    default: signals.push_back( alt ? aig.create_or( aig.create_and( a, !b ), aig.create_and( !a, b ) ) : aig.create_xor( a, b ) ); break;
+    }
+  }
+  for ( auto i = 0u; i < 16u; ++i )
+  {
+    aig.create_po( signals[signals.size() - 1u - 7u * i] ^ ( i & 1u ) );
+  }
+  return aig;
+}
+
+/// a choice network merged from build_random and its alternative xors of the same seed
+aig_with_choice make_choice_aig( uint32_t seed )
+{
+  choice_miter cm;
+  cm.add_aig( std::make_shared<aig_network>( build_random( 10u, 300u, seed ) ) );
+  cm.add_aig( std::make_shared<aig_network>( build_random( 10u, 300u, seed, true ) ) );
+  choice_params params;
+  choice_computation cc( params, cm.merge_aigs_to_miter() );
+  return cc.compute_choice();
+}
+
+/// both mappings have the same cells, on the same leaves and with the same functions
+template<class Mapped>
+void require_same_mapping( Mapped const& a, Mapped const& b )
+{
+  REQUIRE( a.num_cells() == b.num_cells() );
+  a.foreach_node( [&]( auto n ) {
+    REQUIRE( a.is_cell_root( n ) == b.is_cell_root( n ) );
+    if ( !a.is_cell_root( n ) )
+      return;
+    std::vector<uint32_t> leaves_a, leaves_b;
+    a.foreach_cell_fanin( n, [&]( auto l ) { leaves_a.push_back( l ); } );
+    b.foreach_cell_fanin( n, [&]( auto l ) { leaves_b.push_back( l ); } );
+    REQUIRE( leaves_a == leaves_b );
+    REQUIRE( a.cell_function( n ) == b.cell_function( n ) );
+  } );
+}
+
+TEST_CASE( "level-parallel cut enumeration", "[cut_enumeration]" )
+{
+  auto const aig = build_random( 10u, 400u, 7u );
+
+  cut_enumeration_params ps;
+  ps.cut_size = 6u;
+  ps.cut_limit = 8u;
+  auto const serial = cut_enumeration<aig_network, true>( aig, ps );
+  ps.num_threads = 4u;
+  auto const parallel = cut_enumeration<aig_network, true>( aig, ps );
+
+  REQUIRE( serial.total_cuts() == parallel.total_cuts() );
+  aig.foreach_node( [&]( auto n ) {
+    auto const index = aig.node_to_index( n );
+    auto const& s = serial.cuts( index );
+    auto const& p = parallel.cuts( index );
+    REQUIRE( s.size() == p.size() );
+    for ( auto i = 0u; i < s.size(); ++i )
+    {
+      REQUIRE( std::vector<uint32_t>( s[i].begin(), s[i].end() ) == std::vector<uint32_t>( p[i].begin(), p[i].end() ) );
+      REQUIRE( serial.truth_table( s[i] ) == parallel.truth_table( p[i] ) );
+    }
+  } );
+}
+
+/// random simulation words of the nodes
+std::vector<std::vector<uint64_t>> simulate( aig_network const& aig, uint32_t num_words )
+{
+  std::mt19937_64 rnd( 1u );
+  std::vector<std::vector<uint64_t>> sims( aig.size(), std::vector<uint64_t>( num_words, 0u ) );
+  aig.foreach_node( [&]( auto n ) {
+    if ( aig.is_constant( n ) )
+      return;
+    for ( auto w = 0u; w < num_words; ++w )
+    {
+      if ( aig.is_pi( n ) )
+      {
+        sims[n][w] = rnd();
+        continue;
+      }
+      auto const c0 = aig.get_child0( n );
+      auto const c1 = aig.get_child1( n );
+      auto const v0 = sims[aig.get_node( c0 )][w] ^ ( aig.is_complemented( c0 ) ? ~0ull : 0ull );
+      auto const v1 = sims[aig.get_node( c1 )][w] ^ ( aig.is_complemented( c1 ) ? ~0ull : 0ull );
+      sims[n][w] = v0 & v1;
+    }
+  } );
+  return sims;
+}
+
+/// whether the truth table over the leaves gives the simulated values of the node
+bool agrees( std::vector<std::vector<uint64_t>> const& sims, uint32_t index, std::vector<uint32_t> const& leaves, kitty::dynamic_truth_table const& tt )
+{
+  for ( auto w = 0u; w < sims[index].size(); ++w )
+  {
+    for ( auto b = 0u; b < 64u; ++b )
+    {
+      uint64_t minterm = 0u;
+      for ( auto i = 0u; i < leaves.size(); ++i )
+      {
+        minterm |= ( ( sims[leaves[i]][w] >> b ) & 1u ) << i;
+      }
+      if ( kitty::get_bit( tt, minterm ) != ( ( sims[index][w] >> b ) & 1u ) )
+        return false;
+    }
+  }
+  return true;
+}
+
+TEST_CASE( "cut functions", "[cut_enumeration]" )
+{
+  auto aig = build_random( 16u, 300u, 11u );
+  /* a chain of ands has the cuts of 7 leaves */
+  auto chain = aig.create_pi();
+  for ( auto i = 0u; i < 10u; ++i )
+  {
+    chain = aig.create_and( chain ^ ( i & 1u ), aig.create_pi() ^ ( ( i >> 1u ) & 1u ) );
+  }
+  aig.create_po( chain );
+
+  for ( auto minimize : { false, true } )
+  {
+    cut_enumeration_params ps;
+    ps.cut_size = 7u;
+    ps.cut_limit = 11u;
+    ps.minimize_truth_table = minimize;
+    auto const cuts = cut_enumeration<aig_network, true>( aig, ps );
+    auto const sims = simulate( aig, 4u );
+
+    uint32_t wide = 0u;
+    aig.foreach_gate( [&]( auto n ) {
+      auto const index = aig.node_to_index( n );
+      for ( auto const& cut : cuts.cuts( index ) )
+      {
+        std::vector<uint32_t> leaves( cut->begin(), cut->end() );
+        if ( leaves.size() == 1u && leaves[0] == index )
+          continue;
+        wide += leaves.size() > max_word_cut_size ? 1u : 0u;
+        REQUIRE( agrees( sims, index, leaves, cuts.truth_table( *cut ) ) );
+      }
+    } );
+    REQUIRE( wide > 0u );
+  }
+}
+
+TEST_CASE( "wavefront delay rounds", "[klut_mapping]" )
+{
+  aig_with_choice choice_aig = make_choice_aig( 3u );
+  uint32_t num_reprs = 0u;
+  choice_aig.foreach_gate( [&]( auto n ) { num_reprs += choice_aig.is_repr( n ) ? 1u : 0u; } );
+  REQUIRE( num_reprs > 0u );
+
+  /* a deep network, each gate reads the one before, the wavefront runs across its narrow levels */
+  aig_network chain;
+  {
+    std::mt19937 rnd( 11u );
+    std::vector<aig_network::signal> signals;
+    for ( auto i = 0u; i < 10u; ++i )
+    {
+      signals.push_back( chain.create_pi() );
+    }
+    for ( auto i = 0u; i < 600u; ++i )
+    {
+      auto const a = signals.back() ^ ( rnd() & 1u );
+      auto const b = signals[rnd() % signals.size()] ^ ( rnd() & 1u );
+      signals.push_back( rnd() % 2u ? chain.create_and( a, b ) : chain.create_xor( a, b ) );
+    }
+    for ( auto i = 0u; i < 8u; ++i )
+    {
+      chain.create_po( signals[signals.size() - 1u - 31u * i] );
+    }
+  }
+  aig_with_choice chain_aig( chain );
+
+  auto map = [&]( uint32_t num_threads, bool reclaim, mapping_view<aig_with_choice, true>& mapped ) {
+    klut_mapping_params ps;
+    ps.cut_enumeration_ps.num_threads = num_threads;
+    ps.bReclaimCuts = reclaim;
+    return klut_mapping<mapping_view<aig_with_choice, true>, true>( mapped, ps );
+  };
+  for ( auto* ntk : { &choice_aig, &chain_aig } )
+  {
+    for ( auto reclaim : { true, false } )
+    {
+      mapping_view<aig_with_choice, true> serial{ *ntk };
+      mapping_view<aig_with_choice, true> parallel{ *ntk };
+      auto const qor_serial = map( 1u, reclaim, serial );
+      auto const qor_parallel = map( 4u, reclaim, parallel );
+
+      REQUIRE( qor_serial.delay == qor_parallel.delay );
+      REQUIRE( qor_serial.area == qor_parallel.area );
+      require_same_mapping( serial, parallel );
+    }
+  }
+}
+
+TEST_CASE( "reclaimed cut sets", "[klut_mapping]" )
+{
+  aig_with_choice choice_aig = make_choice_aig( 5u );
+
+  auto map = [&]( bool reclaim, uint32_t num_threads, mapping_view<aig_with_choice, true>& mapped, klut_mapping_stats& st ) {
+    klut_mapping_params ps;
+    ps.bReclaimCuts = reclaim;
+    ps.cut_enumeration_ps.num_threads = num_threads;
+    return klut_mapping<mapping_view<aig_with_choice, true>, true>( mapped, ps, &st );
+  };
+
+  for ( auto num_threads : { 1u, 4u } )
+  {
+    mapping_view<aig_with_choice, true> kept{ choice_aig };
+    mapping_view<aig_with_choice, true> reclaimed{ choice_aig };
+    klut_mapping_stats st_kept, st_reclaimed;
+    auto const qor_kept = map( false, num_threads, kept, st_kept );
+    auto const qor_reclaimed = map( true, num_threads, reclaimed, st_reclaimed );
+
+    REQUIRE( qor_kept.delay == qor_reclaimed.delay );
+    REQUIRE( qor_kept.area == qor_reclaimed.area );
+    REQUIRE( st_reclaimed.peak_cut_sets < st_kept.peak_cut_sets / 2u );
+    require_same_mapping( kept, reclaimed );
+  }
+}
+
+TEST_CASE( "bounded cut enumeration", "[klut_mapping]" )
+{
+  aig_with_choice choice_aig = make_choice_aig( 7u );
+
+  auto map = [&]( bool bounded, bool area, bool minimize, mapping_view<aig_with_choice, true>& mapped, klut_mapping_stats& st ) {
+    klut_mapping_params ps;
+    ps.bBoundedCuts = bounded;
+    ps.bArea = area;
+    ps.cut_enumeration_ps.minimize_truth_table = minimize;
+    return klut_mapping<mapping_view<aig_with_choice, true>, true>( mapped, ps, &st );
+  };
+
+  for ( auto area : { false, true } )
+  {
+    mapping_view<aig_with_choice, true> full{ choice_aig };
+    mapping_view<aig_with_choice, true> bounded{ choice_aig };
+    klut_mapping_stats st_full, st_bounded;
+    auto const qor_full = map( false, area, false, full, st_full );
+    auto const qor_bounded = map( true, area, false, bounded, st_bounded );
+
+    REQUIRE( qor_full.delay == qor_bounded.delay );
+    REQUIRE( qor_full.area == qor_bounded.area );
+    REQUIRE( st_bounded.merges < st_full.merges );
+    require_same_mapping( full, bounded );
+  }
+
+  /* the minimized cuts may have fewer leaves than their fanin cuts, no pair is skipped */
+  mapping_view<aig_with_choice, true> full{ choice_aig };
+  mapping_view<aig_with_choice, true> bounded{ choice_aig };
+  klut_mapping_stats st_full, st_bounded;
+  map( false, false, true, full, st_full );
+  map( true, false, true, bounded, st_bounded );
+  REQUIRE( st_bounded.merges == st_full.merges );
+  require_same_mapping( full, bounded );
+}
+
+TEST_CASE( "reused cuts", "[klut_mapping]" )
+{
+  auto map = [&]( bool reuse, uint32_t num_threads, mapping_view<aig_with_choice, true>& mapped, klut_mapping_stats& st ) {
+    klut_mapping_params ps;
+    ps.bReuseCuts = reuse;
+    ps.cut_enumeration_ps.num_threads = num_threads;
+    return klut_mapping<mapping_view<aig_with_choice, true>, true>( mapped, ps, &st );
+  };
+
+  /* the replayed merges give the cut sets of the full ones, the mapping is the same */
+  aig_with_choice plain_aig( build_random( 12u, 600u, 17u ) );
+  std::vector<aig_with_choice> ntks{ plain_aig, make_choice_aig( 3u ), make_choice_aig( 5u ), make_choice_aig( 7u ) };
+  for ( auto const& ntk : ntks )
+  {
+    for ( auto num_threads : { 1u, 4u } )
+    {
+      mapping_view<aig_with_choice, true> merged{ ntk };
+      mapping_view<aig_with_choice, true> reused{ ntk };
+      klut_mapping_stats st_merged, st_reused;
+      auto const qor_merged = map( false, num_threads, merged, st_merged );
+      auto const qor_reused = map( true, num_threads, reused, st_reused );
+
+      REQUIRE( st_merged.reuses == 0u );
+      REQUIRE( st_reused.reuses > 0u );
+      REQUIRE( st_reused.merges < st_merged.merges );
+      REQUIRE( qor_merged.delay == qor_reused.delay );
+      REQUIRE( qor_merged.area == qor_reused.area );
+      require_same_mapping( merged, reused );
+    }
+  }
+
+  /* the minimized functions are not replayed */
+  mapping_view<aig_with_choice, true> minimized{ ntks[1] };
+  klut_mapping_params ps;
+  ps.bReuseCuts = true;
+  ps.cut_enumeration_ps.minimize_truth_table = true;
+  klut_mapping_stats st;
+  klut_mapping<mapping_view<aig_with_choice, true>, true>( minimized, ps, &st );
+  REQUIRE( st.reuses == 0u );
+}
+
+TEST_CASE( "cut configurations", "[cut_enumeration]" )
+{
+  auto const fits = []( uint32_t cut_size, uint32_t cut_limit, uint32_t max_leaves, uint32_t max_cuts ) {
+    bool match = false;
+    bool const found = dispatch_cut_config( cut_size, cut_limit, [&]( auto config ) {
+      match = decltype( config )::max_leaves == max_leaves && decltype( config )::max_cuts == max_cuts;
+    } );
+    return found && match;
+  };
+  REQUIRE( fits( 4u, 10u, 4u, 12u ) );
+  REQUIRE( fits( 6u, 10u, 6u, 12u ) );
+  REQUIRE( fits( 6u, 20u, 6u, 22u ) );
+  REQUIRE( fits( 8u, 16u, 8u, 22u ) );
+  REQUIRE( !dispatch_cut_config( 9u, 10u, []( auto ) {} ) );
+  REQUIRE( !dispatch_cut_config( 6u, 22u, []( auto ) {} ) );
+
+  /* the largest configuration holds 20 cuts of 8 leaves per node */
+  auto aig = build_random( 12u, 400u, 11u );
+  auto chain = aig.create_pi();
+  for ( auto i = 0u; i < 12u; ++i )
+  {
+    chain = aig.create_and( chain ^ ( i & 1u ), aig.create_pi() ^ ( ( i >> 1u ) & 1u ) );
+  }
+  aig.create_po( chain );
+  cut_enumeration_params ps;
+  ps.cut_size = 8u;
+  ps.cut_limit = 20u;
+  auto const cuts = cut_enumeration<aig_network, true, empty_cut_data, cut_config<8u, 22u>>( aig, ps );
+  auto const sims = simulate( aig, 4u );
+  uint32_t wide = 0u, most = 0u;
+  aig.foreach_gate( [&]( auto n ) {
+    auto const index = aig.node_to_index( n );
+    most = std::max( most, cuts.cuts( index ).size() );
+    for ( auto const& cut : cuts.cuts( index ) )
+    {
+      std::vector<uint32_t> leaves( cut->begin(), cut->end() );
+      wide += leaves.size() == 8u ? 1u : 0u;
+      REQUIRE( agrees( sims, index, leaves, cuts.truth_table( *cut ) ) );
+    }
+  } );
+  REQUIRE( wide > 0u );
+  REQUIRE( most == 20u );
+
+  /* a tighter configuration maps as the default one */
+  aig_with_choice choice_aig( build_random( 10u, 300u, 13u ) );
+  klut_mapping_params mps;
+  mps.cut_enumeration_ps.cut_size = 4u;
+  mapping_view<aig_with_choice, true> wide_cuts{ choice_aig };
+  mapping_view<aig_with_choice, true> narrow_cuts{ choice_aig };
+  auto const qor_wide = klut_mapping<mapping_view<aig_with_choice, true>, true>( wide_cuts, mps );
+  auto const qor_narrow = klut_mapping<mapping_view<aig_with_choice, true>, true, general_cut_data, cut_config<4u, 12u>>( narrow_cuts, mps );
+  REQUIRE( qor_wide.delay == qor_narrow.delay );
+  REQUIRE( qor_wide.area == qor_narrow.area );
+  require_same_mapping( wide_cuts, narrow_cuts );
+}
+
+TEST_CASE( "concurrent mappings", "[klut_mapping]" )
+{
+  constexpr uint32_t num_mappings = 4u;
+  std::vector<aig_with_choice> choice_aigs;
+  for ( auto i = 0u; i < num_mappings; ++i )
+  {
+    choice_aigs.push_back( make_choice_aig( 20u + i ) );
+  }
+
+  /* the rounds of the mappings sort their cuts by different modes at the same time */
+  auto map = [&]( uint32_t i, mapping_view<aig_with_choice, true>& mapped ) {
+    klut_mapping_params ps;
+    ps.cut_enumeration_ps.cut_size = 4u + i % 3u;
+    return klut_mapping<mapping_view<aig_with_choice, true>, true>( mapped, ps );
+  };
+
+  std::vector<mapping_view<aig_with_choice, true>> serial, concurrent;
+  std::vector<mapping_qor_storage> qor_serial( num_mappings ), qor_concurrent( num_mappings );
+  for ( auto i = 0u; i < num_mappings; ++i )
+  {
+    serial.emplace_back( choice_aigs[i] );
+    concurrent.emplace_back( choice_aigs[i] );
+  }
+  for ( auto i = 0u; i < num_mappings; ++i )
+  {
+    qor_serial[i] = map( i, serial[i] );
+  }
+  std::vector<std::thread> threads;
+  for ( auto i = 0u; i < num_mappings; ++i )
+  {
+    threads.emplace_back( [&, i]() { qor_concurrent[i] = map( i, concurrent[i] ); } );
+  }
+  for ( auto& t : threads )
+  {
+    t.join();
+  }
+
+  for ( auto i = 0u; i < num_mappings; ++i )
+  {
+    REQUIRE( qor_serial[i].delay == qor_concurrent[i].delay );
+    REQUIRE( qor_serial[i].area == qor_concurrent[i].area );
+    require_same_mapping( serial[i], concurrent[i] );
+  }
+}
+
+TEST_CASE( "truth table pool", "[cut_enumeration]" )
+{
+  constexpr uint32_t num_threads = 4u;
+  std::vector<kitty::dynamic_truth_table> tts;
+  std::mt19937 rnd( 9u );
+  for ( auto i = 0u; i < 3000u; ++i )
+  {
+    kitty::dynamic_truth_table tt( 7u );
+    for ( auto& word : tt )
+    {
+      word = ( uint64_t( rnd() ) << 32u ) | rnd();
+    }
+    tts.push_back( tt );
+    tts.push_back( ~tt );
+  }
+
+  /* the threads insert the same functions in different orders */
+  truth_table_pool<kitty::dynamic_truth_table> pool;
+  std::vector<std::vector<uint32_t>> lits( num_threads, std::vector<uint32_t>( tts.size() ) );
+  std::vector<std::thread> threads;
+  for ( auto t = 0u; t < num_threads; ++t )
+  {
+    threads.emplace_back( [&, t]() {
+      std::vector<uint32_t> order( tts.size() );
+      std::iota( order.begin(), order.end(), 0u );
+      std::shuffle( order.begin(), order.end(), std::mt19937( t ) );
+      for ( auto j : order )
+      {
+        lits[t][j] = pool.insert( tts[j] );
+      }
+    } );
+  }
+  for ( auto& t : threads )
+  {
+    t.join();
+  }
+
+  REQUIRE( pool.size() == tts.size() / 2u );
+  for ( auto i = 0u; i < tts.size(); ++i )
+  {
+    REQUIRE( pool[lits[0][i]] == tts[i] );
+    REQUIRE( ( lits[0][i] & 1u ) == ( kitty::get_bit( tts[i], 0 ) ? 1u : 0u ) );
+    for ( auto t = 1u; t < num_threads; ++t )
+    {
+      REQUIRE( lits[t][i] == lits[0][i] );
+    }
+  }
+
+  /* the mappings on one pool give the functions of the mappings on their own pools */
+  aig_with_choice choice_aig = make_choice_aig( 31u );
+
+  auto map = [&]( mapping_view<aig_with_choice, true>& mapped, std::shared_ptr<truth_table_pool<kitty::dynamic_truth_table>> truth_tables ) {
+    klut_mapping_params ps;
+    ps.cut_enumeration_ps.cut_size = 7u;
+    ps.cut_enumeration_ps.num_threads = 2u;
+    ps.cut_enumeration_ps.truth_tables = truth_tables;
+    return klut_mapping<mapping_view<aig_with_choice, true>, true>( mapped, ps );
+  };
+  mapping_view<aig_with_choice, true> own{ choice_aig };
+  auto const qor_own = map( own, nullptr );
+
+  auto shared = std::make_shared<truth_table_pool<kitty::dynamic_truth_table>>();
+  std::vector<mapping_view<aig_with_choice, true>> mapped( num_threads, mapping_view<aig_with_choice, true>{ choice_aig } );
+  std::vector<mapping_qor_storage> qors( num_threads );
+  threads.clear();
+  for ( auto t = 0u; t < num_threads; ++t )
+  {
+    threads.emplace_back( [&, t]() { qors[t] = map( mapped[t], shared ); } );
+  }
+  for ( auto& t : threads )
+  {
+    t.join();
+  }
+
+  REQUIRE( shared->size() > 2u );
+  for ( auto t = 0u; t < num_threads; ++t )
+  {
+    REQUIRE( qors[t].delay == qor_own.delay );
+    REQUIRE( qors[t].area == qor_own.area );
+    require_same_mapping( own, mapped[t] );
+  }
+}
+
+TEST_CASE( "lazy cut functions", "[klut_mapping]" )
+{
+  aig_with_choice choice_aig = make_choice_aig( 31u );
+  aig_with_choice plain_aig( build_random( 12u, 400u, 32u ) );
+
+  /* the cones of the best cuts give the functions the enumeration carries, but where a leaf lies in the cone of
+     another one the enumeration may reach the root around it: both agree on the values the network can take */
+  auto const same_cells = []( aig_with_choice const& ntk, auto config, uint32_t cut_size, uint32_t num_threads ) {
+    auto const sims = simulate( ntk, 4u );
+    using mapped_t = mapping_view<aig_with_choice, true>;
+    using config_t = decltype( config );
+    klut_mapping_params ps;
+    ps.cut_enumeration_ps.cut_size = cut_size;
+    ps.cut_enumeration_ps.num_threads = num_threads;
+    mapped_t stored{ ntk };
+    mapped_t lazy{ ntk };
+    auto const qor_stored = klut_mapping<mapped_t, true, general_cut_data, config_t>( stored, ps );
+    auto const qor_lazy = klut_mapping<mapped_t, false, general_cut_data, config_t>( lazy, ps );
+    REQUIRE( qor_stored.delay == qor_lazy.delay );
+    REQUIRE( qor_stored.area == qor_lazy.area );
+    REQUIRE( stored.num_cells() == lazy.num_cells() );
+    ntk.foreach_node( [&]( auto n ) {
+      REQUIRE( stored.is_cell_root( n ) == lazy.is_cell_root( n ) );
+      if ( !stored.is_cell_root( n ) )
+        return;
+      std::vector<uint32_t> leaves_stored, leaves_lazy;
+      stored.foreach_cell_fanin( n, [&]( auto l ) { leaves_stored.push_back( l ); } );
+      lazy.foreach_cell_fanin( n, [&]( auto l ) { leaves_lazy.push_back( l ); } );
+      REQUIRE( leaves_stored == leaves_lazy );
+      REQUIRE( ( stored.cell_function( n ) == lazy.cell_function( n ) || agrees( sims, n, leaves_lazy, lazy.cell_function( n ) ) ) );
+    } );
+  };
+  for ( auto* ntk : { &choice_aig, &plain_aig } )
+  {
+    same_cells( *ntk, default_cut_config{}, 6u, 1u );
+    same_cells( *ntk, default_cut_config{}, 6u, 4u );
+    same_cells( *ntk, cut_config<8u, 12u>{}, 8u, 4u );
+  }
+}
+
+TEST_CASE( "mapping schedules", "[klut_mapping]" )
+{
+  std::vector<klut_mapping_round> schedule;
+  REQUIRE( parse_mapping_schedule( "default", schedule ) );
+  REQUIRE( schedule.empty() );
+  REQUIRE( parse_mapping_schedule( "fastest", schedule ) );
+  REQUIRE( schedule.size() == 1u );
+  REQUIRE( parse_mapping_schedule( "delay:delay:p,flow:area,area:delay2", schedule ) );
+  REQUIRE( schedule == std::vector<klut_mapping_round>{ { 0u, ETC_DELAY, true }, { 1u, ETC_AREA, false }, { 2u, ETC_DELAY2, false } } );
+  REQUIRE( !parse_mapping_schedule( "flow:area,delay:delay", schedule ) );
+  REQUIRE( !parse_mapping_schedule( "delay:fast", schedule ) );
+  REQUIRE( !parse_mapping_schedule( "delay:delay:q", schedule ) );
+  REQUIRE( !parse_mapping_schedule( "delay:delay:p:p", schedule ) );
+  REQUIRE( !parse_mapping_schedule( "", schedule ) );
+  REQUIRE( mapping_schedule_to_string( default_mapping_schedule( klut_mapping_params{} ) ) == "delay:delay:p,delay:delay2:p,delay:area:p,flow:area,area:area,area:area" );
+  REQUIRE( parse_mapping_schedule( "delay:area,flow:area,area:delay2", schedule ) );
+  REQUIRE( mapping_schedule_to_string( schedule ) == "delay:area,flow:area,area:delay2" );
+
+  aig_with_choice choice_aig = make_choice_aig( 41u );
+
+  auto map = [&]( klut_mapping_params const& ps, mapping_view<aig_with_choice, true>& mapped, klut_mapping_stats& st ) {
+    return klut_mapping<mapping_view<aig_with_choice, true>, true>( mapped, ps, &st );
+  };
+
+  /* the schedule of the parameters written out maps as the empty one */
+  klut_mapping_params ps;
+  klut_mapping_params explicit_ps;
+  REQUIRE( parse_mapping_schedule( "delay:delay:p,delay:delay2:p,delay:area:p,flow:area,area:area,area:area", explicit_ps.schedule ) );
+  REQUIRE( explicit_ps.schedule == default_mapping_schedule( ps ) );
+  mapping_view<aig_with_choice, true> implicit_rounds{ choice_aig };
+  mapping_view<aig_with_choice, true> explicit_rounds{ choice_aig };
+  klut_mapping_stats st_implicit, st_explicit;
+  auto const qor_implicit = map( ps, implicit_rounds, st_implicit );
+  auto const qor_explicit = map( explicit_ps, explicit_rounds, st_explicit );
+  REQUIRE( qor_implicit.delay == qor_explicit.delay );
+  REQUIRE( qor_implicit.area == qor_explicit.area );
+  REQUIRE( st_implicit.round_times.size() == 6u );
+  require_same_mapping( implicit_rounds, explicit_rounds );
+
+  /* the iterations of the parameters are kept, the presets skip rounds */
+  klut_mapping_params iterations_ps;
+  iterations_ps.bPreprocess = false;
+  iterations_ps.uFlowIters = 2u;
+  iterations_ps.uAreaIters = 1u;
+  mapping_view<aig_with_choice, true> iterations{ choice_aig };
+  klut_mapping_stats st_iterations;
+  map( iterations_ps, iterations, st_iterations );
+  REQUIRE( st_iterations.round_times.size() == 4u );
+
+  for ( auto const& [preset, num_rounds] : std::vector<std::pair<std::string, uint32_t>>{ { "fast", 3u }, { "fastest", 1u } } )
+  {
+    klut_mapping_params preset_ps;
+    REQUIRE( parse_mapping_schedule( preset, preset_ps.schedule ) );
+    mapping_view<aig_with_choice, true> mapped{ choice_aig };
+    klut_mapping_stats st;
+    auto const qor = map( preset_ps, mapped, st );
+    REQUIRE( st.round_times.size() == num_rounds );
+    REQUIRE( qor.area == static_cast<float>( mapped.num_cells() ) );
+  }
+}
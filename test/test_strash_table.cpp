@@ -0,0 +1,85 @@
+#define CATCH_CONFIG_MAIN
+#include "catch213/catch.hpp"
+#include "network/aig_network.hpp"
+#include "network/details/strash_table.hpp"
+
+#include <random>
+#include <unordered_map>
+
+iFPGA_NAMESPACE_USING_NAMESPACE
+
+TEST_CASE( "strash table against a reference map", "[strash-table]" )
+{
+    /* node i has the key keys[i] */
+    std::vector<std::pair<uint64_t, uint64_t>> keys( 1u );
+    std::unordered_map<uint64_t, uint64_t> live;
+    strash_table<uint32_t> table;
+    std::mt19937 rnd( 7 );
+
+    auto fp = [&]( uint64_t i ) { return strash_table<uint32_t>::hash_key( keys[i].first, keys[i].second ); };
+    auto find = [&]( uint64_t i ) {
+        return table.find( fp( i ), [&]( uint32_t other ) { return keys[other] == keys[i]; } );
+    };
+
+    for ( uint32_t round = 0u; round < 200000u; ++round )
+    {
+        if ( live.empty() || rnd() % 4u != 0u )
+        {
+            uint64_t const index = keys.size();
+            keys.emplace_back( index, index * 3u + 1u );
+            table.insert( fp( index ), static_cast<uint32_t>( index ), [&]( uint32_t other ) { return keys[other] == keys[index]; } );
+            live.emplace( index, index );
+        }
+        else
+        {
+            auto it = live.begin();
+            std::advance( it, rnd() % std::min<uint64_t>( live.size(), 16u ) );
+            REQUIRE( table.erase( fp( it->first ), static_cast<uint32_t>( it->first ) ) );
+            REQUIRE( find( it->first ) == 0u );
+            live.erase( it );
+        }
+        REQUIRE( table.size() == live.size() );
+    }
+
+    for ( auto const& [index, _] : live )
+    {
+        REQUIRE( find( index ) == index );
+    }
+}
+
+TEST_CASE( "strash table keeps the latest duplicate in front", "[strash-table]" )
+{
+    strash_table<uint64_t> table;
+    auto const fp = strash_table<uint64_t>::hash_key( 2u, 4u );
+    auto eq = []( uint64_t ) { return true; };
+
+    table.insert( fp, 5u, eq );
+    table.insert( fp, 9u, eq );
+    REQUIRE( table.find( fp, eq ) == 9u );
+    REQUIRE( table.erase( fp, 9u ) );
+    REQUIRE( table.find( fp, eq ) == 5u );
+    REQUIRE_FALSE( table.erase( fp, 9u ) );
+}
+
+TEST_CASE( "aig structural hashing through the strash table", "[strash-table]" )
+{
+    aig_network aig;
+    std::vector<aig_network::signal> sigs;
+    for ( auto i = 0u; i < 64u; ++i )
+        sigs.push_back( aig.create_pi() );
+
+    std::mt19937 rnd( 11 );
+    for ( auto i = 0u; i < 20000u; ++i )
+    {
+        auto a = sigs[rnd() % sigs.size()] ^ ( rnd() & 1u );
+        auto b = sigs[rnd() % sigs.size()] ^ ( rnd() & 1u );
+        auto const f = aig.create_and( a, b );
+        REQUIRE( aig.create_and( b, a ) == f );
+        sigs.push_back( f );
+    }
+    REQUIRE( aig.num_gates() == aig.size() - 65u );
+
+    aig.foreach_gate( [&]( auto const& n ) {
+        REQUIRE( aig.find_and( aig.get_child0( n ), aig.get_child1( n ) ) );
+    } );
+}
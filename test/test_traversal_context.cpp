@@ -0,0 +1,106 @@
+#define CATCH_CONFIG_MAIN
+#include "catch213/catch.hpp"
+#include "network/aig_network.hpp"
+#include "views/topo_view.hpp"
+#include "views/depth_view.hpp"
+#include "views/traversal_view.hpp"
+#include "algorithms/ref_deref.hpp"
+#include "algorithms/cleanup.hpp"
+
+#include <random>
+#include <omp.h>
+
+iFPGA_NAMESPACE_USING_NAMESPACE
+
+aig_network build_random( uint32_t num_pis, uint32_t num_gates, uint32_t seed )
+{
+    aig_network aig;
+    std::mt19937 rnd( seed );
+    std::vector<aig_network::signal> signals;
+    for ( auto i = 0u; i < num_pis; ++i )
+    {
+        signals.push_back( aig.create_pi() );
+    }
+    for ( auto i = 0u; i < num_gates; ++i )
+    {
+        auto pick = [&]() {
+            auto const window = std::min<uint32_t>( signals.size(), 24u );
+            return signals[signals.size() - 1u - rnd() % window] ^ ( rnd() & 1u );
+        };
+        signals.push_back( aig.create_and( pick(), pick() ) );
+    }
+    for ( auto i = 0u; i < 8u; ++i )
+    {
+        aig.create_po( signals[signals.size() - 1u - 5u * i] );
+    }
+    return aig;
+}
+
+TEST_CASE( "traversal view redirects the markers to the context", "[traversal-context]" )
+{
+    auto const aig = build_random( 8u, 200u, 1u );
+    auto const trav_id = aig.trav_id();
+    aig.clear_values();
+
+    traversal_context<aig_network> ctx;
+    traversal_view view( aig, ctx );
+    view.incr_trav_id();
+    view.set_visited( 10u, view.trav_id() );
+    view.set_value( 10u, 7u );
+    REQUIRE( view.incr_value( 10u ) == 7u );
+    REQUIRE( view.decr_value( 10u ) == 7u );
+
+    REQUIRE( ctx.visited( 10u ) == 1u );
+    REQUIRE( ctx.value( 10u ) == 7u );
+    REQUIRE( aig.trav_id() == trav_id );
+    REQUIRE( aig.value( 10u ) == 0u );
+}
+
+TEST_CASE( "concurrent traversals of a shared network", "[traversal-context]" )
+{
+    auto const aig = build_random( 16u, 2000u, 2u );
+
+    /* the sequential references, with the markers of the network */
+    topo_view const topo{ aig };
+    std::vector<aig_network::node> order;
+    topo.foreach_node( [&]( auto const& n ) { order.push_back( n ); } );
+    depth_view const depth{ aig };
+    std::vector<uint32_t> mffcs;
+    aig.clear_values();
+    aig.foreach_node( [&]( auto const& n ) { aig.set_value( n, aig.fanout_size( n ) ); } );
+    aig.foreach_gate( [&]( auto const& n ) { mffcs.push_back( derefed_size( aig, n ) ); } );
+    auto const gates = cleanup_dangling( aig ).num_gates();
+
+    auto const trav_id = aig.trav_id();
+    int const num_threads = 4;
+    std::vector<int> failures( num_threads, 0 );
+
+#pragma omp parallel num_threads( num_threads )
+    {
+        auto& failed = failures[omp_get_thread_num()];
+        traversal_context<aig_network> ctx( aig );
+        for ( auto round = 0; round < 8; ++round )
+        {
+            topo_view const t{ aig, ctx };
+            std::vector<aig_network::node> o;
+            t.foreach_node( [&]( auto const& n ) { o.push_back( n ); } );
+            failed += o != order;
+
+            depth_view const d{ aig, ctx };
+            failed += d.depth() != depth.depth();
+            aig.foreach_node( [&]( auto const& n ) { failed += d.level( n ) != depth.level( n ); } );
+
+            ctx.init_references( aig );
+            auto i = 0u;
+            aig.foreach_gate( [&]( auto const& n ) { failed += derefed_size( aig, ctx, n ) != mffcs[i++]; } );
+
+            failed += cleanup_dangling( aig, ctx ).num_gates() != gates;
+        }
+    }
+
+    for ( auto const f : failures )
+    {
+        REQUIRE( f == 0 );
+    }
+    REQUIRE( aig.trav_id() == trav_id );
+}